@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <string>
 #include <thread>
 
@@ -31,6 +32,10 @@ public:
 
   std::map<llvm::Function *, std::vector<MutationPoint *>> &getMutationPointsMap();
 
+  /// The mutants of the function share a single mutated copy, see CloneMutatedFunctionsTask
+  void addMutantSchema(llvm::Function *function);
+  bool hasMutantSchema(llvm::Function *function) const;
+
 private:
   std::unique_ptr<llvm::LLVMContext> context;
   std::unique_ptr<llvm::Module> module;
@@ -38,6 +43,7 @@ private:
   std::string uniqueIdentifier;
 
   std::map<llvm::Function *, std::vector<MutationPoint *>> mutationPoints;
+  std::set<llvm::Function *> mutantSchemata;
 };
 
 } // namespace mull
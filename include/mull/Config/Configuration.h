@@ -8,6 +8,8 @@
 namespace mull {
 
 extern int MullDefaultTimeoutMilliseconds;
+extern unsigned MullDefaultMutantOutputLimit;
+extern unsigned MullDefaultASTCacheSizeLimit;
 
 class Diagnostics;
 
@@ -21,10 +23,32 @@ struct Configuration {
   bool captureMutantOutput;
   bool includeNotCovered;
   bool junkDetectionDisabled;
+  bool forkServer;
+  /// Mutants are forked from the unmutated program when their function is first called
+  bool splitStream;
+  bool failFast;
+  /// Mutants likely to survive, according to previous reports, run first
+  bool prioritizeSurvivors;
+  /// Mutants the optimizer turns back into the original code, or into another mutant, are not run
+  bool detectEquivalentMutants;
+  /// Mutated code records whether it was reached; replaces coverage when deciding what to run
+  bool reachabilityProbes;
+  /// The unmutated program also computes each mutant's value, mutants whose value never differs
+  /// are reported as survivors without running them
+  bool weakMutation;
+  /// A single mutated copy of each function, in which every mutant runs instead of its original
+  /// instruction when it is active, rather than a copy per mutant
+  bool mutantSchemata;
 
   unsigned timeout;
 
+  /// Bytes of each output stream kept per mutant (beginning and end), 0 keeps everything
+  unsigned mutantOutputLimit;
+  /// If set, the whole output of every mutant is written there
+  std::string mutantOutputDirectory;
+
   IDEDiagnosticsKind diagnostics;
+  TestFrameworkKind testFramework;
 
   std::vector<std::string> mutators;
   std::vector<std::string> ignoreMutators;
@@ -33,11 +57,23 @@ struct Configuration {
 
   std::string compilationDatabasePath;
   std::vector<std::string> compilerFlags;
+  /// If set, junk detection keeps the ASTs it parses there, see ASTCache
+  std::string astCache;
+  /// Megabytes the AST cache may take
+  unsigned astCacheSizeLimit;
+  /// Junk detection starts parsing the files with mutants before the filters run
+  bool astPrefetch;
 
   std::vector<std::string> includePaths;
   std::vector<std::string> excludePaths;
 
+  std::vector<std::string> failFastMarkers;
+
+  /// Directory of results reused across runs, see ResultCache
+  std::string resultCache;
+
   ParallelizationConfig parallelization;
+  SandboxConfig sandbox{};
 
   std::string gitDiffRef;
   std::string gitProjectRoot;
@@ -4,6 +4,8 @@ namespace mull {
 
 enum class IDEDiagnosticsKind { None, Survived, Killed, All };
 
+enum class TestFrameworkKind { None, GoogleTest, Catch2, Doctest };
+
 struct ParallelizationConfig {
   unsigned workers;
   unsigned executionWorkers;
@@ -13,6 +15,20 @@ struct ParallelizationConfig {
   bool exceedsHardware();
 };
 
+/// Resource limits of mutant runs, 0 means unlimited
+struct SandboxConfig {
+  /// Address space, megabytes
+  unsigned memoryLimit = 0;
+  /// CPU time, seconds: a kernel-enforced cap on top of the per-mutant CPU budget
+  unsigned cpuLimit = 0;
+  /// Processes of the user (not just the mutant's own), RLIMIT_NPROC
+  unsigned processLimit = 0;
+  /// Size of files the mutant writes, megabytes
+  unsigned fileSizeLimit = 0;
+  /// Runs each mutant in its own process group, killed as a whole
+  bool processGroup = true;
+};
+
 struct DebugConfig {
   bool printIR = false;
   bool printIRBefore = false;
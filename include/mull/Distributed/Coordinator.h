@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mull/Mutant.h"
+#include "mull/MutationResult.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+class MutantPrioritizer;
+
+/// Serves mutants to mull-runner workers (see Worker) and collects their results, instead of
+/// running the mutants itself. Mutants handed out to a worker that disconnects before reporting
+/// them are handed out again.
+class Coordinator {
+public:
+  Coordinator(Diagnostics &diagnostics, std::string address);
+  /// Returns a result for every mutant, in the order of `mutants`
+  std::vector<std::unique_ptr<MutationResult>> run(std::vector<std::unique_ptr<Mutant>> &mutants);
+  void setResultListener(MutationResultListener listener);
+  /// Mutants likely to survive are handed out first
+  void setPrioritizer(const MutantPrioritizer *prioritizer);
+
+private:
+  Diagnostics &diagnostics;
+  std::string address;
+  MutationResultListener resultListener;
+  const MutantPrioritizer *prioritizer = nullptr;
+};
+
+} // namespace mull
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+
+/// Messages exchanged by mull-runner's coordinator and workers. Each message is a header line,
+/// optionally followed by raw payloads whose lengths are given in the header:
+///
+///   worker -> coordinator
+///     GET <count>                    asks for up to <count> mutants
+///     RESULT <id length> <status> <exit status> <running time> <cpu time> <stdout length>
+///            <stderr length>         followed by the identifier, stdout and stderr
+///     ALIVE                          still running the mutants handed out, see WorkerHeartbeat
+///   coordinator -> worker
+///     WORK <count> <id length>...    followed by the identifiers
+///     WAIT                           nothing to hand out right now, ask again later
+///     DONE                           every mutant has a result
+namespace protocol {
+
+enum class MessageKind { Request, Work, Wait, Done, Result, Alive };
+
+/// How often a busy worker says it is alive, a worker silent for WorkerSilenceLimit is
+/// considered gone
+const std::chrono::seconds WorkerHeartbeat(5);
+const std::chrono::seconds WorkerSilenceLimit(60);
+
+struct Message {
+  MessageKind kind;
+  size_t count = 0;
+  std::vector<std::string> identifiers;
+  ExecutionResult result;
+};
+
+std::string encodeRequest(size_t count);
+std::string encodeWork(const std::vector<std::string> &identifiers);
+std::string encodeWait();
+std::string encodeDone();
+std::string encodeAlive();
+std::string encodeResult(const std::string &identifier, const ExecutionResult &result);
+
+/// Takes the first message off the buffer. Returns std::nullopt if the message is not complete
+/// yet, or if it is malformed: `malformed` tells the two apart.
+std::optional<Message> decodeMessage(std::string &buffer, bool &malformed);
+
+} // namespace protocol
+
+/// A stream socket to the other side, addressed as unix:<path> or <host>:<port>
+class Connection {
+public:
+  explicit Connection(int fd);
+  Connection(Connection &&other) noexcept;
+  Connection &operator=(Connection &&other) noexcept;
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+  ~Connection();
+
+  static std::optional<Connection> connect(Diagnostics &diagnostics, const std::string &address);
+
+  int getFD() const;
+  bool send(const std::string &data);
+  /// Reads whatever is available, returns false once the other side is gone
+  bool receiveAvailable();
+  /// Blocks until a whole message arrives, std::nullopt if the other side is gone
+  std::optional<protocol::Message> receive();
+  /// Next message already received, see receiveAvailable
+  std::optional<protocol::Message> next(bool &malformed);
+
+private:
+  int fd;
+  std::string buffer;
+};
+
+/// Returns the listening socket, -1 on error
+int listenOn(Diagnostics &diagnostics, const std::string &address);
+
+} // namespace mull
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mull/Mutant.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+class MutantRunner;
+
+/// Pulls mutants from a Coordinator, runs them locally and sends the results back until the
+/// coordinator has no more work
+class Worker {
+public:
+  Worker(Diagnostics &diagnostics, std::string address, unsigned batchSize);
+  /// Returns false if the coordinator cannot be reached
+  bool run(MutantRunner &runner, const std::string &executable,
+           const std::vector<std::string> &extraArgs,
+           std::vector<std::unique_ptr<Mutant>> &mutants);
+
+private:
+  Diagnostics &diagnostics;
+  std::string address;
+  unsigned batchSize;
+};
+
+} // namespace mull
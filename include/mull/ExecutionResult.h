@@ -1,5 +1,6 @@
 #pragma once
 
+#include <csignal>
 #include <sstream>
 #include <string>
 
@@ -13,7 +14,8 @@ enum ExecutionStatus {
   AbnormalExit = 5,
   DryRun = 6,
   FailFast = 7,
-  NotCovered = 8
+  NotCovered = 8,
+  Equivalent = 9
 };
 
 static std::string executionStatusAsString(ExecutionStatus status) {
@@ -38,6 +40,36 @@ static std::string executionStatusAsString(ExecutionStatus status) {
     return "FailFast";
   case NotCovered:
     return "NotCovered";
+  case Equivalent:
+    return "Equivalent";
+  }
+}
+
+/// Programs killed by a signal get 255 + signal number as their exit status (reproc's encoding)
+static const int SignalExitStatusOffset = 255;
+
+static ExecutionStatus executionStatusFromExitStatus(int exitStatus) {
+  if (exitStatus == 0) {
+    return Passed;
+  }
+  if (exitStatus <= SignalExitStatusOffset) {
+    return Failed;
+  }
+  switch (exitStatus - SignalExitStatusOffset) {
+  case SIGSEGV:
+  case SIGBUS:
+  case SIGILL:
+  case SIGFPE:
+  case SIGABRT:
+  case SIGTRAP:
+  case SIGSYS:
+    return Crashed;
+  case SIGXCPU:
+    /// RLIMIT_CPU ran out
+    return Timedout;
+  default:
+    /// E.g. SIGKILL by the OOM killer or SIGXFSZ
+    return AbnormalExit;
   }
 }
 
@@ -45,9 +77,11 @@ struct ExecutionResult {
   ExecutionStatus status;
   int exitStatus;
   long long runningTime;
+  /// User + system CPU time in milliseconds, only measured by Sandbox
+  long long cpuTime;
   std::string stdoutOutput;
   std::string stderrOutput;
-  ExecutionResult() : status(ExecutionStatus::Invalid), exitStatus(0), runningTime(0) {}
+  ExecutionResult() : status(ExecutionStatus::Invalid), exitStatus(0), runningTime(0), cpuTime(0) {}
 
   std::string getStatusAsString() {
     return executionStatusAsString(this->status);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// Looks for failure markers in a stream that arrives in chunks, one instance per stream
+class FailureMarkers {
+public:
+  explicit FailureMarkers(const std::vector<std::string> &markers);
+  /// Returns true once any of the markers has been seen
+  bool scan(const char *chunk, size_t size);
+
+private:
+  const std::vector<std::string> &markers;
+  size_t longestMarker;
+  std::string tail;
+};
+
+} // namespace mull
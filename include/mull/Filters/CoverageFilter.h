@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mull/Filters/MutantFilter.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -14,23 +15,45 @@ class Diagnostics;
 
 class CoverageFilter : public MutantFilter {
 public:
+  /// Code that never ran, both ends included
+  struct Region {
+    std::string path;
+    uint64_t lineStart;
+    uint64_t columnStart;
+    uint64_t lineEnd;
+    uint64_t columnEnd;
+  };
+
   CoverageFilter(const Configuration &configuration, Diagnostics &diagnostics,
                  const std::string &profileName, const std::vector<std::string> &objects);
+  /// Uncovered regions given directly rather than read from a profile
+  CoverageFilter(const Configuration &configuration, const std::vector<Region> &uncoveredRegions);
 
   bool shouldSkip(Mutant *point) override;
   std::string name() override;
 
   bool covered(Mutant *point);
+  /// Source files with code that ran at least once
+  const std::vector<std::string> &getExecutedFiles() const;
 
 private:
-  struct CoverageRange {
-    unsigned lineBegin;
-    unsigned columnBegin;
-    unsigned lineEnd;
-    unsigned columnEnd;
+  /// (line << 32) | column: positions compare like their line and column
+  using Position = uint64_t;
+  /// Both ends included
+  struct Interval {
+    Position begin;
+    Position end;
   };
+  size_t fileIndex(const std::string &path);
+  void mergeIntervals();
+
   const Configuration &configuration;
-  std::unordered_map<std::string, std::vector<CoverageRange>> uncoveredRanges;
+  /// Files with coverage by their absolute path, and by the path the coverage mapping gives
+  std::unordered_map<std::string, size_t> fileIndices;
+  std::vector<std::string> files;
+  /// Per file: sorted, disjoint ranges of code that never ran
+  std::vector<std::vector<Interval>> uncoveredIntervals;
+  std::vector<std::string> executedFiles;
 };
 
 } // namespace mull
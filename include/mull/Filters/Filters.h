@@ -14,6 +14,7 @@ class Diagnostics;
 struct Configuration;
 
 class CoverageFilter;
+class ReachabilityFilter;
 
 class Filters {
 public:
@@ -33,6 +34,7 @@ public:
   void enableManualFilter();
   CoverageFilter *enableCoverageFilter(const std::string &profileName,
                                        const std::vector<std::string> &objects);
+  ReachabilityFilter *enableReachabilityFilter(const std::string &path);
 
 private:
   const Configuration &configuration;
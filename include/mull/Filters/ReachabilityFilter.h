@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mull/Filters/MutantFilter.h"
+#include <string>
+#include <unordered_set>
+
+namespace mull {
+
+struct Configuration;
+class Mutant;
+class Diagnostics;
+
+/// Skips mutants whose code never ran, according to the file the reachability probes wrote
+/// (see runtime::insertReachabilityProbes)
+class ReachabilityFilter : public MutantFilter {
+public:
+  ReachabilityFilter(const Configuration &configuration, Diagnostics &diagnostics,
+                     const std::string &path);
+
+  bool shouldSkip(Mutant *mutant) override;
+  std::string name() override;
+
+  bool reached(Mutant *mutant) const;
+
+private:
+  const Configuration &configuration;
+  std::unordered_set<std::string> reachedMutants;
+};
+
+} // namespace mull
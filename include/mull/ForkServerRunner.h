@@ -0,0 +1,68 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+struct SandboxConfig;
+struct SandboxLimits;
+
+/// Talks to the fork server compiled into the test program (see mull/Runtime/Runtime.h).
+/// The program is started once; every mutant is then a fork of the already initialised process.
+/// In split-stream mode, the program is started unmutated and every mutant is a fork of it at
+/// the first call of the mutated function.
+class ForkServerRunner {
+public:
+  explicit ForkServerRunner(Diagnostics &diagnostics);
+  ~ForkServerRunner();
+
+  /// Without `captureOutput`, the output of the server and of every mutant goes to /dev/null
+  bool start(const std::string &program, const std::vector<std::string> &arguments,
+             const std::unordered_map<std::string, std::string> &environment,
+             const SandboxConfig &resources, long long int timeout, bool captureOutput);
+  /// Returns std::nullopt if the fork server is gone, the caller is expected to fall back
+  /// to Runner::runProgram. As Sandbox::run, kills the mutant as soon as its output contains one
+  /// of the failure markers, which needs the server started with `captureOutput`.
+  std::optional<ExecutionResult> runMutant(const std::string &identifier,
+                                           const SandboxLimits &limits, bool captureOutput,
+                                           const std::vector<std::string> &failureMarkers);
+  void stop();
+
+  /// Starts the program with its split points enabled (see runtime::insertSplitPoint). The
+  /// output of the program and of the mutants goes to /dev/null.
+  bool startSplitStream(const std::string &program, const std::vector<std::string> &arguments,
+                        const SandboxConfig &resources);
+  /// Waits up to `timeout` ms for the program to offer the next mutant. Returns std::nullopt
+  /// once the program finished (or got stuck, it is stopped then).
+  std::optional<std::string> nextSplit(long long int timeout);
+  /// Answers the last offer, the program continues unmutated
+  bool skipSplit();
+  /// Answers the last offer, the mutant runs from the split point on
+  std::optional<ExecutionResult> runSplit(const SandboxLimits &limits);
+
+private:
+  bool launch(const std::string &program, const std::vector<std::string> &arguments,
+              const std::unordered_map<std::string, std::string> &environment,
+              const SandboxConfig &resources, bool captureOutput);
+  bool sendWord(uint32_t word);
+  /// Collects the pid and then the wait status of a mutant forked by the program
+  std::optional<ExecutionResult> waitForMutant(std::chrono::steady_clock::time_point start,
+                                               const SandboxLimits &limits, bool captureOutput,
+                                               const std::vector<std::string> &failureMarkers);
+
+  Diagnostics &diagnostics;
+  pid_t serverPid;
+  int controlFD;
+  int statusFD;
+  int stdoutFD;
+  int stderrFD;
+};
+
+} // namespace mull
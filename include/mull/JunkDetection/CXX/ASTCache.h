@@ -0,0 +1,70 @@
+#pragma once
+
+#include <clang/Frontend/ASTUnit.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clang {
+class PCHContainerOperations;
+} // namespace clang
+
+namespace mull {
+
+class Diagnostics;
+
+/// What junk detection found out about a mutant: the end of a mutant is only known if it is not
+/// junk
+struct JunkVerdict {
+  bool junk;
+  int endLine;
+  int endColumn;
+};
+
+/// By mutator, file, line, and column of the mutants
+using JunkVerdicts = std::unordered_map<std::string, JunkVerdict>;
+
+/// Serialized ASTs of the translation units junk detection parsed before, so that the next
+/// build deserializes them instead of parsing them again. An entry is found by a hash of the
+/// command line and of the contents of the main file, and is only used if none of the files the
+/// translation unit includes changed since. The least recently used entries are removed once the
+/// directory grows over `sizeLimit` bytes.
+///
+/// Entries also keep the junk verdicts of the mutants in their translation unit, so that the next
+/// build neither loads nor parses the translation units that did not change.
+class ASTCache {
+public:
+  ASTCache(Diagnostics &diagnostics, std::string directory, uint64_t sizeLimit);
+  ~ASTCache();
+
+  /// nullptr if there is no usable entry
+  std::unique_ptr<clang::ASTUnit> load(const std::string &sourceFile,
+                                       const std::vector<const char *> &args);
+  void store(const std::string &sourceFile, const std::vector<const char *> &args,
+             clang::ASTUnit &ast);
+
+  /// Empty if there is no usable entry
+  JunkVerdicts loadVerdicts(const std::string &sourceFile, const std::vector<const char *> &args);
+  /// Only kept along with the AST of the translation unit, which must be stored already
+  void storeVerdicts(const std::string &sourceFile, const std::vector<const char *> &args,
+                     const JunkVerdicts &verdicts);
+
+private:
+  std::string key(const std::string &sourceFile, const std::vector<const char *> &args);
+  /// Whether none of the files the entry was built from changed since
+  bool inputsUnchanged(const std::string &entry, const std::string &sourceFile);
+  void touch(const std::string &entry);
+  std::string path(const std::string &key, const char *extension) const;
+  void prune();
+
+  Diagnostics &diagnostics;
+  std::string directory;
+  uint64_t sizeLimit;
+  /// Deserialized ASTs keep referring to its reader
+  std::shared_ptr<clang::PCHContainerOperations> pchOperations;
+};
+
+} // namespace mull
@@ -1,13 +1,18 @@
 #pragma once
 
+#include "mull/JunkDetection/CXX/ASTCache.h"
 #include "mull/JunkDetection/CXX/CompilationDatabase.h"
+#include "mull/JunkDetection/CXX/MutationSiteIndex.h"
 #include "mull/SourceLocation.h"
 
 #include <clang/Frontend/ASTUnit.h>
+#include <llvm/ADT/StringMap.h>
 
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -16,6 +21,12 @@ namespace mull {
 class MutationPoint;
 class Diagnostics;
 
+/// Functions with bodies outside of system headers, in the order of their locations, without the
+/// ones nested in others
+std::vector<clang::Decl *> collectDeclarations(clang::ASTContext &context);
+
+/// Locations in the files declaring functions are resolved from tables built along with the unit,
+/// without locking. Anything else goes through the ASTUnit, one thread at a time.
 class ThreadSafeASTUnit {
 public:
   explicit ThreadSafeASTUnit(std::unique_ptr<clang::ASTUnit> ast);
@@ -28,10 +39,33 @@ public:
   bool isInSystemHeader(clang::SourceLocation &location);
 
   clang::Decl *getDecl(clang::SourceLocation &location);
+  /// Built along with the unit, read without locking
+  const MutationSiteIndex &getMutationSites() const;
   bool hasAST() const;
 
 private:
+  struct DeclRange {
+    unsigned begin;
+    unsigned end;
+    clang::Decl *decl;
+  };
+
+  struct SourceFile {
+    clang::SourceLocation start;
+    llvm::StringRef buffer;
+    bool systemHeader;
+    /// Offset of the beginning of each line
+    std::vector<unsigned> lines;
+    /// Declarations within the file, in the order of their offsets
+    std::vector<DeclRange> decls;
+
+    clang::SourceLocation translate(unsigned line, unsigned column) const;
+  };
+
   void recordDeclarations();
+  void recordFiles();
+  /// The file holding the location, or null if it is not a file location of a recorded file
+  const SourceFile *findFile(clang::SourceLocation location, unsigned &offset) const;
 
   const clang::FileEntry *findFileEntry(const mull::SourceLocation &sourceLocation);
   const clang::FileEntry *findFileEntry(const std::string &filePath);
@@ -39,26 +73,65 @@ private:
   std::unique_ptr<clang::ASTUnit> ast;
   std::mutex mutex;
   std::vector<clang::Decl *> decls;
+  MutationSiteIndex mutationSites;
+  /// Sorted by their start locations
+  std::vector<SourceFile> files;
+  /// Indices into `files` by the paths the files go by, as given and resolved
+  llvm::StringMap<size_t> filePaths;
 };
 
+/// Each file is parsed once, by the first thread asking for it: the others wait for that file
+/// only, files that are already parsed are found without waiting.
 class ASTStorage {
 public:
   ASTStorage(Diagnostics &diagnostics, const std::string &cxxCompilationDatabasePath,
              const std::string &cxxCompilationFlags,
              const std::unordered_map<std::string, std::string> &bitcodeCompilationFlags);
+  ~ASTStorage();
 
   ThreadSafeASTUnit *findAST(const mull::SourceLocation &sourceLocation);
   ThreadSafeASTUnit *findAST(const std::string &sourceFile);
+  /// Starts parsing the files of the mutation points in the background, on up to `workers`
+  /// threads, so that they are ready (or on their way) by the time they are needed
+  void prefetch(const std::vector<MutationPoint *> &points, unsigned workers);
 
   void setAST(const std::string &sourceFile, std::unique_ptr<ThreadSafeASTUnit> astUnit);
+  /// Translation units are looked up in (and added to) the cache before they are parsed
+  void enableCache(const std::string &directory, uint64_t sizeLimit);
+
+  /// The verdict of an earlier build on the mutant, if its translation unit did not change since
+  bool findVerdict(const MutationPoint *point, JunkVerdict &verdict);
+  void recordVerdict(const MutationPoint *point, const JunkVerdict &verdict);
+  /// Keeps the verdicts found by this build in the cache, along with the ASTs
+  void storeVerdicts();
 
 private:
+  struct UnitVerdicts {
+    std::once_flag loaded;
+    /// Read-only once loaded
+    JunkVerdicts previous;
+    std::mutex mutex;
+    JunkVerdicts current;
+    bool changed = false;
+  };
+
+  std::vector<const char *> arguments(const std::string &sourceFile);
+  std::unique_ptr<ThreadSafeASTUnit> parse(const std::string &sourceFile);
+  /// Loaded from the cache on first use
+  UnitVerdicts &findVerdicts(const std::string &sourceFile);
+
   Diagnostics &diagnostics;
+  /// Only guards the maps, never held while parsing
   std::mutex mutex;
   std::mutex mutantNodesMutex;
 
   CompilationDatabase compilationDatabase;
-  std::unordered_map<std::string, std::unique_ptr<ThreadSafeASTUnit>> astUnits;
+  /// Outlives the ASTs it loaded
+  std::unique_ptr<ASTCache> cache;
+  std::unordered_map<std::string, std::shared_future<ThreadSafeASTUnit *>> astUnits;
+  std::vector<std::unique_ptr<ThreadSafeASTUnit>> ownedUnits;
+  std::unordered_map<std::string, std::unique_ptr<UnitVerdicts>> verdicts;
+  std::vector<std::thread> prefetchers;
 };
 
 } // namespace mull
@@ -15,6 +15,8 @@ public:
   bool isJunk(MutationPoint *point) override;
 
 private:
+  bool detectJunk(MutationPoint *point);
+
   Diagnostics &diagnostics;
   ASTStorage &astStorage;
 };
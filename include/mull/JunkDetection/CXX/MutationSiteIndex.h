@@ -0,0 +1,71 @@
+#pragma once
+
+#include "mull/JunkDetection/CXX/Visitors/VisitorParameters.h"
+#include "mull/Mutators/MutatorKind.h"
+
+#include <clang/AST/Expr.h>
+#include <llvm/ADT/STLExtras.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+/// Kinds of the nodes mutators apply to: operator nodes are told apart by their opcode
+enum MutationSiteKind : uint32_t {
+  BinaryOperatorSite = 0x000,
+  UnaryOperatorSite = 0x100,
+  VoidCallSite = 0x200,
+  VariableInitializerSite = 0x201,
+  /// Found by source range rather than by location
+  ScalarCallSite = 0x202,
+  LogicalNotSite = 0x203,
+  NoSite = 0xffffffff
+};
+
+/// The kind of node the mutator applies to, NoSite if there is none to look for
+uint32_t mutationSiteKind(MutatorKind kind);
+bool isRangeSite(uint32_t kind);
+
+/// The nodes the C++ mutators apply to, collected in a single walk over the declarations of a
+/// translation unit. Finding the node of a mutation point is then a lookup rather than another
+/// walk over its whole function.
+class MutationSiteIndex {
+public:
+  /// `decls` are the non-overlapping declarations ThreadSafeASTUnit::getDecl looks in
+  void build(const std::vector<clang::Decl *> &decls);
+
+  /// The node of the given kind at the location of the parameters, within `decl`. Range sites are
+  /// the innermost ones spanning the location.
+  const clang::Stmt *find(uint32_t kind, const VisitorParameters &parameters,
+                          const clang::Decl *decl) const;
+
+  void forEachSite(
+      llvm::function_ref<void(uint32_t kind, clang::SourceLocation location, const clang::Stmt *)>
+          callback) const;
+  void
+  forEachRangeSite(llvm::function_ref<void(uint32_t kind, const clang::Stmt *)> callback) const;
+
+  /// The last token of a mutant found at `location`: the end of the whole expression when the
+  /// mutant starts it, the mutated token otherwise
+  static clang::SourceLocation lastToken(const clang::Stmt *expression,
+                                         clang::SourceLocation location,
+                                         const clang::SourceManager &sourceManager);
+
+private:
+  friend class MutationSiteVisitor;
+
+  using RangeSites = std::unordered_map<const clang::Decl *, std::vector<const clang::Stmt *>>;
+
+  static uint64_t key(clang::SourceLocation location, uint32_t kind);
+  void add(clang::SourceLocation location, uint32_t kind, clang::Expr *expression);
+
+  /// The first node in traversal order wins, as the visitors walking a function used to stop there
+  std::unordered_map<uint64_t, clang::Expr *> sites;
+  /// Candidates matched by source range rather than location, in traversal order
+  RangeSites scalarCalls;
+  RangeSites logicalNots;
+};
+
+} // namespace mull
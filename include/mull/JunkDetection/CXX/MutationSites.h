@@ -0,0 +1,95 @@
+#pragma once
+
+#include "mull/JunkDetection/JunkDetector.h"
+
+#include <llvm/ADT/StringRef.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clang {
+class ASTContext;
+} // namespace clang
+
+namespace llvm {
+class MemoryBuffer;
+class Module;
+} // namespace llvm
+
+namespace mull {
+
+class Diagnostics;
+
+/// Named metadata holding the mutation sites of a translation unit, recorded by the compiler
+/// plugin while the translation unit is compiled. It is a single string of ULEB128 numbers:
+///
+///   header   version, number of files
+///   files    length of the path, the path, number of sites, then for each site: kind (see
+///            MutationSiteKind), line, column, last line - line, last column, end line - line,
+///            end column
+///
+/// A site is found at line:column and ends at end line:end column. Range sites span line:column
+/// to last line:last column instead, mutants anywhere in the range are found in the innermost one.
+constexpr const char *MutationSitesMetadata = "mull.mutation_sites";
+constexpr uint32_t MutationSitesVersion = 1;
+
+struct RecordedMutationSite {
+  uint32_t kind;
+  uint32_t line;
+  uint32_t column;
+  uint32_t lastLine;
+  uint32_t lastColumn;
+  uint32_t endLine;
+  uint32_t endColumn;
+};
+
+/// Finds the sites in every function of the translation unit, see MutationSitesMetadata
+std::string encodeMutationSites(clang::ASTContext &context);
+void recordMutationSites(llvm::Module &module, llvm::StringRef sites);
+bool hasMutationSites(const llvm::Module &module);
+
+/// Junk detection from the sites recorded in the module, none of the sources is parsed again
+class RecordedSitesJunkDetector : public JunkDetector {
+public:
+  RecordedSitesJunkDetector(Diagnostics &diagnostics, const llvm::Module &module);
+
+  bool isJunk(MutationPoint *point) override;
+
+private:
+  /// The range sites of one kind, by first line and column, enclosing ranges first
+  struct RangeSites {
+    std::vector<RecordedMutationSite> sites;
+    /// Position of the innermost range enclosing each range, if any
+    std::vector<size_t> enclosing;
+  };
+
+  struct FileSites {
+    /// By line, column, and kind
+    std::unordered_map<uint64_t, RecordedMutationSite> sites;
+    /// By kind
+    std::unordered_map<uint32_t, RangeSites> rangeSites;
+  };
+
+  struct Source {
+    std::unique_ptr<llvm::MemoryBuffer> buffer;
+    std::vector<unsigned> lines;
+  };
+
+  const FileSites *findFile(const std::string &path);
+  /// Lexes the token at line:column out of the source file, where the compiler recorded nothing
+  bool findEndOfToken(const std::string &path, uint32_t line, uint32_t column, uint32_t &endLine,
+                      uint32_t &endColumn);
+
+  Diagnostics &diagnostics;
+  std::unordered_map<std::string, FileSites> files;
+  /// Guards the paths resolved and the sources read while detecting junk
+  std::mutex mutex;
+  std::unordered_map<std::string, const FileSites *> resolvedPaths;
+  std::unordered_map<std::string, Source> sources;
+};
+
+} // namespace mull
@@ -22,6 +22,11 @@ public:
   const std::string &getMutatorIdentifier() const;
   void setCovered(bool covered);
   bool isCovered() const;
+  /// Tests reaching the mutant, empty if unknown (the whole test program is run then)
+  void addCoveringTest(const std::string &test, long long cpuTime);
+  const std::vector<std::string> &getCoveringTests() const;
+  /// CPU time (ms) the covering tests took on the original program, 0 if unknown
+  long long getBaselineCPUTime() const;
 
   /// needed by AST search
   void setMutatorKind(MutatorKind kind);
@@ -33,6 +38,8 @@ private:
   SourceLocation sourceLocation;
   SourceLocation endLocation;
   bool covered;
+  std::vector<std::string> coveringTests;
+  long long baselineCPUTime;
 
   /// Needed by AST search
   MutatorKind mutatorKind;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm {
+class Module;
+} // namespace llvm
+
+namespace mull {
+
+/// Section of the program holding the mutants it was compiled with
+#if defined __APPLE__
+constexpr const char *MutantsSection = "__mull,.mull_mutants";
+#else
+constexpr const char *MutantsSection = ".mull_mutants";
+#endif
+constexpr const char *MutantsSectionName = ".mull_mutants";
+
+/// Every translation unit puts one manifest of its mutants into the section, the linker
+/// concatenates them (possibly with zero padding in between). A manifest is:
+///
+///   header     "\x7fMUL", then 32-bit little-endian words: version, size of the whole manifest,
+///              size of the string table, number of files, of mutators, and of mutants
+///   strings    NUL-terminated file paths and mutator identifiers
+///   files      offset of each file path in the string table, 32-bit words
+///   mutators   offset of each mutator identifier in the string table, 32-bit words
+///   mutants    ULEB128 numbers for each mutant: file index, mutator index, begin line,
+///              begin column, end line, end column
+///
+/// Each file path and mutator identifier is stored once per translation unit, a mutant takes a
+/// handful of bytes. The end is stored as is, it is 0:0 until junk detection sets it. Version 1
+/// stored end line - begin line instead, and clamped it to 0 when the end came first.
+constexpr uint32_t MutantManifestVersion = 2;
+
+struct ManifestMutant {
+  /// Point into the section
+  llvm::StringRef mutator;
+  llvm::StringRef file;
+  uint32_t beginLine;
+  uint32_t beginColumn;
+  uint32_t endLine;
+  uint32_t endColumn;
+};
+
+class MutantManifestWriter {
+public:
+  void add(llvm::StringRef mutator, llvm::StringRef file, uint32_t beginLine, uint32_t beginColumn,
+           uint32_t endLine, uint32_t endColumn);
+  bool empty() const;
+  std::string encode() const;
+
+private:
+  uint32_t intern(llvm::StringMap<uint32_t> &indices, std::vector<uint32_t> &offsets,
+                  llvm::StringRef string);
+
+  std::string strings;
+  llvm::StringMap<uint32_t> fileIndices;
+  llvm::StringMap<uint32_t> mutatorIndices;
+  std::vector<uint32_t> fileOffsets;
+  std::vector<uint32_t> mutatorOffsets;
+  std::string mutants;
+  uint32_t mutantCount = 0;
+};
+
+/// Adds the manifest to the module's mutants section
+void recordMutantManifest(llvm::Module &module, const MutantManifestWriter &manifest);
+
+/// Calls `callback` for every mutant in the contents of a mutants section, without copying it.
+/// Strings in the format used before the manifests (one "mutator:file:line:column:end line:end
+/// column" per mutant) are read as well. Returns false if some of the section could not be read.
+bool readMutantManifests(llvm::StringRef section,
+                         llvm::function_ref<void(const ManifestMutant &)> callback);
+
+/// "mutator:file:line:column:end line:end column", the identifier mutants go by
+std::string mutantIdentifier(const ManifestMutant &mutant);
+
+} // namespace mull
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+#include "mull/Mutant.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace mull {
+
+/// Estimates how likely a mutant is to survive from the results of previous runs: its own
+/// results if it was run before, and those of all mutants of its mutator. Running the likely
+/// survivors first makes a partial (e.g. time-boxed) run report the most useful mutants.
+class MutantPrioritizer {
+public:
+  /// One result of a previous run, results of several runs can be added
+  void addResult(const std::string &identifier, const std::string &mutator,
+                 ExecutionStatus status);
+  bool empty() const;
+  /// Between 0 and 1, mutants of unknown mutators get 0.5
+  double survivalChance(const Mutant &mutant) const;
+
+private:
+  struct Tally {
+    unsigned survived = 0;
+    unsigned total = 0;
+  };
+  std::unordered_map<std::string, Tally> mutants;
+  std::unordered_map<std::string, Tally> mutators;
+};
+
+} // namespace mull
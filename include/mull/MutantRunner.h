@@ -6,10 +6,14 @@
 #include "mull/MutationResult.h"
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mull {
 
+class MutantPrioritizer;
+
 class MutantRunner {
 public:
   MutantRunner(Diagnostics &diagnostics, const Configuration &configuration, Runner &runner);
@@ -18,11 +22,32 @@ public:
   std::vector<std::unique_ptr<MutationResult>>
   runMutants(const std::string &executable, const std::vector<std::string> &extraArgs,
              std::vector<std::unique_ptr<Mutant>> &mutants);
+  /// The baseline is measured once by the caller, e.g. when mutants come in batches
+  ExecutionResult runBaseline(const std::string &executable,
+                              const std::vector<std::string> &extraArgs);
+  std::vector<std::unique_ptr<MutationResult>>
+  runMutants(const std::string &executable, const std::vector<std::string> &extraArgs,
+             const ExecutionResult &baseline, std::vector<std::unique_ptr<Mutant>> &mutants);
+  /// Durations (ms) of the mutants in a previous run, by identifier: the most accurate estimate
+  /// for running the longest mutants first
+  void setPreviousDurations(std::unordered_map<std::string, long long> durations);
+  void setResultListener(MutationResultListener listener);
+  /// Mutants likely to survive run first, the longest ones first among equally likely
+  void setPrioritizer(const MutantPrioritizer *prioritizer);
 
 private:
+  /// Returns results for the mutants the split streams reached, see SplitStreamTask
+  std::vector<std::unique_ptr<MutationResult>>
+  runSplitStreams(const std::string &executable, const std::vector<std::string> &extraArgs,
+                  const ExecutionResult &baseline,
+                  const std::vector<std::unique_ptr<Mutant>> &mutants);
+
   Diagnostics &diagnostics;
   const Configuration &configuration;
   Runner &runner;
+  std::unordered_map<std::string, long long> previousDurations;
+  MutationResultListener resultListener;
+  const MutantPrioritizer *prioritizer = nullptr;
 };
 
 } // namespace mull
@@ -26,6 +26,7 @@ namespace mull {
 
 class Compiler;
 class Mutator;
+class MutantManifestWriter;
 class Bitcode;
 class Test;
 
@@ -91,7 +92,9 @@ public:
   const SourceLocation &getEndLocation() const;
 
   void applyMutation();
-  void recordMutation();
+  /// Mutates `instruction`, a copy of the original one, wherever it is
+  void applyMutation(llvm::Instruction &instruction);
+  void recordMutation(MutantManifestWriter &manifest) const;
 
   std::string getMutatorIdentifier() const;
 
@@ -2,7 +2,11 @@
 
 #include "mull/ExecutionResult.h"
 #include "mull/Mutant.h"
+#include <functional>
+#include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 namespace mull {
 
@@ -35,4 +39,24 @@ struct MutationResultComparator {
   }
 };
 
+/// Called as soon as a mutant has a result, possibly from several threads at once
+using MutationResultListener = std::function<void(const Mutant &, const ExecutionResult &)>;
+
+/// Runs mutants and returns a result for every one of them, in order
+using RunMutants = std::function<std::vector<std::unique_ptr<MutationResult>>(
+    std::vector<std::unique_ptr<Mutant>> &)>;
+
+/// Returns a result for every mutant, in the order of `mutants`: `known` provides the results
+/// that are already known (e.g. from a cache or an interrupted run), the other mutants go through
+/// `run`
+std::vector<std::unique_ptr<MutationResult>>
+runRemaining(std::vector<std::unique_ptr<Mutant>> &mutants,
+             const std::function<std::optional<ExecutionResult>(const Mutant &)> &known,
+             const RunMutants &run);
+
+/// Mutants the tests can kill: equivalent mutants cannot, they do not count
+size_t countKillableMutants(const std::vector<std::unique_ptr<MutationResult>> &results);
+/// Killed mutants in percent of the killable ones, 100 if none can be killed
+int mutationScore(const std::vector<std::unique_ptr<MutationResult>> &results);
+
 } // namespace mull
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace mull {
+
+/// Collects a program's output stream with bounded memory: only the beginning and the end are
+/// kept, up to `limit` bytes in total, which is where test frameworks report what failed. The
+/// whole output can also be written to a file as it comes.
+class OutputCapture {
+public:
+  /// A `limit` of 0 keeps everything, an empty `spillPath` writes no file
+  explicit OutputCapture(size_t limit = 0, std::string spillPath = std::string());
+  ~OutputCapture();
+  OutputCapture(const OutputCapture &) = delete;
+  OutputCapture &operator=(const OutputCapture &) = delete;
+
+  void append(const char *data, size_t size);
+  /// Returns the kept output, noting how many bytes were left out in the middle
+  std::string take();
+
+private:
+  void spill(const char *data, size_t size);
+
+  size_t limit;
+  std::string head;
+  std::string tail;
+  size_t total;
+  std::string spillPath;
+  int spillFD;
+};
+
+} // namespace mull
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <string>
@@ -14,7 +16,21 @@ namespace mull {
 
 class Diagnostics;
 
-std::vector<int> taskBatches(size_t itemsCount, size_t tasks);
+/// Hands out consecutive ranges of the input to the workers: large ranges first, smaller ones as
+/// the input runs out (guided self-scheduling). Unlike fixed batches, a worker stuck on a slow
+/// range does not hold back the rest of the input, the other workers take it.
+class WorkQueue {
+public:
+  WorkQueue(size_t itemsCount, size_t workers);
+  /// Returns false once the whole input is taken
+  bool take(size_t &begin, size_t &end);
+
+private:
+  std::atomic<size_t> next;
+  size_t itemsCount;
+  size_t workers;
+};
+
 void printTimeSummary(Diagnostics &diagnostics, MetricsMeasure measure);
 
 template <typename Task> class TaskExecutor {
@@ -47,24 +63,28 @@ private:
     assert(in.size() != 1);
     auto workers = std::min(in.size(), tasks.size());
 
-    auto batches = taskBatches(in.size(), workers);
+    /// A task is called once per range it takes, results are put back in the input order
+    using Piece = std::pair<size_t, Out>;
+    WorkQueue queue(in.size(), workers);
     std::vector<std::thread> threads;
-    std::vector<Out> storages;
+    std::vector<std::vector<Piece>> pieces(workers);
 
-    storages.reserve(workers);
     counters.reserve(workers);
-
-    auto end = in.begin();
     for (unsigned i = 0; i < workers; i++) {
-      int group = batches[i];
-      storages.push_back(Out());
       counters.push_back(progress_counter());
-
-      auto begin = end;
-      std::advance(end, group);
-      std::thread t(
-          std::move(tasks[i]), begin, end, std::ref(storages.back()), std::ref(counters.back()));
-      threads.push_back(std::move(t));
+    }
+    for (unsigned i = 0; i < workers; i++) {
+      auto worker = [this, &queue](Task task, std::vector<Piece> &storage, progress_counter &counter) {
+        size_t begin = 0;
+        size_t end = 0;
+        while (queue.take(begin, end)) {
+          Out piece;
+          task(std::next(in.begin(), begin), std::next(in.begin(), end), piece, counter);
+          storage.emplace_back(begin, std::move(piece));
+        }
+      };
+      threads.emplace_back(
+          worker, std::move(tasks[i]), std::ref(pieces[i]), std::ref(counters[i]));
     }
 
     std::thread reporter(progress_reporter{ diagnostics, name, counters, in.size(), workers });
@@ -74,8 +94,15 @@ private:
       t.join();
     }
 
-    for (auto &storage : storages) {
-      for (auto &m : storage) {
+    std::vector<Piece> ordered;
+    for (auto &storage : pieces) {
+      std::move(storage.begin(), storage.end(), std::back_inserter(ordered));
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const Piece &lhs, const Piece &rhs) {
+      return lhs.first < rhs.first;
+    });
+    for (auto &piece : ordered) {
+      for (auto &m : piece.second) {
         out.push_back(std::move(m));
       }
     }
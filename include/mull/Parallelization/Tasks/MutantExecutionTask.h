@@ -7,6 +7,7 @@ namespace mull {
 
 class progress_counter;
 class Diagnostics;
+class ForkServerRunner;
 struct Configuration;
 
 class MutantExecutionTask {
@@ -16,8 +17,11 @@ public:
   using iterator = In::const_iterator;
 
   MutantExecutionTask(const Configuration &configuration, Diagnostics &diagnostics,
-                      const std::string &executable, ExecutionResult &baseline,
-                      const std::vector<std::string> &extraArgs);
+                      const std::string &executable, const ExecutionResult &baseline,
+                      const std::vector<std::string> &extraArgs,
+                      const MutationResultListener &listener);
+  MutantExecutionTask(MutantExecutionTask &&) noexcept;
+  ~MutantExecutionTask();
 
   void operator()(iterator begin, iterator end, Out &storage, progress_counter &counter);
 
@@ -25,7 +29,12 @@ private:
   const Configuration &configuration;
   Diagnostics &diagnostics;
   const std::string &executable;
-  ExecutionResult &baseline;
+  const ExecutionResult &baseline;
   const std::vector<std::string> &extraArgs;
+  const MutationResultListener &listener;
+  /// Each worker owns its fork server, it is started on the first covered mutant and kept
+  /// across the ranges the worker takes
+  std::unique_ptr<ForkServerRunner> forkServer;
+  bool forkServerEnabled;
 };
 } // namespace mull
@@ -15,12 +15,15 @@ public:
   using Out = std::vector<int>;
   using iterator = In::const_iterator;
 
-  CloneMutatedFunctionsTask() = default;
+  explicit CloneMutatedFunctionsTask(bool schemata = false) : schemata(schemata) {}
 
   void operator()(iterator begin, iterator end, Out &storage, progress_counter &counter);
-  static void cloneFunctions(Bitcode &bitcode);
+  /// A copy of the function for each of its mutants or, with `schemata`, a single copy (schema)
+  /// for all of them where their instructions can be guarded, see ApplyMutantSchemataTask
+  static void cloneFunctions(Bitcode &bitcode, bool schemata = false);
 
 private:
+  bool schemata;
 };
 
 class DeleteOriginalFunctionsTask {
@@ -53,4 +56,21 @@ private:
   const Configuration &configuration;
 };
 
+/// Applies the mutants of each schema, instead of ApplyMutationTask: every mutated instruction
+/// is a copy of the original one, next to it, and runs instead of it when the active mutant is
+/// its own. Functions without a schema are left alone.
+class ApplyMutantSchemataTask {
+public:
+  using In = std::vector<std::unique_ptr<Bitcode>>;
+  using Out = std::vector<int>;
+  using iterator = In::const_iterator;
+
+  ApplyMutantSchemataTask() = default;
+
+  void operator()(iterator begin, iterator end, Out &storage, progress_counter &counter);
+  static void applySchemata(Bitcode &bitcode);
+
+private:
+};
+
 } // namespace mull
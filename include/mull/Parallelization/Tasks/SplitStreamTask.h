@@ -0,0 +1,36 @@
+#pragma once
+
+#include "mull/Mutant.h"
+#include "mull/MutationResult.h"
+
+namespace mull {
+
+class progress_counter;
+class Diagnostics;
+struct Configuration;
+
+/// Runs the test program once per group of mutants in split-stream mode (see
+/// ForkServerRunner::startSplitStream): each mutant of the group is forked from the unmutated
+/// program when its function is first called. Mutants the program never reaches get no result.
+class SplitStreamTask {
+public:
+  using In = const std::vector<std::vector<Mutant *>>;
+  using Out = std::vector<std::unique_ptr<MutationResult>>;
+  using iterator = In::const_iterator;
+
+  SplitStreamTask(const Configuration &configuration, Diagnostics &diagnostics,
+                  const std::string &executable, const ExecutionResult &baseline,
+                  const std::vector<std::string> &extraArgs,
+                  const MutationResultListener &listener);
+
+  void operator()(iterator begin, iterator end, Out &storage, progress_counter &counter);
+
+private:
+  const Configuration &configuration;
+  Diagnostics &diagnostics;
+  const std::string &executable;
+  const ExecutionResult &baseline;
+  const std::vector<std::string> &extraArgs;
+  const MutationResultListener &listener;
+};
+} // namespace mull
@@ -3,12 +3,17 @@
 namespace mull {
 
 class Result;
+class Mutant;
+struct ExecutionResult;
 
 enum class ReporterKind { IDE, SQLite, Elements, Patches, GithubAnnotations };
 
 class Reporter {
 public:
   virtual void reportResults(const Result &result) = 0;
+  /// Called as soon as a mutant has a result, possibly from several threads at once. Reporters
+  /// that persist results save them right away, so that an interrupted run is not lost.
+  virtual void reportResult(const Mutant &mutant, const ExecutionResult &result) {}
   virtual ~Reporter() = default;
 };
 
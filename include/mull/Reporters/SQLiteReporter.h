@@ -3,10 +3,15 @@
 #include "mull/ExecutionResult.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+struct sqlite3;
+struct sqlite3_stmt;
+
 namespace mull {
 
 class Result;
@@ -15,6 +20,8 @@ class Diagnostics;
 struct RawReport {
   std::unordered_map<std::string, std::string> info;
   std::unordered_map<std::string, std::vector<mull::ExecutionResult>> executionResults;
+  /// Mutator of each mutant
+  std::unordered_map<std::string, std::string> mutators;
 };
 
 class SQLiteReporter : public Reporter {
@@ -23,15 +30,31 @@ public:
                           const std::string &reportName = "",
                           std::unordered_map<std::string, std::string> mullInformation = {});
 
+  ~SQLiteReporter() override;
+
   void reportResults(const Result &result) override;
+  void reportResult(const Mutant &mutant, const ExecutionResult &result) override;
 
   std::string getDatabasePath();
+  /// Appends to an existing report, e.g. of an interrupted run, instead of creating a new one.
+  /// Mutants already in it keep their rows.
+  void continueReport(const std::string &path);
   static RawReport loadRawReport(const std::string &databasePath);
 
 private:
   Diagnostics &diagnostics;
   std::string databasePath;
   std::unordered_map<std::string, std::string> mullInformation;
+
+  /// The database stays open during the run, results are committed one by one as they come
+  void openJournal();
+  void closeJournal();
+  std::mutex journalMutex;
+  sqlite3 *journal = nullptr;
+  sqlite3_stmt *insertMutantStmt = nullptr;
+  bool continued = false;
+  /// Mutants already in the database
+  std::unordered_set<std::string> journaled;
 };
 
 } // namespace mull
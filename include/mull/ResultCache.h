@@ -0,0 +1,62 @@
+#pragma once
+
+#include "mull/ExecutionResult.h"
+#include "mull/Mutant.h"
+#include "mull/MutationResult.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+
+/// Results of previous runs, stored in a directory under a hash of everything that decides a
+/// mutant's fate: the mutant, the contents of its source file, the contents of the files the tests
+/// reaching it execute, and the settings of the run. A mutant whose hash did not change since it
+/// was last run gets its previous result instead of being run again.
+///
+/// The files are those coverage knows about: headers without executable regions, code that only
+/// the mutated program reaches, and uninstrumented libraries are not part of the hash. Changes to
+/// them go unnoticed, see docs/MullConfig.rst.
+class ResultCache {
+public:
+  /// `settings` covers whatever else affects the results, e.g. the test program's arguments
+  ResultCache(Diagnostics &diagnostics, std::string directory, std::string settings);
+
+  /// Files the whole test program consists of: the source files it executes, or the binaries
+  /// themselves when that is not known
+  void setProgramFiles(std::vector<std::string> files);
+  /// Source files each test executes, see collectPerTestCoverage. Mutants reached by known tests
+  /// only depend on those tests' files.
+  void setTestFiles(std::unordered_map<std::string, std::vector<std::string>> files);
+
+  std::string key(const Mutant &mutant);
+  std::optional<ExecutionResult> load(const Mutant &mutant);
+  void store(const Mutant &mutant, const ExecutionResult &result);
+
+  /// Returns a result for every mutant, in the order of `mutants`. Only the mutants without a
+  /// cached result go through `run`, their results are cached.
+  std::vector<std::unique_ptr<MutationResult>> run(std::vector<std::unique_ptr<Mutant>> &mutants,
+                                                   const RunMutants &run);
+
+private:
+  const std::string &fileHash(const std::string &path);
+  const std::string &programHash();
+  std::string path(const std::string &key) const;
+
+  Diagnostics &diagnostics;
+  std::string directory;
+  std::string settings;
+  std::vector<std::string> programFiles;
+  std::unordered_map<std::string, std::vector<std::string>> testFiles;
+  std::optional<std::string> programFingerprint;
+  std::unordered_map<std::string, std::string> fileHashes;
+  std::unordered_map<std::string, std::string> testHashes;
+  std::unordered_map<std::string, std::string> keys;
+};
+
+} // namespace mull
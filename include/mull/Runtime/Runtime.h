@@ -0,0 +1,110 @@
+#pragma once
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringMap.h>
+#include <string>
+#include <utility>
+
+namespace llvm {
+class BasicBlock;
+class Constant;
+class Function;
+class GlobalVariable;
+class Instruction;
+class Module;
+} // namespace llvm
+
+namespace mull {
+namespace runtime {
+
+/// The runtime is not a separate library: the IR frontend emits it into every instrumented
+/// module as linkonce_odr definitions, so that the linker keeps exactly one copy per image.
+
+/// Holds the identifier of the mutant to enable
+constexpr const char *MutantEnvironmentVariable = "MULL_MUTANT_ID";
+
+/// File descriptors used by the fork server: mull-runner writes mutant identifiers into the
+/// control descriptor and reads child pids and wait statuses from the status descriptor.
+constexpr int ForkServerControlFD = 198;
+constexpr int ForkServerStatusFD = 199;
+/// Sent by the fork server once it is ready to accept mutants
+constexpr unsigned ForkServerHello = 0x4d554c4c;
+/// The fork server stays dormant unless this variable is set
+constexpr const char *ForkServerEnvironmentVariable = "MULL_FORK_SERVER";
+/// Split points stay dormant unless this variable is set. A split-stream run uses the fork
+/// server's descriptors the other way around: the program offers mutants over the status
+/// descriptor and reads whether to run them from the control descriptor.
+constexpr const char *SplitStreamEnvironmentVariable = "MULL_SPLIT_STREAM";
+/// Reachability probes append the identifiers of the mutants reached to the file it names
+constexpr const char *ReachabilityEnvironmentVariable = "MULL_REACHABILITY_FILE";
+/// Weak mutation probes append the identifiers of the mutants evaluated to the file it names,
+/// prefixed with '+' if the mutant's value ever differed from the original one, '-' otherwise
+constexpr const char *WeakMutationEnvironmentVariable = "MULL_WEAK_MUTATION_FILE";
+
+/// Every runtime feature compiled into a module leaves its name in this section, so that
+/// mull-runner can find out what the test program supports without running it
+#if defined __APPLE__
+constexpr const char *RuntimeSection = "__mull,.mull_runtime";
+#else
+constexpr const char *RuntimeSection = ".mull_runtime";
+#endif
+constexpr const char *RuntimeSectionName = ".mull_runtime";
+constexpr const char *ForkServerFeature = "fork-server";
+constexpr const char *SplitStreamFeature = "split-stream";
+constexpr const char *ReachabilityFeature = "reachability";
+constexpr const char *WeakMutationFeature = "weak-mutation";
+
+void recordFeature(llvm::Module &module, const char *feature);
+
+/// Assigns the mutants of the module dense indices (their position in `identifiers`) and adds
+/// a constructor that looks up MULL_MUTANT_ID once. Returns the internal i32 variable holding the
+/// index of the active mutant, or -1 if none of the module's mutants is enabled
+llvm::GlobalVariable *insertMutantActivation(llvm::Module &module,
+                                             llvm::ArrayRef<std::string> identifiers);
+/// The variable insertMutantActivation returned
+llvm::GlobalVariable *getActiveMutant(llvm::Module &module);
+/// void __mull_reinitialize_mutants(): re-reads MULL_MUTANT_ID in every instrumented module
+llvm::Function *getReinitializeMutants(llvm::Module &module);
+/// The identifier (i8*) of the mutant with the given index, see insertMutantActivation
+llvm::Constant *getMutantIdentifier(llvm::Module &module, uint32_t index);
+/// The [N x i8*] table of the identifiers, indexed like the mutants
+llvm::GlobalVariable *getMutantsTable(llvm::Module &module);
+/// The index of every mutant in the table, by identifier
+llvm::StringMap<uint32_t> getMutantIndices(llvm::Module &module);
+/// Adds a destructor that, when `environmentVariable` names a file, appends the identifiers of
+/// the mutants whose byte in `flags` ([N x i8], indexed like the table) is set, one per line.
+/// With `marks`, each line starts with '+' if the mutant's byte in `marks` is set, '-' otherwise.
+void insertMutantsDump(llvm::Module &module, const char *name, const char *environmentVariable,
+                       llvm::GlobalVariable *flags, llvm::GlobalVariable *marks = nullptr);
+
+/// Adds a constructor that, when MULL_FORK_SERVER is set, stops the program right after
+/// startup and forks a child for every mutant identifier received over the control descriptor
+void insertForkServer(llvm::Module &module);
+
+/// Makes `block` a split point for the mutants with the given indices: the first time it runs,
+/// with MULL_SPLIT_STREAM set, the program forks a child for each of the mutants, which
+/// continues from there with the mutant enabled, while the program itself goes on unmutated.
+/// Returns the block where execution continues, the caller fills it.
+llvm::BasicBlock *insertSplitPoint(llvm::Module &module, llvm::BasicBlock *block,
+                                   llvm::ArrayRef<uint32_t> mutantIndices);
+
+/// Each instruction, in the unmutated code, marks the mutant with the given identifier reached
+/// whenever its block runs. At exit, with MULL_REACHABILITY_FILE set, the identifiers of the
+/// reached mutants are appended to that file, one per line.
+void insertReachabilityProbes(
+    llvm::Module &module, llvm::ArrayRef<std::pair<llvm::Instruction *, std::string>> probes);
+
+struct WeakMutationProbe {
+  /// In the unmutated code
+  llvm::Instruction *original;
+  /// Not inserted anywhere, computes the mutant's value from values available at `original`
+  llvm::Instruction *mutated;
+  std::string identifier;
+};
+/// Inserts each mutated instruction right after its original one, comparing their values every
+/// time they run. At exit, with MULL_WEAK_MUTATION_FILE set, the mutants evaluated are appended
+/// to that file (see WeakMutationEnvironmentVariable). Takes ownership of the mutated instructions.
+void insertWeakMutationProbes(llvm::Module &module, llvm::ArrayRef<WeakMutationProbe> probes);
+
+} // namespace runtime
+} // namespace mull
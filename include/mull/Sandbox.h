@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+#include "mull/ExecutionResult.h"
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+
+struct SandboxLimits {
+  /// CPU time (user + system) in milliseconds, 0 means no limit
+  long long cpuTime = 0;
+  /// Wall-clock backstop in milliseconds: catches programs that block instead of spinning
+  long long wallTime = 0;
+  SandboxConfig resources{};
+  /// Bytes of each output stream kept when the output is captured, see OutputCapture
+  size_t outputLimit = 0;
+  /// If set, the whole output is also written to <outputFile>.stdout and <outputFile>.stderr
+  std::string outputFile;
+};
+
+/// Runs mutants: unlike Runner, it owns the child process, so that the child's CPU time can be
+/// measured and limited
+class Sandbox {
+public:
+  explicit Sandbox(Diagnostics &diagnostics);
+  ExecutionResult run(const std::string &program, const std::vector<std::string> &arguments,
+                      const std::unordered_map<std::string, std::string> &environment,
+                      const SandboxLimits &limits, bool captureOutput,
+                      const std::vector<std::string> &failureMarkers);
+
+private:
+  Diagnostics &diagnostics;
+};
+
+/// Applies the resource limits and the process group to the current process. Meant to be called
+/// between fork and exec, hence only does async-signal-safe calls.
+void enterSandbox(const SandboxConfig &resources);
+
+/// A pipe whose ends are closed on exec from the start: programs other threads fork meanwhile
+/// never inherit them
+bool createPipe(int fds[2]);
+/// fork(), serialized with createPipe where pipes cannot be created closed on exec atomically
+pid_t forkProcess();
+
+/// CPU time consumed so far by a running process, in milliseconds
+std::optional<long long> processCPUTime(pid_t pid);
+
+} // namespace mull
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "mull/Config/ConfigurationOptions.h"
+#include <string>
+#include <vector>
+
+namespace mull {
+
+/// Knows how to talk to the test frameworks Mull can select individual tests from
+class TestFramework {
+public:
+  explicit TestFramework(TestFrameworkKind kind);
+
+  bool supportsTestSelection() const;
+  /// Arguments making the test program print its tests instead of running them
+  std::vector<std::string> listTestsArguments() const;
+  std::vector<std::string> parseTestList(const std::string &output) const;
+  /// Arguments making the test program run only the given tests. Empty if the selection is too
+  /// long for a command line: the whole test program runs instead.
+  std::vector<std::string> selectTestsArguments(const std::vector<std::string> &tests) const;
+  /// Arguments making the test program stop on the first failing test
+  std::vector<std::string> failFastArguments() const;
+  /// Output printed by the framework when a test fails
+  std::vector<std::string> failureMarkers() const;
+
+private:
+  TestFrameworkKind kind;
+};
+
+} // namespace mull
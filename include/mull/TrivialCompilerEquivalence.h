@@ -0,0 +1,60 @@
+#pragma once
+
+#include "mull/Mutant.h"
+#include "mull/MutationResult.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm {
+class Function;
+class GlobalVariable;
+class Module;
+} // namespace llvm
+
+namespace mull {
+
+class Bitcode;
+
+/// Trivial compiler equivalence: every version of a mutated function (the original and each
+/// mutant) is optimized on its own, mutants that end up identical to the original cannot be
+/// killed (equivalent), mutants identical to another mutant of the function behave exactly like
+/// it (duplicates). E.g. `x * 1` -> `x / 1`, or `i++` -> `++i` with the result unused.
+///
+/// Maps the identifier of a mutant to the identifier of the mutant it duplicates, or to an empty
+/// string if it is equivalent to the original.
+using Equivalences = std::unordered_map<std::string, std::string>;
+
+/// Section of the program holding the equivalences found by the IR frontend
+#if defined __APPLE__
+constexpr const char *EquivalencesSection = "__mull,.mull_equivalent";
+#else
+constexpr const char *EquivalencesSection = ".mull_equivalent";
+#endif
+constexpr const char *EquivalencesSectionName = ".mull_equivalent";
+
+/// Hash of the function's code after optimizing it in a module of its own, independent of its
+/// name and of the names of its values. Empty if the function cannot be compared this way.
+std::string optimizedFunctionHash(const llvm::Function &function);
+/// Same for one mutant of a schema: the hashed code has the mutant `index` active, the guards of
+/// the other mutants fold away
+std::string optimizedFunctionHash(const llvm::Function &schema,
+                                  const llvm::GlobalVariable &activeMutant, uint32_t index);
+
+/// Must run once the mutations are applied
+Equivalences findEquivalentMutants(Bitcode &bitcode);
+
+void recordEquivalences(llvm::Module &module, const Equivalences &equivalences);
+/// Reads an entry of the section written by recordEquivalences
+void decodeEquivalence(const std::string &entry, Equivalences &equivalences);
+
+/// Returns a result for every mutant, in the order of `mutants`: equivalent mutants are reported
+/// as Equivalent without running them, duplicates get the result of the mutant they duplicate,
+/// the others go through `run`
+std::vector<std::unique_ptr<MutationResult>> runDistinct(std::vector<std::unique_ptr<Mutant>> &mutants,
+                                                         const Equivalences &equivalences,
+                                                         const RunMutants &run);
+
+} // namespace mull
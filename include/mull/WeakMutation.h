@@ -0,0 +1,47 @@
+#pragma once
+
+#include "mull/Mutant.h"
+#include "mull/MutationResult.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace llvm {
+class Instruction;
+} // namespace llvm
+
+namespace mull {
+
+class Diagnostics;
+class MutationPoint;
+
+/// Weak mutation: the unmutated program computes each mutant's value next to the original one
+/// and records whether they ever differed. A mutant whose value never differed from the original
+/// one, each time the tests evaluated it, cannot change what the program does: running it would
+/// only confirm that it survives.
+///
+/// Returns the mutated instruction of the mutation point, copied so that it can be inserted right
+/// after the original one (see runtime::insertWeakMutationProbes), or nullptr if it cannot be
+/// evaluated on the side: the mutant is not a single operation, has side effects, or may trap.
+/// Must run once the mutation is applied.
+llvm::Instruction *createWeakMutation(const MutationPoint &point);
+
+/// What the probes wrote during a run, see runtime::WeakMutationEnvironmentVariable
+struct WeakMutationReport {
+  std::unordered_set<std::string> evaluated;
+  std::unordered_set<std::string> infected;
+
+  bool notInfected(const std::string &identifier) const;
+};
+WeakMutationReport readWeakMutationReport(Diagnostics &diagnostics, const std::string &path);
+
+/// Returns a result for every mutant, in the order of `mutants`: mutants that were evaluated but
+/// never infected are reported as survivors (Passed) without running them, the others go
+/// through `run`
+std::vector<std::unique_ptr<MutationResult>> runInfected(std::vector<std::unique_ptr<Mutant>> &mutants,
+                                                         const WeakMutationReport &report,
+                                                         const RunMutants &run);
+
+} // namespace mull
@@ -53,3 +53,11 @@ void Bitcode::addMutation(MutationPoint *point) {
 std::map<llvm::Function *, std::vector<MutationPoint *>> &Bitcode::getMutationPointsMap() {
   return mutationPoints;
 }
+
+void Bitcode::addMutantSchema(llvm::Function *function) {
+  mutantSchemata.insert(function);
+}
+
+bool Bitcode::hasMutantSchema(llvm::Function *function) const {
+  return mutantSchemata.count(function) != 0;
+}
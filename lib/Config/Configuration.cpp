@@ -3,12 +3,19 @@
 namespace mull {
 
 int MullDefaultTimeoutMilliseconds = 3000;
+unsigned MullDefaultMutantOutputLimit = 1024 * 1024;
+unsigned MullDefaultASTCacheSizeLimit = 2048;
 
 Configuration::Configuration()
     : pathOnDisk(), debugEnabled(false), quiet(true), silent(false), dryRunEnabled(false),
       captureTestOutput(true), captureMutantOutput(true), includeNotCovered(false),
-      junkDetectionDisabled(false), timeout(MullDefaultTimeoutMilliseconds),
+      junkDetectionDisabled(false), forkServer(false), splitStream(false), failFast(false),
+      prioritizeSurvivors(false), detectEquivalentMutants(false),
+      reachabilityProbes(false), weakMutation(false), mutantSchemata(false),
+      timeout(MullDefaultTimeoutMilliseconds), mutantOutputLimit(MullDefaultMutantOutputLimit),
       diagnostics(IDEDiagnosticsKind::None),
+      testFramework(TestFrameworkKind::None), astCacheSizeLimit(MullDefaultASTCacheSizeLimit),
+      astPrefetch(false),
       parallelization(ParallelizationConfig::defaultConfig()) {}
 
 } // namespace mull
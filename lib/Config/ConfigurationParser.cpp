@@ -17,6 +17,15 @@ template <> struct llvm::yaml::ScalarEnumerationTraits<IDEDiagnosticsKind> {
   }
 };
 
+template <> struct llvm::yaml::ScalarEnumerationTraits<TestFrameworkKind> {
+  static void enumeration(llvm::yaml::IO &io, TestFrameworkKind &value) {
+    io.enumCase(value, "none", TestFrameworkKind::None);
+    io.enumCase(value, "gtest", TestFrameworkKind::GoogleTest);
+    io.enumCase(value, "catch2", TestFrameworkKind::Catch2);
+    io.enumCase(value, "doctest", TestFrameworkKind::Doctest);
+  }
+};
+
 template <> struct llvm::yaml::MappingTraits<ParallelizationConfig> {
   static void mapping(llvm::yaml::IO &io, ParallelizationConfig &config) {
     io.mapOptional("workers", config.workers);
@@ -24,6 +33,16 @@ template <> struct llvm::yaml::MappingTraits<ParallelizationConfig> {
   }
 };
 
+template <> struct llvm::yaml::MappingTraits<SandboxConfig> {
+  static void mapping(llvm::yaml::IO &io, SandboxConfig &config) {
+    io.mapOptional("memoryLimit", config.memoryLimit);
+    io.mapOptional("cpuLimit", config.cpuLimit);
+    io.mapOptional("processLimit", config.processLimit);
+    io.mapOptional("fileSizeLimit", config.fileSizeLimit);
+    io.mapOptional("processGroup", config.processGroup);
+  }
+};
+
 template <> struct llvm::yaml::MappingTraits<DebugConfig> {
   static void mapping(llvm::yaml::IO &io, DebugConfig &config) {
     io.mapOptional("printIR", config.printIR);
@@ -45,14 +64,31 @@ template <> struct llvm::yaml::MappingTraits<Configuration> {
     io.mapOptional("silent", config.silent);
     io.mapOptional("captureTestOutput", config.captureTestOutput);
     io.mapOptional("captureMutantOutput", config.captureMutantOutput);
+    io.mapOptional("mutantOutputLimit", config.mutantOutputLimit);
+    io.mapOptional("mutantOutputDirectory", config.mutantOutputDirectory);
     io.mapOptional("includeNotCovered", config.includeNotCovered);
     io.mapOptional("timeout", config.timeout);
     io.mapOptional("mutators", config.mutators);
     io.mapOptional("ignoreMutators", config.ignoreMutators);
     io.mapOptional("parallelization", config.parallelization);
+    io.mapOptional("sandbox", config.sandbox);
     io.mapOptional("compilationDatabasePath", config.compilationDatabasePath);
     io.mapOptional("compilerFlags", config.compilerFlags);
     io.mapOptional("junkDetectionDisabled", config.junkDetectionDisabled);
+    io.mapOptional("astCache", config.astCache);
+    io.mapOptional("astCacheSizeLimit", config.astCacheSizeLimit);
+    io.mapOptional("astPrefetch", config.astPrefetch);
+    io.mapOptional("forkServer", config.forkServer);
+    io.mapOptional("splitStream", config.splitStream);
+    io.mapOptional("testFramework", config.testFramework);
+    io.mapOptional("failFast", config.failFast);
+    io.mapOptional("failFastMarkers", config.failFastMarkers);
+    io.mapOptional("prioritizeSurvivors", config.prioritizeSurvivors);
+    io.mapOptional("detectEquivalentMutants", config.detectEquivalentMutants);
+    io.mapOptional("reachabilityProbes", config.reachabilityProbes);
+    io.mapOptional("weakMutation", config.weakMutation);
+    io.mapOptional("mutantSchemata", config.mutantSchemata);
+    io.mapOptional("resultCache", config.resultCache);
     io.mapOptional("gitDiffRef", config.gitDiffRef);
     io.mapOptional("gitProjectRoot", config.gitProjectRoot);
     io.mapOptional("includePaths", config.includePaths);
@@ -0,0 +1,231 @@
+#include "mull/Distributed/Coordinator.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Distributed/Protocol.h"
+#include "mull/MutantPrioritizer.h"
+#include "mull/Parallelization/TaskExecutor.h"
+#include "mull/SourceLocation.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace mull;
+using namespace std::string_literals;
+
+namespace {
+struct Client {
+  explicit Client(int fd) : connection(fd) {}
+
+  Connection connection;
+  /// Handed out, but not reported yet
+  std::unordered_set<std::string> inFlight;
+  std::chrono::steady_clock::time_point lastSeen = std::chrono::steady_clock::now();
+  bool alive = true;
+};
+} // namespace
+
+Coordinator::Coordinator(Diagnostics &diagnostics, std::string address)
+    : diagnostics(diagnostics), address(std::move(address)) {}
+
+void Coordinator::setResultListener(MutationResultListener listener) {
+  resultListener = std::move(listener);
+}
+
+void Coordinator::setPrioritizer(const MutantPrioritizer *prioritizer) {
+  this->prioritizer = prioritizer;
+}
+
+std::vector<std::unique_ptr<MutationResult>>
+Coordinator::run(std::vector<std::unique_ptr<Mutant>> &mutants) {
+  std::vector<std::unique_ptr<MutationResult>> results(mutants.size());
+  std::unordered_map<std::string, std::vector<size_t>> positions;
+  std::deque<std::string> pending;
+  for (size_t i = 0; i < mutants.size(); i++) {
+    Mutant *mutant = mutants[i].get();
+    if (!mutant->isCovered()) {
+      ExecutionResult result;
+      result.status = NotCovered;
+      if (resultListener) {
+        resultListener(*mutant, result);
+      }
+      results[i] = std::make_unique<MutationResult>(result, mutant);
+      continue;
+    }
+    auto &mutantPositions = positions[mutant->getIdentifier()];
+    if (mutantPositions.empty()) {
+      pending.push_back(mutant->getIdentifier());
+    }
+    mutantPositions.push_back(i);
+  }
+
+  size_t remaining = positions.size();
+  if (remaining == 0) {
+    return results;
+  }
+  if (prioritizer) {
+    std::unordered_map<std::string, double> chances;
+    for (auto &identifier : pending) {
+      chances[identifier] = prioritizer->survivalChance(*mutants[positions[identifier].front()]);
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&](const auto &lhs, const auto &rhs) {
+      return chances[lhs] > chances[rhs];
+    });
+  }
+
+  int listener = listenOn(diagnostics, address);
+  if (listener == -1) {
+    diagnostics.error("Cannot start the coordinator on "s + address);
+  }
+  diagnostics.info("Waiting for workers on "s + address);
+
+  std::vector<std::unique_ptr<Client>> clients;
+  std::unordered_set<std::string> done;
+
+  auto record = [&](Client &client, protocol::Message &message) {
+    const std::string &identifier = message.identifiers.front();
+    client.inFlight.erase(identifier);
+    auto found = positions.find(identifier);
+    if (found == positions.end() || done.count(identifier)) {
+      diagnostics.warning("Unexpected result from a worker: "s + identifier);
+      return;
+    }
+    if (message.result.status == Invalid) {
+      diagnostics.warning("Worker could not run "s + identifier +
+                          ", are the coordinator and the workers running the same program?");
+    }
+    for (size_t position : found->second) {
+      if (resultListener) {
+        resultListener(*mutants[position], message.result);
+      }
+      results[position] = std::make_unique<MutationResult>(message.result, mutants[position].get());
+    }
+    done.insert(identifier);
+    remaining--;
+
+    std::stringstream debugMessage;
+    SourceLocation sourceLocation = mutants[found->second.front()]->getSourceLocation();
+    debugMessage << sourceLocation.filePath << ":" << sourceLocation.line << ":"
+                 << sourceLocation.column << " ExecutionResult: "
+                 << message.result.getStatusAsString();
+    diagnostics.debug(debugMessage.str());
+  };
+
+  auto handOut = [&](Client &client, size_t count) {
+    std::vector<std::string> identifiers;
+    while (identifiers.size() < count && !pending.empty()) {
+      std::string identifier = std::move(pending.front());
+      pending.pop_front();
+      if (!done.count(identifier)) {
+        client.inFlight.insert(identifier);
+        identifiers.push_back(std::move(identifier));
+      }
+    }
+    if (!identifiers.empty()) {
+      return client.connection.send(protocol::encodeWork(identifiers));
+    }
+    /// Mutants in flight on other workers come back if those workers go away
+    return client.connection.send(remaining ? protocol::encodeWait() : protocol::encodeDone());
+  };
+
+  auto disconnect = [&](Client &client) {
+    client.alive = false;
+    for (auto &identifier : client.inFlight) {
+      if (!done.count(identifier)) {
+        pending.push_front(identifier);
+      }
+    }
+    if (!client.inFlight.empty()) {
+      diagnostics.warning("Worker disconnected, re-queuing "s +
+                          std::to_string(client.inFlight.size()) + " mutants");
+    }
+    client.inFlight.clear();
+  };
+
+  SingleTaskExecutor singleTask(diagnostics);
+  singleTask.execute("Running mutants on workers", [&]() {
+    while (remaining > 0) {
+      /// Only workers holding mutants are expected to speak up, see protocol::WorkerHeartbeat
+      auto now = std::chrono::steady_clock::now();
+      int timeout = -1;
+      std::vector<pollfd> descriptors{ { listener, POLLIN, 0 } };
+      for (auto &client : clients) {
+        descriptors.push_back({ client->connection.getFD(), POLLIN, 0 });
+        if (!client->inFlight.empty()) {
+          auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+              client->lastSeen + protocol::WorkerSilenceLimit - now);
+          int clientTimeout = int(std::max<long long>(left.count(), 0) + 1);
+          timeout = timeout == -1 ? clientTimeout : std::min(timeout, clientTimeout);
+        }
+      }
+      if (poll(descriptors.data(), descriptors.size(), timeout) < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        diagnostics.error("Coordinator cannot wait for workers: "s + strerror(errno));
+      }
+
+      for (size_t i = 0; i < clients.size(); i++) {
+        Client &client = *clients[i];
+        if ((descriptors[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+          if (!client.inFlight.empty() &&
+              std::chrono::steady_clock::now() - client.lastSeen >= protocol::WorkerSilenceLimit) {
+            diagnostics.warning("Worker went silent, dropping it");
+            disconnect(client);
+          }
+          continue;
+        }
+        if (!client.connection.receiveAvailable()) {
+          disconnect(client);
+          continue;
+        }
+        client.lastSeen = std::chrono::steady_clock::now();
+        bool malformed = false;
+        while (auto message = client.connection.next(malformed)) {
+          bool sent = true;
+          if (message->kind == protocol::MessageKind::Request) {
+            sent = handOut(client, message->count);
+          } else if (message->kind == protocol::MessageKind::Result) {
+            record(client, *message);
+          }
+          if (!sent) {
+            disconnect(client);
+            break;
+          }
+        }
+        if (malformed && client.alive) {
+          diagnostics.warning("Malformed message from a worker, dropping it");
+          disconnect(client);
+        }
+      }
+      clients.erase(std::remove_if(clients.begin(),
+                                   clients.end(),
+                                   [](const auto &client) { return !client->alive; }),
+                    clients.end());
+
+      if (descriptors[0].revents & POLLIN) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd != -1) {
+          clients.push_back(std::make_unique<Client>(fd));
+        }
+      }
+    }
+  });
+
+  for (auto &client : clients) {
+    client->connection.send(protocol::encodeDone());
+  }
+  close(listener);
+  if (address.compare(0, 5, "unix:") == 0) {
+    unlink(address.substr(5).c_str());
+  }
+  return results;
+}
@@ -0,0 +1,315 @@
+#include "mull/Distributed/Protocol.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <netdb.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace mull;
+using namespace mull::protocol;
+using namespace std::string_literals;
+
+static const char *UnixPrefix = "unix:";
+
+std::string protocol::encodeRequest(size_t count) {
+  return "GET " + std::to_string(count) + "\n";
+}
+
+std::string protocol::encodeWork(const std::vector<std::string> &identifiers) {
+  std::string header = "WORK " + std::to_string(identifiers.size());
+  std::string payload;
+  for (auto &identifier : identifiers) {
+    header += " " + std::to_string(identifier.size());
+    payload += identifier;
+  }
+  return header + "\n" + payload;
+}
+
+std::string protocol::encodeWait() {
+  return "WAIT\n";
+}
+
+std::string protocol::encodeDone() {
+  return "DONE\n";
+}
+
+std::string protocol::encodeAlive() {
+  return "ALIVE\n";
+}
+
+std::string protocol::encodeResult(const std::string &identifier, const ExecutionResult &result) {
+  std::stringstream message;
+  message << "RESULT " << identifier.size() << " " << int(result.status) << " "
+          << result.exitStatus << " " << result.runningTime << " " << result.cpuTime << " "
+          << result.stdoutOutput.size() << " " << result.stderrOutput.size() << "\n"
+          << identifier << result.stdoutOutput << result.stderrOutput;
+  return message.str();
+}
+
+std::optional<Message> protocol::decodeMessage(std::string &buffer, bool &malformed) {
+  malformed = false;
+  size_t newline = buffer.find('\n');
+  if (newline == std::string::npos) {
+    return std::nullopt;
+  }
+  std::stringstream header(buffer.substr(0, newline));
+  std::string kind;
+  header >> kind;
+
+  Message message;
+  std::vector<size_t> payloads;
+  if (kind == "GET") {
+    message.kind = MessageKind::Request;
+    header >> message.count;
+  } else if (kind == "WAIT") {
+    message.kind = MessageKind::Wait;
+  } else if (kind == "DONE") {
+    message.kind = MessageKind::Done;
+  } else if (kind == "ALIVE") {
+    message.kind = MessageKind::Alive;
+  } else if (kind == "WORK") {
+    message.kind = MessageKind::Work;
+    header >> message.count;
+    for (size_t i = 0; i < message.count && header; i++) {
+      size_t length = 0;
+      header >> length;
+      payloads.push_back(length);
+    }
+  } else if (kind == "RESULT") {
+    message.kind = MessageKind::Result;
+    int status = 0;
+    size_t identifierLength = 0, stdoutLength = 0, stderrLength = 0;
+    header >> identifierLength >> status >> message.result.exitStatus >>
+        message.result.runningTime >> message.result.cpuTime >> stdoutLength >> stderrLength;
+    message.result.status = ExecutionStatus(status);
+    payloads = { identifierLength, stdoutLength, stderrLength };
+  } else {
+    malformed = true;
+    return std::nullopt;
+  }
+  if (header.fail()) {
+    malformed = true;
+    return std::nullopt;
+  }
+
+  size_t size = newline + 1;
+  for (size_t length : payloads) {
+    size += length;
+  }
+  if (buffer.size() < size) {
+    return std::nullopt;
+  }
+  std::vector<std::string> strings;
+  size_t offset = newline + 1;
+  for (size_t length : payloads) {
+    strings.push_back(buffer.substr(offset, length));
+    offset += length;
+  }
+  buffer.erase(0, size);
+
+  if (message.kind == MessageKind::Work) {
+    message.identifiers = std::move(strings);
+  } else if (message.kind == MessageKind::Result) {
+    message.identifiers = { std::move(strings[0]) };
+    message.result.stdoutOutput = std::move(strings[1]);
+    message.result.stderrOutput = std::move(strings[2]);
+  }
+  return message;
+}
+
+static bool hasUnixPrefix(const std::string &address) {
+  return address.compare(0, strlen(UnixPrefix), UnixPrefix) == 0;
+}
+
+static bool unixAddress(const std::string &address, sockaddr_un &socketAddress) {
+  std::string path = address.substr(strlen(UnixPrefix));
+  if (path.empty() || path.size() >= sizeof(socketAddress.sun_path)) {
+    return false;
+  }
+  memset(&socketAddress, 0, sizeof(socketAddress));
+  socketAddress.sun_family = AF_UNIX;
+  strncpy(socketAddress.sun_path, path.c_str(), sizeof(socketAddress.sun_path) - 1);
+  return true;
+}
+
+/// <host>:<port>, an omitted host is the loopback interface: anyone reaching the coordinator can
+/// read the results and feed it fake ones, it must not face untrusted networks
+static addrinfo *tcpAddress(const std::string &address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    return nullptr;
+  }
+  std::string host = address.substr(0, colon);
+  std::string port = address.substr(colon + 1);
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *result = nullptr;
+  if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0) {
+    return nullptr;
+  }
+  return result;
+}
+
+int mull::listenOn(Diagnostics &diagnostics, const std::string &address) {
+  /// Workers going away must not take the coordinator down
+  signal(SIGPIPE, SIG_IGN);
+  int fd = -1;
+  if (hasUnixPrefix(address)) {
+    sockaddr_un socketAddress{};
+    if (!unixAddress(address, socketAddress)) {
+      diagnostics.warning("Invalid address: "s + address);
+      return -1;
+    }
+    unlink(socketAddress.sun_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd != -1 &&
+        bind(fd, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress)) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  } else {
+    addrinfo *addresses = tcpAddress(address);
+    if (!addresses) {
+      diagnostics.warning("Invalid address: "s + address);
+      return -1;
+    }
+    for (addrinfo *info = addresses; info && fd == -1; info = info->ai_next) {
+      fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      if (fd == -1) {
+        continue;
+      }
+      int reuse = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+      if (bind(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+  }
+  if (fd == -1 || listen(fd, SOMAXCONN) != 0) {
+    diagnostics.warning("Cannot listen on "s + address + ": " + strerror(errno));
+    if (fd != -1) {
+      close(fd);
+    }
+    return -1;
+  }
+  return fd;
+}
+
+Connection::Connection(int fd) : fd(fd) {}
+
+Connection::Connection(Connection &&other) noexcept
+    : fd(other.fd), buffer(std::move(other.buffer)) {
+  other.fd = -1;
+}
+
+Connection &Connection::operator=(Connection &&other) noexcept {
+  if (this != &other) {
+    if (fd != -1) {
+      close(fd);
+    }
+    fd = other.fd;
+    buffer = std::move(other.buffer);
+    other.fd = -1;
+  }
+  return *this;
+}
+
+Connection::~Connection() {
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+std::optional<Connection> Connection::connect(Diagnostics &diagnostics,
+                                              const std::string &address) {
+  signal(SIGPIPE, SIG_IGN);
+  int fd = -1;
+  if (hasUnixPrefix(address)) {
+    sockaddr_un socketAddress{};
+    if (!unixAddress(address, socketAddress)) {
+      diagnostics.warning("Invalid address: "s + address);
+      return std::nullopt;
+    }
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd != -1 &&
+        ::connect(fd, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress)) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  } else {
+    addrinfo *addresses = tcpAddress(address);
+    if (!addresses) {
+      diagnostics.warning("Invalid address: "s + address);
+      return std::nullopt;
+    }
+    for (addrinfo *info = addresses; info && fd == -1; info = info->ai_next) {
+      fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      if (fd != -1 && ::connect(fd, info->ai_addr, info->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+  }
+  if (fd == -1) {
+    return std::nullopt;
+  }
+  return Connection(fd);
+}
+
+int Connection::getFD() const {
+  return fd;
+}
+
+bool Connection::send(const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t count = write(fd, data.data() + written, data.size() - written);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    written += count;
+  }
+  return true;
+}
+
+bool Connection::receiveAvailable() {
+  char chunk[4096];
+  ssize_t count;
+  do {
+    count = read(fd, chunk, sizeof(chunk));
+  } while (count < 0 && errno == EINTR);
+  if (count <= 0) {
+    return false;
+  }
+  buffer.append(chunk, count);
+  return true;
+}
+
+std::optional<protocol::Message> Connection::next(bool &malformed) {
+  return decodeMessage(buffer, malformed);
+}
+
+std::optional<protocol::Message> Connection::receive() {
+  while (true) {
+    bool malformed = false;
+    if (auto message = next(malformed)) {
+      return message;
+    }
+    if (malformed || !receiveAvailable()) {
+      return std::nullopt;
+    }
+  }
+}
@@ -0,0 +1,115 @@
+#include "mull/Distributed/Worker.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Distributed/Protocol.h"
+#include "mull/MutantRunner.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace mull;
+using namespace std::string_literals;
+
+/// Workers may well be started before the coordinator is done preparing its mutants
+static const int ConnectAttempts = 120;
+static const std::chrono::milliseconds RetryInterval(500);
+
+Worker::Worker(Diagnostics &diagnostics, std::string address, unsigned batchSize)
+    : diagnostics(diagnostics), address(std::move(address)), batchSize(batchSize) {}
+
+bool Worker::run(MutantRunner &runner, const std::string &executable,
+                 const std::vector<std::string> &extraArgs,
+                 std::vector<std::unique_ptr<Mutant>> &mutants) {
+  /// Results against a failing baseline would be meaningless, as in a local run
+  ExecutionResult baseline = runner.runBaseline(executable, extraArgs);
+  if (baseline.status != Passed) {
+    diagnostics.error("The baseline run failed: "s + baseline.debugDescription());
+  }
+
+  std::optional<Connection> connection;
+  for (int attempt = 0; attempt < ConnectAttempts && !connection; attempt++) {
+    if (attempt != 0) {
+      std::this_thread::sleep_for(RetryInterval);
+    }
+    connection = Connection::connect(diagnostics, address);
+  }
+  if (!connection) {
+    diagnostics.warning("Cannot connect to the coordinator at "s + address);
+    return false;
+  }
+
+  std::unordered_map<std::string, size_t> positions;
+  for (size_t i = 0; i < mutants.size(); i++) {
+    positions.emplace(mutants[i]->getIdentifier(), i);
+  }
+
+  /// Results go out as the mutants finish, the heartbeat covers the long ones. Both come from
+  /// other threads than this one.
+  std::mutex sending;
+  std::atomic<bool> sent(true);
+  auto send = [&](const std::string &data) {
+    std::lock_guard<std::mutex> guard(sending);
+    if (!connection->send(data)) {
+      sent = false;
+    }
+  };
+  runner.setResultListener([&](const Mutant &mutant, const ExecutionResult &result) {
+    send(protocol::encodeResult(mutant.getIdentifier(), result));
+  });
+
+  while (connection->send(protocol::encodeRequest(batchSize))) {
+    auto message = connection->receive();
+    if (!message || message->kind == protocol::MessageKind::Done) {
+      break;
+    }
+    if (message->kind == protocol::MessageKind::Wait) {
+      std::this_thread::sleep_for(RetryInterval);
+      continue;
+    }
+    if (message->kind != protocol::MessageKind::Work) {
+      continue;
+    }
+
+    std::vector<std::unique_ptr<Mutant>> batch;
+    std::vector<size_t> batchPositions;
+    for (auto &identifier : message->identifiers) {
+      auto found = positions.find(identifier);
+      if (found == positions.end() || !mutants[found->second]) {
+        /// Reported as Invalid, the coordinator then knows the programs differ
+        send(protocol::encodeResult(identifier, ExecutionResult()));
+        continue;
+      }
+      batch.push_back(std::move(mutants[found->second]));
+      batchPositions.push_back(found->second);
+    }
+
+    std::mutex waiting;
+    std::condition_variable finished;
+    bool batchDone = false;
+    std::thread heartbeat([&]() {
+      std::unique_lock<std::mutex> lock(waiting);
+      while (!finished.wait_for(lock, protocol::WorkerHeartbeat, [&]() { return batchDone; })) {
+        send(protocol::encodeAlive());
+      }
+    });
+    runner.runMutants(executable, extraArgs, baseline, batch);
+    {
+      std::lock_guard<std::mutex> lock(waiting);
+      batchDone = true;
+    }
+    finished.notify_one();
+    heartbeat.join();
+    for (size_t i = 0; i < batch.size(); i++) {
+      mutants[batchPositions[i]] = std::move(batch[i]);
+    }
+    if (!sent) {
+      break;
+    }
+  }
+  runner.setResultListener({});
+  return true;
+}
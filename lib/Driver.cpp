@@ -9,16 +9,23 @@
 #include "mull/FunctionUnderTest.h"
 #include "mull/JunkDetection/CXX/ASTStorage.h"
 #include "mull/JunkDetection/CXX/CXXJunkDetector.h"
+#include "mull/JunkDetection/CXX/MutationSites.h"
 #include "mull/MutationsFinder.h"
+#include "mull/MutantManifest.h"
 #include "mull/Mutators/MutatorsFactory.h"
 #include "mull/Parallelization/Parallelization.h"
 #include "mull/Program/Program.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/TrivialCompilerEquivalence.h"
+#include "mull/WeakMutation.h"
 
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/FileSystem.h>
 
 #include <algorithm>
+#include <iterator>
+#include <memory>
 #include <sstream>
 #include <unordered_map>
 #include <vector>
@@ -90,14 +97,26 @@ void mull::mutateBitcode(llvm::Module &module) {
     diagnostics.info(std::string("Found compilation flags in the input bitcode"));
   }
 
-  mull::ASTStorage astStorage(diagnostics,
-                              configuration.compilationDatabasePath,
-                              cxxCompilationFlags,
-                              bitcodeCompilationFlags);
-
-  mull::CXXJunkDetector junkDetector(diagnostics, astStorage);
+  /// Sites recorded at compile time spare parsing the sources again
+  bool recordedSites = mull::hasMutationSites(module);
+  std::unique_ptr<mull::ASTStorage> astStorage;
+  std::unique_ptr<mull::JunkDetector> junkDetector;
+  if (recordedSites) {
+    diagnostics.info(std::string("Found mutation sites in the input bitcode"));
+    junkDetector = std::make_unique<mull::RecordedSitesJunkDetector>(diagnostics, module);
+  } else {
+    astStorage = std::make_unique<mull::ASTStorage>(diagnostics,
+                                                    configuration.compilationDatabasePath,
+                                                    cxxCompilationFlags,
+                                                    bitcodeCompilationFlags);
+    if (!configuration.astCache.empty()) {
+      astStorage->enableCache(configuration.astCache,
+                              uint64_t(configuration.astCacheSizeLimit) * 1024 * 1024);
+    }
+    junkDetector = std::make_unique<mull::CXXJunkDetector>(diagnostics, *astStorage);
+  }
   if (!configuration.junkDetectionDisabled) {
-    auto *junkFilter = new mull::JunkMutationFilter(junkDetector);
+    auto *junkFilter = new mull::JunkMutationFilter(*junkDetector);
     filters.mutationFilters.push_back(junkFilter);
     filterStorage.emplace_back(junkFilter);
   }
@@ -112,7 +131,7 @@ void mull::mutateBitcode(llvm::Module &module) {
     diagnostics.warning("Mull cannot find debug information. Recompile with `-g` flag.");
   }
 
-  if (bitcodeCompilationFlags.empty()) {
+  if (bitcodeCompilationFlags.empty() && !recordedSites) {
     diagnostics.warning(
         "Mull cannot find compiler flags. Recompile with `-grecord-command-line` flag.");
   }
@@ -180,6 +199,10 @@ void mull::mutateBitcode(llvm::Module &module) {
       mutationsFinder.getMutationPoints(diagnostics, filteredFunctions);
   std::vector<MutationPoint *> mutations = std::move(mutationPoints);
 
+  if (astStorage && configuration.astPrefetch && !configuration.junkDetectionDisabled) {
+    astStorage->prefetch(mutations, configuration.parallelization.workers);
+  }
+
   for (auto filter : filters.mutationFilters) {
     std::vector<MutationFilterTask> tasks;
     tasks.reserve(configuration.parallelization.workers);
@@ -194,6 +217,9 @@ void mull::mutateBitcode(llvm::Module &module) {
     filterRunner.execute();
     mutations = std::move(tmp);
   }
+  if (astStorage) {
+    astStorage->storeVerdicts();
+  }
 
   singleTask.execute("Prepare mutations", [&]() {
     for (auto point : mutations) {
@@ -201,8 +227,9 @@ void mull::mutateBitcode(llvm::Module &module) {
     }
   });
 
-  singleTask.execute("Cloning functions for mutation",
-                     [&]() { CloneMutatedFunctionsTask::cloneFunctions(bitcode); });
+  singleTask.execute("Cloning functions for mutation", [&]() {
+    CloneMutatedFunctionsTask::cloneFunctions(bitcode, configuration.mutantSchemata);
+  });
 
   singleTask.execute("Removing original functions",
                      [&]() { DeleteOriginalFunctionsTask::deleteFunctions(bitcode); });
@@ -211,12 +238,98 @@ void mull::mutateBitcode(llvm::Module &module) {
     InsertMutationTrampolinesTask::insertTrampolines(bitcode, configuration);
   });
 
+  if (configuration.forkServer && !bitcode.getMutationPointsMap().empty()) {
+    singleTask.execute("Inserting fork server", [&]() { runtime::insertForkServer(module); });
+  }
+
+  /// Mutants of a schema are applied all at once, by function
+  std::vector<MutationPoint *> clonedMutations;
+  std::copy_if(mutations.begin(),
+               mutations.end(),
+               std::back_inserter(clonedMutations),
+               [&](MutationPoint *point) {
+                 return !bitcode.hasMutantSchema(point->getOriginalFunction());
+               });
   TaskExecutor<ApplyMutationTask> applyMutations(diagnostics,
                                                  "Applying mutations",
-                                                 mutations,
+                                                 clonedMutations,
                                                  Nothing,
                                                  { ApplyMutationTask(configuration, diagnostics) });
   applyMutations.execute();
+  if (clonedMutations.size() != mutations.size()) {
+    singleTask.execute("Applying mutant schemata",
+                       [&]() { ApplyMutantSchemataTask::applySchemata(bitcode); });
+  }
+
+  singleTask.execute("Recording mutants", [&]() {
+    MutantManifestWriter manifest;
+    for (auto point : mutations) {
+      point->recordMutation(manifest);
+    }
+    recordMutantManifest(module, manifest);
+  });
+
+  if (configuration.detectEquivalentMutants && !bitcode.getMutationPointsMap().empty()) {
+    Equivalences equivalences;
+    singleTask.execute("Detecting equivalent mutants", [&]() {
+      equivalences = findEquivalentMutants(bitcode);
+      recordEquivalences(module, equivalences);
+    });
+    size_t equivalent = std::count_if(equivalences.begin(), equivalences.end(), [](auto &pair) {
+      return pair.second.empty();
+    });
+    std::stringstream message;
+    message << "Equivalent mutants: " << equivalent
+            << ", duplicate mutants: " << equivalences.size() - equivalent;
+    diagnostics.info(message.str());
+  }
+
+  /// After the equivalences: probes would make every mutant differ from the original. Probes
+  /// shift the instructions the mutation points address, all of them are looked up first.
+  std::vector<std::pair<llvm::Instruction *, std::string>> reachabilityProbes;
+  std::vector<runtime::WeakMutationProbe> weakMutationProbes;
+  size_t schemaMutants = 0;
+  if ((configuration.reachabilityProbes || configuration.weakMutation) &&
+      !bitcode.getMutationPointsMap().empty()) {
+    singleTask.execute("Preparing probes", [&]() {
+      for (auto &point : mutations) {
+        auto *original = llvm::cast<llvm::Instruction>(point->getOriginalValue());
+        if (configuration.reachabilityProbes) {
+          reachabilityProbes.emplace_back(original, point->getUserIdentifier());
+        }
+        if (!configuration.weakMutation) {
+          continue;
+        }
+        /// Weak mutation compares the original function with the mutant's own copy
+        if (bitcode.hasMutantSchema(point->getOriginalFunction())) {
+          schemaMutants++;
+        } else if (llvm::Instruction *mutated = createWeakMutation(*point)) {
+          weakMutationProbes.push_back({ original, mutated, point->getUserIdentifier() });
+        }
+      }
+    });
+  }
+  if (schemaMutants) {
+    std::stringstream message;
+    message << "Weak mutation: " << schemaMutants
+            << " mutants in schemata have no copy of their own and always run "
+               "(mutantSchemata: true)";
+    diagnostics.warning(message.str());
+  }
+  if (!reachabilityProbes.empty()) {
+    singleTask.execute("Inserting reachability probes", [&]() {
+      runtime::insertReachabilityProbes(module, reachabilityProbes);
+    });
+  }
+  if (!weakMutationProbes.empty()) {
+    std::stringstream message;
+    message << "Weak mutation: " << weakMutationProbes.size() << " of " << mutations.size()
+            << " mutants can be evaluated in the unmutated code";
+    diagnostics.info(message.str());
+    singleTask.execute("Inserting weak mutation probes", [&]() {
+      runtime::insertWeakMutationProbes(module, weakMutationProbes);
+    });
+  }
 
   if (configuration.debug.printIR || configuration.debug.printIRAfter) {
     printIR(module, diagnostics, configuration.debug.printIRToFile, ".after.ll");
@@ -0,0 +1,29 @@
+#include "mull/FailureMarkers.h"
+
+#include <algorithm>
+
+using namespace mull;
+
+FailureMarkers::FailureMarkers(const std::vector<std::string> &markers)
+    : markers(markers), longestMarker(0) {
+  for (auto &marker : markers) {
+    longestMarker = std::max(longestMarker, marker.size());
+  }
+}
+
+bool FailureMarkers::scan(const char *chunk, size_t size) {
+  if (longestMarker == 0) {
+    return false;
+  }
+  /// Keep the end of the previous chunk: a marker can be split between two reads
+  tail.append(chunk, size);
+  for (auto &marker : markers) {
+    if (!marker.empty() && tail.find(marker) != std::string::npos) {
+      return true;
+    }
+  }
+  if (tail.size() >= longestMarker) {
+    tail.erase(0, tail.size() - longestMarker + 1);
+  }
+  return false;
+}
@@ -2,9 +2,14 @@
 #include "mull/Config/Configuration.h"
 #include "mull/Diagnostics/Diagnostics.h"
 #include "mull/Mutant.h"
+#include "mull/Parallelization/TaskExecutor.h"
 #include "mull/Path.h"
 #include <llvm/ProfileData/Coverage/CoverageMapping.h>
 
+#include <algorithm>
+#include <set>
+#include <thread>
+
 #if LLVM_VERSION_MAJOR >= 17
 #include <llvm/Support/VirtualFileSystem.h>
 #endif
@@ -12,19 +17,9 @@
 using namespace mull;
 
 static std::unique_ptr<llvm::coverage::CoverageMapping>
-loadCoverage(const Configuration &configuration, Diagnostics &diagnostics,
-             const std::string &profileName, const std::vector<std::string> &objects) {
-  if (profileName.empty()) {
-    return nullptr;
-  }
-  std::vector<llvm::StringRef> objectFiles;
-  objectFiles.reserve(objects.size());
-  for (auto &object : objects) {
-    objectFiles.emplace_back(object);
-  }
-
+loadObjectCoverage(const std::string &profileName, const std::string &object, std::string &error) {
   llvm::Expected<std::unique_ptr<llvm::coverage::CoverageMapping>> maybeMapping =
-      llvm::coverage::CoverageMapping::load(objectFiles,
+      llvm::coverage::CoverageMapping::load({ llvm::StringRef(object) },
                                             profileName
 #if LLVM_VERSION_MAJOR >= 17
                                             ,
@@ -32,72 +27,168 @@ loadCoverage(const Configuration &configuration, Diagnostics &diagnostics,
 #endif
       );
   if (!maybeMapping) {
-    std::string error;
     llvm::raw_string_ostream os(error);
     llvm::logAllUnhandledErrors(maybeMapping.takeError(), os, "Cannot read coverage info: ");
-    diagnostics.warning(os.str());
+    os.flush();
     return nullptr;
   }
   return std::move(maybeMapping.get());
 }
 
+/// Each object is loaded on its own, in parallel. Empty if any of them cannot be loaded, as when
+/// they were loaded together: partial coverage would hide the executed files of the others.
+static std::vector<std::unique_ptr<llvm::coverage::CoverageMapping>>
+loadCoverage(const Configuration &configuration, Diagnostics &diagnostics,
+             const std::string &profileName, const std::vector<std::string> &objects) {
+  if (profileName.empty() || objects.empty()) {
+    return {};
+  }
+  std::vector<std::unique_ptr<llvm::coverage::CoverageMapping>> mappings(objects.size());
+  std::vector<std::string> errors(objects.size());
+  size_t workers =
+      std::max(1u, std::min<unsigned>(configuration.parallelization.workers, objects.size()));
+  WorkQueue queue(objects.size(), workers);
+  auto load = [&]() {
+    size_t begin = 0;
+    size_t end = 0;
+    while (queue.take(begin, end)) {
+      for (size_t i = begin; i < end; i++) {
+        mappings[i] = loadObjectCoverage(profileName, objects[i], errors[i]);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < workers; i++) {
+    threads.emplace_back(load);
+  }
+  load();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto &error : errors) {
+    if (!error.empty()) {
+      diagnostics.warning(error);
+      return {};
+    }
+  }
+  return mappings;
+}
+
+static uint64_t makePosition(uint64_t line, uint64_t column) {
+  return (line << 32) | (column & 0xffffffff);
+}
+
+size_t CoverageFilter::fileIndex(const std::string &path) {
+  auto found = fileIndices.find(path);
+  if (found != fileIndices.end()) {
+    return found->second;
+  }
+  /// Resolved once per distinct path rather than once per function
+  std::string absolutePath = mull::absoluteFilePath(".", path);
+  auto inserted = fileIndices.emplace(absolutePath, files.size());
+  if (inserted.second) {
+    files.push_back(absolutePath);
+    uncoveredIntervals.emplace_back();
+  }
+  size_t index = inserted.first->second;
+  fileIndices.emplace(path, index);
+  return index;
+}
+
 CoverageFilter::CoverageFilter(const Configuration &configuration, Diagnostics &diagnostics,
                                const std::string &profileName,
                                const std::vector<std::string> &objects)
     : configuration(configuration) {
-  std::unique_ptr<llvm::coverage::CoverageMapping> coverage =
-      loadCoverage(configuration, diagnostics, profileName, objects);
-  if (coverage != nullptr) {
+  auto mappings = loadCoverage(configuration, diagnostics, profileName, objects);
+  std::set<std::string> executed;
+  for (auto &coverage : mappings) {
     for (auto &it : coverage->getCoveredFunctions()) {
-      std::vector<CoverageRange> ranges;
+      if (it.ExecutionCount != 0) {
+        executed.insert(std::begin(it.Filenames), std::end(it.Filenames));
+      }
+      std::vector<Interval> intervals;
       for (auto &region : it.CountedRegions) {
         if (region.ExecutionCount == 0) {
-          ranges.push_back(
-              { region.LineStart, region.ColumnStart, region.LineEnd, region.ColumnEnd });
+          intervals.push_back({ makePosition(region.LineStart, region.ColumnStart),
+                                makePosition(region.LineEnd, region.ColumnEnd) });
         }
       }
       for (auto &path : it.Filenames) {
-        auto absolutePath = mull::absoluteFilePath(".", path);
-        // TODO: merge adjacent ranges
-        std::copy(std::begin(ranges), std::end(ranges), std::back_inserter(uncoveredRanges[path]));
-        std::copy(std::begin(ranges),
-                  std::end(ranges),
-                  std::back_inserter(uncoveredRanges[absolutePath]));
+        auto &fileIntervals = uncoveredIntervals[fileIndex(path)];
+        fileIntervals.insert(std::end(fileIntervals), std::begin(intervals), std::end(intervals));
+      }
+    }
+  }
+  executedFiles.assign(std::begin(executed), std::end(executed));
+  mergeIntervals();
+}
+
+CoverageFilter::CoverageFilter(const Configuration &configuration,
+                               const std::vector<Region> &uncoveredRegions)
+    : configuration(configuration) {
+  for (auto &region : uncoveredRegions) {
+    uncoveredIntervals[fileIndex(region.path)].push_back(
+        { makePosition(region.lineStart, region.columnStart),
+          makePosition(region.lineEnd, region.columnEnd) });
+  }
+  mergeIntervals();
+}
+
+void CoverageFilter::mergeIntervals() {
+  for (auto &intervals : uncoveredIntervals) {
+    std::sort(intervals.begin(), intervals.end(), [](const Interval &lhs, const Interval &rhs) {
+      return lhs.begin < rhs.begin;
+    });
+    std::vector<Interval> merged;
+    for (auto &interval : intervals) {
+      /// Overlapping (nested regions, functions present in several objects) or adjacent
+      if (!merged.empty() && interval.begin <= merged.back().end + 1) {
+        merged.back().end = std::max(merged.back().end, interval.end);
+      } else {
+        merged.push_back(interval);
       }
     }
+    merged.shrink_to_fit();
+    intervals = std::move(merged);
   }
 
   if (configuration.debug.coverage) {
-    for (auto &pair : uncoveredRanges) {
-      for (auto &range : pair.second) {
-        llvm::errs() << "mull-coverage: " << pair.first << ":" << range.lineBegin << ":"
-                     << range.columnBegin << ":" << range.lineEnd << ":" << range.columnEnd << "\n";
+    for (size_t i = 0; i < files.size(); i++) {
+      for (auto &interval : uncoveredIntervals[i]) {
+        llvm::errs() << "mull-coverage: " << files[i] << ":" << (interval.begin >> 32) << ":"
+                     << (interval.begin & 0xffffffff) << ":" << (interval.end >> 32) << ":"
+                     << (interval.end & 0xffffffff) << "\n";
       }
     }
   }
 }
 
 bool CoverageFilter::covered(Mutant *mutant) {
-  // TODO: optimize lookup
   assert(mutant);
-  if (uncoveredRanges.empty()) {
+  if (files.empty()) {
     return true;
   }
   auto &location = mutant->getSourceLocation();
-  auto &path = location.filePath;
-  if (!uncoveredRanges.count(path)) {
+  auto found = fileIndices.find(location.filePath);
+  if (found == fileIndices.end()) {
     return true;
   }
-  for (auto &range : uncoveredRanges.at(path)) {
-    bool more = (location.line > range.lineBegin) ||
-                (location.line == range.lineBegin && location.column >= range.columnBegin);
-    bool less = (location.line < range.lineEnd) ||
-                (location.line == range.lineEnd && location.column <= range.columnEnd);
-    if (more && less) {
-      return false;
-    }
+  auto &intervals = uncoveredIntervals[found->second];
+  Position position = makePosition(location.line, location.column);
+  /// The last interval starting at or before the mutant is the only one that can contain it
+  auto after = std::upper_bound(
+      intervals.begin(), intervals.end(), position, [](Position position, const Interval &interval) {
+        return position < interval.begin;
+      });
+  if (after == intervals.begin()) {
+    return true;
   }
-  return true;
+  return position > std::prev(after)->end;
+}
+
+const std::vector<std::string> &CoverageFilter::getExecutedFiles() const {
+  return executedFiles;
 }
 
 bool CoverageFilter::shouldSkip(Mutant *mutant) {
@@ -7,6 +7,7 @@
 #include "mull/Filters/GitDiffFilter.h"
 #include "mull/Filters/ManualFilter.h"
 #include "mull/Filters/NoDebugInfoFilter.h"
+#include "mull/Filters/ReachabilityFilter.h"
 #include "mull/Filters/VariadicFunctionFilter.h"
 #include <llvm/Support/FileSystem.h>
 #include <sstream>
@@ -116,6 +117,13 @@ CoverageFilter *Filters::enableCoverageFilter(const std::string &profileName,
   return filter;
 }
 
+ReachabilityFilter *Filters::enableReachabilityFilter(const std::string &path) {
+  auto filter = new ReachabilityFilter(configuration, diagnostics, path);
+  storage.emplace_back(filter);
+  mutantFilters.push_back(filter);
+  return filter;
+}
+
 void Filters::enableBlockAddressFilter() {
   auto filter = new mull::BlockAddressFunctionFilter;
   storage.emplace_back(filter);
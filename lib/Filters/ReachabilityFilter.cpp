@@ -0,0 +1,41 @@
+#include "mull/Filters/ReachabilityFilter.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Mutant.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+using namespace mull;
+
+ReachabilityFilter::ReachabilityFilter(const Configuration &configuration,
+                                       Diagnostics &diagnostics, const std::string &path)
+    : configuration(configuration) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    /// Nothing ran, or the program died before its destructors
+    diagnostics.warning("Cannot read reachability info from " + path + ": " +
+                        buffer.getError().message());
+    return;
+  }
+  llvm::StringRef content = buffer.get()->getBuffer();
+  while (!content.empty()) {
+    auto [line, rest] = content.split('\n');
+    if (!line.empty()) {
+      reachedMutants.insert(line.str());
+    }
+    content = rest;
+  }
+}
+
+bool ReachabilityFilter::reached(Mutant *mutant) const {
+  return reachedMutants.count(mutant->getIdentifier()) != 0;
+}
+
+bool ReachabilityFilter::shouldSkip(Mutant *mutant) {
+  return !reached(mutant) && !configuration.includeNotCovered;
+}
+
+std::string ReachabilityFilter::name() {
+  return "reachability";
+}
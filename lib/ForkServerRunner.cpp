@@ -0,0 +1,465 @@
+#include "mull/ForkServerRunner.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/FailureMarkers.h"
+#include "mull/OutputCapture.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/Sandbox.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+using namespace mull;
+using namespace std::string_literals;
+using Clock = std::chrono::steady_clock;
+
+/// How often the mutant's CPU time is sampled
+static const int CPUPollIntervalMilliseconds = 10;
+
+namespace {
+/// FailureSeen: the output just showed one of the failure markers, nothing of the word is read
+enum class ReadStatus { Done, TimedOut, Closed, FailureSeen };
+
+/// Where the program's output goes while mull-runner waits on the status pipe
+struct OutputSinks {
+  OutputCapture *out = nullptr;
+  OutputCapture *err = nullptr;
+  std::optional<FailureMarkers> outMarkers;
+  std::optional<FailureMarkers> errMarkers;
+  bool failureSeen = false;
+};
+} // namespace
+
+static void closeFD(int &fd) {
+  if (fd != -1) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+/// The test program finds the server's pipes at fixed descriptors. mull-runner may already use
+/// those for something else, including the other end of the pipes: dup2 would close it. The
+/// ends are moved past them first.
+static bool moveAboveForkServerFDs(int &fd) {
+  int lowest = std::max(runtime::ForkServerControlFD, runtime::ForkServerStatusFD) + 1;
+  if (fd >= lowest) {
+    return true;
+  }
+  int moved = fcntl(fd, F_DUPFD_CLOEXEC, lowest);
+  if (moved == -1) {
+    return false;
+  }
+  close(fd);
+  fd = moved;
+  return true;
+}
+
+/// Returns true if the output showed a failure marker for the first time
+static bool readOutput(pollfd &descriptor, OutputCapture *sink,
+                       std::optional<FailureMarkers> &markers, bool &failureSeen) {
+  if (descriptor.fd == -1 || (descriptor.revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+    return false;
+  }
+  char buffer[4096];
+  ssize_t bytes = read(descriptor.fd, buffer, sizeof(buffer));
+  if (bytes <= 0) {
+    descriptor.fd = -1;
+    return false;
+  }
+  if (sink) {
+    sink->append(buffer, bytes);
+  }
+  if (failureSeen || !markers || !markers->scan(buffer, bytes)) {
+    return false;
+  }
+  failureSeen = true;
+  return true;
+}
+
+/// Reads a 4-byte word from the status descriptor, draining the program's output meanwhile:
+/// otherwise a chatty child blocks on a full pipe and never finishes
+static ReadStatus readWord(int statusFD, int32_t &word, std::optional<Clock::time_point> deadline,
+                           int stdoutFD, int stderrFD, OutputSinks &sinks) {
+  pollfd descriptors[3] = { { statusFD, POLLIN, 0 }, { stdoutFD, POLLIN, 0 }, { stderrFD, POLLIN, 0 } };
+  auto bytes = reinterpret_cast<char *>(&word);
+  size_t offset = 0;
+  while (offset < sizeof(word)) {
+    int timeout = -1;
+    if (deadline) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(*deadline - Clock::now());
+      timeout = std::max(0, int(left.count()));
+    }
+    int ready = poll(descriptors, 3, timeout);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ReadStatus::Closed;
+    }
+    if (ready == 0) {
+      return ReadStatus::TimedOut;
+    }
+    bool failed = readOutput(descriptors[1], sinks.out, sinks.outMarkers, sinks.failureSeen);
+    failed |= readOutput(descriptors[2], sinks.err, sinks.errMarkers, sinks.failureSeen);
+    if (descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+      ssize_t count = read(statusFD, bytes + offset, sizeof(word) - offset);
+      if (count <= 0) {
+        return ReadStatus::Closed;
+      }
+      offset += count;
+    }
+    if (failed && offset == 0) {
+      return ReadStatus::FailureSeen;
+    }
+  }
+  return ReadStatus::Done;
+}
+
+/// Everything the child has written is already in the pipes once its status is known
+static void drainOutput(int stdoutFD, int stderrFD, OutputSinks &sinks) {
+  pollfd descriptors[2] = { { stdoutFD, POLLIN, 0 }, { stderrFD, POLLIN, 0 } };
+  while (poll(descriptors, 2, 0) > 0) {
+    readOutput(descriptors[0], sinks.out, sinks.outMarkers, sinks.failureSeen);
+    readOutput(descriptors[1], sinks.err, sinks.errMarkers, sinks.failureSeen);
+    if (descriptors[0].fd == -1 && descriptors[1].fd == -1) {
+      break;
+    }
+  }
+}
+
+ForkServerRunner::ForkServerRunner(Diagnostics &diagnostics)
+    : diagnostics(diagnostics), serverPid(-1), controlFD(-1), statusFD(-1), stdoutFD(-1),
+      stderrFD(-1) {}
+
+ForkServerRunner::~ForkServerRunner() {
+  stop();
+}
+
+bool ForkServerRunner::start(const std::string &program, const std::vector<std::string> &arguments,
+                             const std::unordered_map<std::string, std::string> &environment,
+                             const SandboxConfig &resources, long long int timeout,
+                             bool captureOutput) {
+  std::unordered_map<std::string, std::string> serverEnvironment(environment);
+  serverEnvironment[runtime::ForkServerEnvironmentVariable] = "1";
+  /// The server itself runs unmutated whatever mull-runner inherited
+  serverEnvironment[runtime::MutantEnvironmentVariable] = "";
+  if (!launch(program, arguments, serverEnvironment, resources, captureOutput)) {
+    return false;
+  }
+
+  int32_t hello = 0;
+  OutputSinks discard;
+  ReadStatus readStatus = readWord(statusFD,
+                                   hello,
+                                   Clock::now() + std::chrono::milliseconds(timeout),
+                                   stdoutFD,
+                                   stderrFD,
+                                   discard);
+  if (readStatus != ReadStatus::Done || uint32_t(hello) != runtime::ForkServerHello) {
+    diagnostics.warning("The fork server did not respond: "s + program);
+    stop();
+    return false;
+  }
+  return true;
+}
+
+bool ForkServerRunner::launch(const std::string &program, const std::vector<std::string> &arguments,
+                              const std::unordered_map<std::string, std::string> &environment,
+                              const SandboxConfig &resources, bool captureOutput) {
+  /// Only the dup2'ed copies survive in the test program. Every descriptor the child dup2s
+  /// lives above the fixed ones, so no dup2 can overwrite a source that is still needed.
+  int control[2] = { -1, -1 }, status[2] = { -1, -1 }, out[2] = { -1, -1 },
+      err[2] = { -1, -1 };
+  int input = -1;
+  auto closeAll = [&]() {
+    for (int fd : { control[0], control[1], status[0], status[1], out[0], out[1], err[0],
+                    err[1], input }) {
+      if (fd != -1) {
+        close(fd);
+      }
+    }
+  };
+  if (!createPipe(control) || !createPipe(status) ||
+      (captureOutput && (!createPipe(out) || !createPipe(err)))) {
+    diagnostics.warning("Cannot create pipes for the fork server: "s + strerror(errno));
+    closeAll();
+    return false;
+  }
+  input = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (!captureOutput) {
+    out[1] = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  }
+  if (input == -1 || out[1] == -1 || !moveAboveForkServerFDs(input) ||
+      !moveAboveForkServerFDs(control[0]) || !moveAboveForkServerFDs(status[1]) ||
+      !moveAboveForkServerFDs(out[1]) || (captureOutput && !moveAboveForkServerFDs(err[1]))) {
+    diagnostics.warning("Cannot set up descriptors for the fork server: "s + strerror(errno));
+    closeAll();
+    return false;
+  }
+  if (!captureOutput) {
+    err[1] = out[1];
+  }
+
+  std::vector<std::string> allArguments{ program };
+  std::copy(std::begin(arguments), std::end(arguments), std::back_inserter(allArguments));
+  std::vector<char *> argv;
+  for (auto &argument : allArguments) {
+    argv.push_back(const_cast<char *>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  std::vector<std::string> variables;
+  for (char **variable = environ; *variable; variable++) {
+    std::string entry(*variable);
+    if (!environment.count(entry.substr(0, entry.find('=')))) {
+      variables.push_back(entry);
+    }
+  }
+  for (auto &pair : environment) {
+    variables.push_back(pair.first + "=" + pair.second);
+  }
+  std::vector<char *> envp;
+  for (auto &variable : variables) {
+    envp.push_back(const_cast<char *>(variable.c_str()));
+  }
+  envp.push_back(nullptr);
+
+  /// Limits are inherited by every mutant forked by the server. The server itself stays in
+  /// mull-runner's process group, the mutants get their own (see Runtime/ForkServer.cpp).
+  SandboxConfig serverResources(resources);
+  serverResources.processGroup = false;
+  serverPid = forkProcess();
+  if (serverPid == 0) {
+    dup2(input, STDIN_FILENO);
+    dup2(control[0], runtime::ForkServerControlFD);
+    dup2(status[1], runtime::ForkServerStatusFD);
+    dup2(out[1], STDOUT_FILENO);
+    dup2(err[1], STDERR_FILENO);
+    enterSandbox(serverResources);
+    execve(program.c_str(), argv.data(), envp.data());
+    _exit(127);
+  }
+  int error = serverPid < 0 ? errno : 0;
+
+  close(input);
+  close(control[0]);
+  close(status[1]);
+  close(out[1]);
+  if (err[1] != out[1]) {
+    close(err[1]);
+  }
+  controlFD = control[1];
+  statusFD = status[0];
+  stdoutFD = out[0];
+  stderrFD = err[0];
+
+  if (error != 0) {
+    serverPid = -1;
+    diagnostics.warning("Cannot start the fork server: "s + strerror(error));
+    stop();
+    return false;
+  }
+  return true;
+}
+
+bool ForkServerRunner::sendWord(uint32_t word) {
+  auto bytes = reinterpret_cast<const char *>(&word);
+  size_t written = 0;
+  while (written < sizeof(word)) {
+    ssize_t count = write(controlFD, bytes + written, sizeof(word) - written);
+    if (count <= 0) {
+      return false;
+    }
+    written += count;
+  }
+  return true;
+}
+
+std::optional<ExecutionResult>
+ForkServerRunner::runMutant(const std::string &identifier, const SandboxLimits &limits,
+                            bool captureOutput, const std::vector<std::string> &failureMarkers) {
+  if (serverPid == -1) {
+    return std::nullopt;
+  }
+  auto start = Clock::now();
+
+  uint32_t length = identifier.size();
+  std::string message(reinterpret_cast<char *>(&length), sizeof(length));
+  message += identifier;
+  size_t written = 0;
+  while (written < message.size()) {
+    ssize_t count = write(controlFD, message.data() + written, message.size() - written);
+    if (count <= 0) {
+      return std::nullopt;
+    }
+    written += count;
+  }
+
+  return waitForMutant(start, limits, captureOutput, failureMarkers);
+}
+
+std::optional<ExecutionResult>
+ForkServerRunner::waitForMutant(Clock::time_point start, const SandboxLimits &limits,
+                                bool captureOutput, const std::vector<std::string> &failureMarkers) {
+  std::string stdoutFile, stderrFile;
+  if (!limits.outputFile.empty()) {
+    stdoutFile = limits.outputFile + ".stdout";
+    stderrFile = limits.outputFile + ".stderr";
+  }
+  OutputCapture out(limits.outputLimit, stdoutFile);
+  OutputCapture err(limits.outputLimit, stderrFile);
+  OutputSinks sinks;
+  sinks.out = captureOutput ? &out : nullptr;
+  sinks.err = captureOutput ? &err : nullptr;
+  if (!failureMarkers.empty()) {
+    sinks.outMarkers.emplace(failureMarkers);
+    sinks.errMarkers.emplace(failureMarkers);
+  }
+  auto wallDeadline = start + std::chrono::milliseconds(limits.wallTime);
+
+  /// The mutant may print before the server reports its pid
+  int32_t pid = 0;
+  ReadStatus readStatus;
+  do {
+    readStatus = readWord(statusFD, pid, std::nullopt, stdoutFD, stderrFD, sinks);
+  } while (readStatus == ReadStatus::FailureSeen);
+  if (readStatus != ReadStatus::Done || pid <= 0) {
+    return std::nullopt;
+  }
+
+  /// The mutant is the server's child, not ours: its rusage is out of reach, so the CPU time is
+  /// sampled while waiting for the status and the last sample is reported
+  bool timedOut = false;
+  long long cpuTime = 0;
+  int32_t status = 0;
+  while (true) {
+    if (!sinks.failureSeen) {
+      auto slice = Clock::now() + std::chrono::milliseconds(CPUPollIntervalMilliseconds);
+      readStatus =
+          readWord(statusFD, status, std::min(slice, wallDeadline), stdoutFD, stderrFD, sinks);
+      if (readStatus != ReadStatus::TimedOut && readStatus != ReadStatus::FailureSeen) {
+        break;
+      }
+      cpuTime = processCPUTime(pid).value_or(cpuTime);
+      timedOut =
+          Clock::now() >= wallDeadline || (limits.cpuTime > 0 && cpuTime > limits.cpuTime);
+    }
+    /// A failing test decides the mutant's fate, the others need not run
+    if (timedOut || sinks.failureSeen) {
+      if (limits.resources.processGroup) {
+        kill(-pid, SIGKILL);
+      }
+      kill(pid, SIGKILL);
+      readStatus = readWord(statusFD, status, std::nullopt, stdoutFD, stderrFD, sinks);
+      break;
+    }
+  }
+  if (readStatus != ReadStatus::Done) {
+    return std::nullopt;
+  }
+  if (limits.resources.processGroup) {
+    /// The runtime puts every mutant into its own process group, see Runtime/ForkServer.cpp
+    kill(-pid, SIGKILL);
+  }
+  drainOutput(stdoutFD, stderrFD, sinks);
+
+  auto elapsed = Clock::now() - start;
+  ExecutionResult result;
+  result.runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+  result.cpuTime = cpuTime;
+  result.exitStatus =
+      WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status) + SignalExitStatusOffset;
+  result.stdoutOutput = out.take();
+  result.stderrOutput = err.take();
+  if (sinks.failureSeen) {
+    result.status = FailFast;
+  } else if (timedOut) {
+    result.status = Timedout;
+  } else {
+    result.status = executionStatusFromExitStatus(result.exitStatus);
+  }
+  return result;
+}
+
+bool ForkServerRunner::startSplitStream(const std::string &program,
+                                        const std::vector<std::string> &arguments,
+                                        const SandboxConfig &resources) {
+  return launch(program,
+                arguments,
+                { { runtime::SplitStreamEnvironmentVariable, "1" } },
+                resources,
+                false);
+}
+
+std::optional<std::string> ForkServerRunner::nextSplit(long long int timeout) {
+  if (serverPid == -1) {
+    return std::nullopt;
+  }
+  int32_t length = 0;
+  OutputSinks discard;
+  ReadStatus readStatus = readWord(statusFD,
+                                   length,
+                                   Clock::now() + std::chrono::milliseconds(timeout),
+                                   stdoutFD,
+                                   stderrFD,
+                                   discard);
+  if (readStatus == ReadStatus::TimedOut) {
+    diagnostics.debug("Split stream did not reach another mutant in time, stopping it");
+  }
+  if (readStatus != ReadStatus::Done || length <= 0) {
+    stop();
+    return std::nullopt;
+  }
+  /// Written together with the length
+  std::string identifier(length, '\0');
+  size_t offset = 0;
+  while (offset < identifier.size()) {
+    ssize_t count = read(statusFD, identifier.data() + offset, identifier.size() - offset);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      stop();
+      return std::nullopt;
+    }
+    offset += count;
+  }
+  return identifier;
+}
+
+bool ForkServerRunner::skipSplit() {
+  return serverPid != -1 && sendWord(0);
+}
+
+std::optional<ExecutionResult> ForkServerRunner::runSplit(const SandboxLimits &limits) {
+  if (serverPid == -1) {
+    return std::nullopt;
+  }
+  auto start = Clock::now();
+  if (!sendWord(1)) {
+    return std::nullopt;
+  }
+  return waitForMutant(start, limits, false, {});
+}
+
+void ForkServerRunner::stop() {
+  closeFD(controlFD);
+  if (serverPid != -1) {
+    kill(serverPid, SIGKILL);
+    int status;
+    waitpid(serverPid, &status, 0);
+    serverPid = -1;
+  }
+  closeFD(statusFD);
+  closeFD(stdoutFD);
+  closeFD(stderrFD);
+}
@@ -0,0 +1,305 @@
+#include "mull/JunkDetection/CXX/ASTCache.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+
+#include <clang/Basic/FileManager.h>
+#include <clang/Basic/FileSystemOptions.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Lex/HeaderSearchOptions.h>
+#include <clang/Serialization/PCHContainerOperations.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <map>
+
+using namespace mull;
+
+/// Bumped whenever the entries change meaning
+static const char *CacheVersion = "mull-ast-cache-1";
+/// The serialized AST, and the files it was built from ("<content hash>\t<path>" per line).
+/// An entry is complete once its inputs file exists.
+static const char *ASTExtension = ".ast";
+static const char *InputsExtension = ".inputs";
+/// "<junk>\t<end line>\t<end column>\t<mutant>" per line
+static const char *VerdictsExtension = ".verdicts";
+
+static void add(llvm::MD5 &md5, llvm::StringRef value) {
+  md5.update(value);
+  md5.update(llvm::StringRef("\0", 1));
+}
+
+static std::string digest(llvm::MD5 &md5) {
+  llvm::MD5::MD5Result result;
+  md5.final(result);
+  return result.digest().str().str();
+}
+
+/// Empty if the file cannot be read
+static std::string fileHash(const std::string &path) {
+  auto buffer = llvm::MemoryBuffer::getFile(path, false, false);
+  if (!buffer) {
+    return std::string();
+  }
+  llvm::MD5 md5;
+  md5.update(buffer.get()->getBuffer());
+  return digest(md5);
+}
+
+/// Written aside and renamed: concurrent builds sharing the cache never see partial files
+static std::error_code writeAtomically(const std::string &directory, const std::string &path,
+                                       llvm::function_ref<std::error_code(llvm::StringRef)> write) {
+  int fd = -1;
+  llvm::SmallString<PATH_MAX> temporaryPath(directory);
+  llvm::sys::path::append(temporaryPath, "%%%%%%%%.tmp");
+  std::error_code error = llvm::sys::fs::createUniqueFile(temporaryPath, fd, temporaryPath);
+  if (error) {
+    return error;
+  }
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  error = write(temporaryPath);
+  if (!error) {
+    error = llvm::sys::fs::rename(temporaryPath, path);
+  }
+  if (error) {
+    llvm::sys::fs::remove(temporaryPath);
+  }
+  return error;
+}
+
+ASTCache::ASTCache(Diagnostics &diagnostics, std::string directory, uint64_t sizeLimit)
+    : diagnostics(diagnostics), directory(std::move(directory)), sizeLimit(sizeLimit),
+      pchOperations(std::make_shared<clang::PCHContainerOperations>()) {}
+
+ASTCache::~ASTCache() = default;
+
+std::string ASTCache::key(const std::string &sourceFile, const std::vector<const char *> &args) {
+  llvm::MD5 md5;
+  add(md5, CacheVersion);
+  add(md5, LLVM_VERSION_STRING);
+  for (auto arg : args) {
+    add(md5, arg);
+  }
+  add(md5, sourceFile);
+  add(md5, fileHash(sourceFile));
+  return digest(md5);
+}
+
+std::string ASTCache::path(const std::string &key, const char *extension) const {
+  llvm::SmallString<PATH_MAX> path(directory);
+  llvm::sys::path::append(path, key + extension);
+  return path.str().str();
+}
+
+bool ASTCache::inputsUnchanged(const std::string &entry, const std::string &sourceFile) {
+  auto inputs = llvm::MemoryBuffer::getFile(path(entry, InputsExtension));
+  if (!inputs) {
+    return false;
+  }
+  llvm::StringRef content = inputs.get()->getBuffer();
+  while (!content.empty()) {
+    auto [line, rest] = content.split('\n');
+    content = rest;
+    auto [hash, input] = line.split('\t');
+    if (hash != fileHash(input.str())) {
+      diagnostics.debug("AST cache: " + input.str() + " changed, parsing " + sourceFile);
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Recently used entries are the last to go
+void ASTCache::touch(const std::string &entry) {
+  int fd;
+  if (!llvm::sys::fs::openFileForRead(path(entry, ASTExtension), fd)) {
+    llvm::sys::fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now());
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  }
+}
+
+std::unique_ptr<clang::ASTUnit> ASTCache::load(const std::string &sourceFile,
+                                               const std::vector<const char *> &args) {
+  std::string entry = key(sourceFile, args);
+  if (!inputsUnchanged(entry, sourceFile)) {
+    return nullptr;
+  }
+
+  std::string astPath = path(entry, ASTExtension);
+  clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diagnosticsEngine(
+      clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions));
+  auto ast = clang::ASTUnit::LoadFromASTFile(astPath,
+                                             pchOperations->getRawReader(),
+                                             clang::ASTUnit::LoadEverything,
+                                             diagnosticsEngine,
+                                             clang::FileSystemOptions()
+#if LLVM_VERSION_MAJOR >= 17
+                                                 ,
+                                             std::make_shared<clang::HeaderSearchOptions>()
+#endif
+  );
+  if (!ast || diagnosticsEngine->hasErrorOccurred()) {
+    diagnostics.debug("AST cache: cannot load " + astPath + ", parsing " + sourceFile);
+    return nullptr;
+  }
+  touch(entry);
+  return ast;
+}
+
+void ASTCache::store(const std::string &sourceFile, const std::vector<const char *> &args,
+                     clang::ASTUnit &ast) {
+  std::string entry = key(sourceFile, args);
+  std::string inputs;
+  llvm::raw_string_ostream stream(inputs);
+  clang::SourceManager &sourceManager = ast.getSourceManager();
+  for (auto it = sourceManager.fileinfo_begin(); it != sourceManager.fileinfo_end(); it++) {
+#if LLVM_VERSION_MAJOR >= 18
+    llvm::StringRef input = it->first.getFileEntry().tryGetRealPathName();
+    if (input.empty()) {
+      input = it->first.getName();
+    }
+#else
+    llvm::StringRef input = it->first->tryGetRealPathName();
+    if (input.empty()) {
+      input = it->first->getName();
+    }
+#endif
+    std::string hash = fileHash(input.str());
+    if (hash.empty()) {
+      /// Cannot be checked later on
+      return;
+    }
+    stream << hash << '\t' << input << '\n';
+  }
+  stream.flush();
+
+  std::error_code error = llvm::sys::fs::create_directories(directory);
+  if (!error) {
+    error = writeAtomically(directory, path(entry, ASTExtension), [&](llvm::StringRef temporary) {
+      /// Returns true on failure
+      return ast.Save(temporary) ? std::make_error_code(std::errc::io_error) : std::error_code();
+    });
+  }
+  if (!error) {
+    error = writeAtomically(directory, path(entry, InputsExtension), [&](llvm::StringRef temporary) {
+      std::error_code writeError;
+      llvm::raw_fd_ostream file(temporary, writeError);
+      if (writeError) {
+        return writeError;
+      }
+      file << inputs;
+      file.close();
+      return file.has_error() ? file.error() : std::error_code();
+    });
+  }
+  if (error) {
+    diagnostics.warning("Cannot store the AST of " + sourceFile + " in " + directory + ": " +
+                        error.message());
+    return;
+  }
+  prune();
+}
+
+JunkVerdicts ASTCache::loadVerdicts(const std::string &sourceFile,
+                                   const std::vector<const char *> &args) {
+  JunkVerdicts verdicts;
+  std::string entry = key(sourceFile, args);
+  auto file = llvm::MemoryBuffer::getFile(path(entry, VerdictsExtension));
+  if (!file || !inputsUnchanged(entry, sourceFile)) {
+    return verdicts;
+  }
+  llvm::StringRef content = file.get()->getBuffer();
+  while (!content.empty()) {
+    auto [line, rest] = content.split('\n');
+    content = rest;
+    auto [junk, afterJunk] = line.split('\t');
+    auto [endLine, afterLine] = afterJunk.split('\t');
+    auto [endColumn, mutant] = afterLine.split('\t');
+    JunkVerdict verdict{ junk == "1", 0, 0 };
+    if (mutant.empty() || endLine.getAsInteger(10, verdict.endLine) ||
+        endColumn.getAsInteger(10, verdict.endColumn)) {
+      diagnostics.debug("AST cache: malformed verdicts of " + sourceFile);
+      return JunkVerdicts();
+    }
+    verdicts.emplace(mutant.str(), verdict);
+  }
+  touch(entry);
+  return verdicts;
+}
+
+void ASTCache::storeVerdicts(const std::string &sourceFile, const std::vector<const char *> &args,
+                             const JunkVerdicts &verdicts) {
+  std::string entry = key(sourceFile, args);
+  if (!llvm::sys::fs::exists(path(entry, InputsExtension))) {
+    return;
+  }
+  std::error_code error =
+      writeAtomically(directory, path(entry, VerdictsExtension), [&](llvm::StringRef temporary) {
+        std::error_code writeError;
+        llvm::raw_fd_ostream file(temporary, writeError);
+        if (writeError) {
+          return writeError;
+        }
+        for (auto &[mutant, verdict] : verdicts) {
+          file << (verdict.junk ? '1' : '0') << '\t' << verdict.endLine << '\t'
+               << verdict.endColumn << '\t' << mutant << '\n';
+        }
+        file.close();
+        return file.has_error() ? file.error() : std::error_code();
+      });
+  if (error) {
+    diagnostics.warning("Cannot store the junk verdicts of " + sourceFile + " in " + directory +
+                        ": " + error.message());
+  }
+}
+
+void ASTCache::prune() {
+  struct Entry {
+    llvm::sys::TimePoint<> used;
+    uint64_t size = 0;
+  };
+  std::map<std::string, Entry> entries;
+  uint64_t total = 0;
+  std::error_code error;
+  for (llvm::sys::fs::directory_iterator it(directory, error), end; !error && it != end;
+       it.increment(error)) {
+    llvm::StringRef file = it->path();
+    llvm::StringRef extension = llvm::sys::path::extension(file);
+    if (extension != ASTExtension && extension != InputsExtension &&
+        extension != VerdictsExtension) {
+      continue;
+    }
+    llvm::sys::fs::file_status status;
+    if (llvm::sys::fs::status(file, status)) {
+      continue;
+    }
+    Entry &entry = entries[llvm::sys::path::stem(file).str()];
+    if (extension == ASTExtension) {
+      entry.used = status.getLastModificationTime();
+    }
+    entry.size += status.getSize();
+    total += status.getSize();
+  }
+  if (total <= sizeLimit) {
+    return;
+  }
+  std::vector<std::pair<std::string, Entry>> oldestFirst(entries.begin(), entries.end());
+  std::sort(oldestFirst.begin(), oldestFirst.end(), [](auto &lhs, auto &rhs) {
+    return lhs.second.used < rhs.second.used;
+  });
+  for (auto &[key, entry] : oldestFirst) {
+    if (total <= sizeLimit) {
+      break;
+    }
+    /// The inputs go first: the entry is never seen complete without its AST
+    llvm::sys::fs::remove(path(key, InputsExtension));
+    llvm::sys::fs::remove(path(key, VerdictsExtension));
+    llvm::sys::fs::remove(path(key, ASTExtension));
+    total -= entry.size;
+  }
+}
@@ -4,10 +4,15 @@
 #include "mull/MutationPoint.h"
 
 #include <clang/AST/RecursiveASTVisitor.h>
+#include <clang/Basic/CharInfo.h>
 #include <clang/Basic/FileManager.h>
 #include <clang/Frontend/CompilerInstance.h>
+#include <clang/Lex/Lexer.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Path.h>
+
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 
 using namespace mull;
@@ -47,6 +52,8 @@ private:
 ThreadSafeASTUnit::ThreadSafeASTUnit(std::unique_ptr<clang::ASTUnit> ast) : ast(std::move(ast)) {
   if (this->ast) {
     recordDeclarations();
+    recordFiles();
+    mutationSites.build(decls);
   }
 }
 
@@ -59,6 +66,11 @@ clang::ASTContext &ThreadSafeASTUnit::getASTContext() {
 }
 
 bool ThreadSafeASTUnit::isInSystemHeader(clang::SourceLocation &location) {
+  unsigned offset;
+  if (const SourceFile *file = findFile(location, offset)) {
+    return file->systemHeader;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
   return ast->getSourceManager().isInSystemHeader(location);
 }
 
@@ -99,14 +111,31 @@ const clang::FileEntry *ThreadSafeASTUnit::findFileEntry(const std::string &file
       break;
     }
   }
+  if (!file) {
+    /// ASTs loaded from the cache only know the files whose locations were read so far
+    if (auto entry = ast->getFileManager().getFile(filePath)) {
+      file = *entry;
+    }
+  }
 
   return file;
 }
 
 clang::SourceLocation ThreadSafeASTUnit::getLocation(const mull::SourceLocation &sourceLocation) {
+  assert(!sourceLocation.isNull());
+  auto found = filePaths.find(sourceLocation.filePath);
+  if (found == filePaths.end()) {
+    llvm::SmallString<PATH_MAX> realFilePath;
+    if (!llvm::sys::fs::real_path(sourceLocation.filePath, realFilePath)) {
+      found = filePaths.find(realFilePath);
+    }
+  }
+  if (found != filePaths.end()) {
+    return files[found->second].translate(sourceLocation.line, sourceLocation.column);
+  }
+
   auto file = findFileEntry(sourceLocation);
   assert(file);
-  assert(!sourceLocation.isNull());
 
   /// getLocation from the ASTUnit it not thread safe
   std::lock_guard<std::mutex> lock(mutex);
@@ -117,6 +146,24 @@ clang::SourceLocation ThreadSafeASTUnit::getLocation(const mull::SourceLocation
 
 clang::SourceLocation
 ThreadSafeASTUnit::getLocForEndOfToken(const clang::SourceLocation sourceLocationEnd) {
+  unsigned offset;
+  if (const SourceFile *file = findFile(sourceLocationEnd, offset)) {
+    /// What clang::Lexer::MeasureTokenLength does, on the buffer recorded with the file
+    const char *tokenStart = file->buffer.data() + offset;
+    if (offset == file->buffer.size() || clang::isWhitespace(*tokenStart)) {
+      return sourceLocationEnd;
+    }
+    clang::Lexer lexer(file->start,
+                       ast->getASTContext().getLangOpts(),
+                       file->buffer.begin(),
+                       tokenStart,
+                       file->buffer.end());
+    lexer.SetCommentRetentionState(true);
+    clang::Token token;
+    lexer.LexFromRawLexer(token);
+    return sourceLocationEnd.getLocWithOffset(token.getLength());
+  }
+
   /// clang::Lexer::getLocForEndOfToken internally calls getLocation, which is known for not being
   /// thread safe. therefore we need to protect it within the ThreadSafeASTUnit
   std::lock_guard<std::mutex> lock(mutex);
@@ -129,6 +176,25 @@ ThreadSafeASTUnit::getLocForEndOfToken(const clang::SourceLocation sourceLocatio
   return sourceLocationEndActual;
 }
 
+/// Same as clang::SourceManager::translateFileLineCol, which computes the line table on first use
+clang::SourceLocation ThreadSafeASTUnit::SourceFile::translate(unsigned line,
+                                                               unsigned column) const {
+  if (line > lines.size()) {
+    return start.getLocWithOffset(buffer.empty() ? 0 : buffer.size() - 1);
+  }
+  unsigned position = lines[line - 1];
+  unsigned length = buffer.size() - position;
+  if (length == 0) {
+    return start.getLocWithOffset(position);
+  }
+  const char *text = buffer.data() + position;
+  unsigned i = 0;
+  while (i < length - 1 && i < column - 1 && text[i] != '\n' && text[i] != '\r') {
+    ++i;
+  }
+  return start.getLocWithOffset(position + i);
+}
+
 struct SortLocationComparator {
   explicit SortLocationComparator(clang::SourceManager &sourceManager)
       : sourceManager(sourceManager), cmp(sourceManager) {}
@@ -153,11 +219,11 @@ struct UniqueLocationComparator {
   clang::BeforeThanCompare<clang::SourceLocation> cmp;
 };
 
-void ThreadSafeASTUnit::recordDeclarations() {
-  assert(ast);
-  clang::SourceManager &sourceManager = ast->getSourceManager();
+std::vector<clang::Decl *> mull::collectDeclarations(clang::ASTContext &context) {
+  std::vector<clang::Decl *> decls;
+  clang::SourceManager &sourceManager = context.getSourceManager();
   DeclVisitor visitor(sourceManager, decls);
-  visitor.TraverseDecl(ast->getASTContext().getTranslationUnitDecl());
+  visitor.TraverseDecl(context.getTranslationUnitDecl());
 
   SortLocationComparator sortComparator(sourceManager);
   std::sort(decls.begin(), decls.end(), sortComparator);
@@ -165,12 +231,113 @@ void ThreadSafeASTUnit::recordDeclarations() {
   UniqueLocationComparator uniqueComparator(sourceManager);
   auto last = std::unique(decls.begin(), decls.end(), uniqueComparator);
   decls.erase(last, decls.end());
+  return decls;
+}
+
+void ThreadSafeASTUnit::recordDeclarations() {
+  assert(ast);
+  decls = collectDeclarations(ast->getASTContext());
+}
+
+/// Debug information points at expansion locations: none of them is inside of a macro argument,
+/// so unlike ASTUnit::getLocation there is no need to look for the argument's expansion. Files
+/// are recorded along with the declarations in them, the source manager is not used afterwards.
+void ThreadSafeASTUnit::recordFiles() {
+  clang::SourceManager &sourceManager = ast->getSourceManager();
+  std::unordered_map<unsigned, size_t> fileIndices;
+  for (clang::Decl *decl : decls) {
+    auto begin = sourceManager.getDecomposedLoc(
+        sourceManager.getExpansionLoc(decl->getSourceRange().getBegin()));
+    auto end = sourceManager.getDecomposedLoc(
+        sourceManager.getExpansionLoc(decl->getSourceRange().getEnd()));
+    if (begin.first.isInvalid() || begin.first != end.first) {
+      continue;
+    }
+    clang::SourceLocation start = sourceManager.getLocForStartOfFile(begin.first);
+    auto inserted = fileIndices.emplace(start.getRawEncoding(), files.size());
+    if (inserted.second) {
+      SourceFile file;
+      file.start = start;
+      file.buffer = sourceManager.getBufferData(begin.first);
+      file.systemHeader = sourceManager.isInSystemHeader(start);
+      /// Line endings as in clang::SourceManager, a "\r\n" pair ends a single line
+      file.lines.push_back(0);
+      for (size_t i = 0; i < file.buffer.size(); i++) {
+        char c = file.buffer[i];
+        if (c == '\n' || c == '\r') {
+          if (c == '\r' && i + 1 < file.buffer.size() && file.buffer[i + 1] == '\n') {
+            i++;
+          }
+          file.lines.push_back(i + 1);
+        }
+      }
+      files.push_back(std::move(file));
+    }
+    files[inserted.first->second].decls.push_back({ begin.second, end.second, decl });
+  }
+
+  std::sort(files.begin(), files.end(), [](const SourceFile &lhs, const SourceFile &rhs) {
+    return lhs.start.getRawEncoding() < rhs.start.getRawEncoding();
+  });
+  for (size_t index = 0; index < files.size(); index++) {
+    SourceFile &file = files[index];
+    std::sort(file.decls.begin(), file.decls.end(), [](const DeclRange &lhs, const DeclRange &rhs) {
+      return lhs.begin < rhs.begin;
+    });
+    llvm::StringRef name = sourceManager.getFilename(file.start);
+    if (!name.empty()) {
+      filePaths.try_emplace(name, index);
+    }
+    /// Relative names are relative to the compilation's directory, not to ours
+    if (!llvm::sys::path::is_absolute(name)) {
+      const clang::FileEntry *entry =
+          sourceManager.getFileEntryForID(sourceManager.getFileID(file.start));
+      name = entry ? entry->tryGetRealPathName() : llvm::StringRef();
+    }
+    llvm::SmallString<PATH_MAX> realPath;
+    if (!name.empty() && !llvm::sys::fs::real_path(name, realPath)) {
+      filePaths.try_emplace(realPath, index);
+    }
+  }
+}
+
+const ThreadSafeASTUnit::SourceFile *ThreadSafeASTUnit::findFile(clang::SourceLocation location,
+                                                                 unsigned &offset) const {
+  if (location.isInvalid() || !location.isFileID()) {
+    return nullptr;
+  }
+  auto raw = location.getRawEncoding();
+  auto next = std::upper_bound(
+      files.begin(), files.end(), raw, [](decltype(raw) value, const SourceFile &file) {
+        return value < file.start.getRawEncoding();
+      });
+  if (next == files.begin()) {
+    return nullptr;
+  }
+  const SourceFile &file = *std::prev(next);
+  if (raw - file.start.getRawEncoding() > file.buffer.size()) {
+    return nullptr;
+  }
+  offset = raw - file.start.getRawEncoding();
+  return &file;
 }
 
 clang::Decl *ThreadSafeASTUnit::getDecl(clang::SourceLocation &location) {
   if (decls.empty()) {
     return nullptr;
   }
+  unsigned offset;
+  if (const SourceFile *file = findFile(location, offset)) {
+    auto lower = std::lower_bound(
+        file->decls.begin(), file->decls.end(), offset, [](const DeclRange &decl, unsigned value) {
+          return decl.end < value;
+        });
+    if (lower != file->decls.end() && lower->begin < offset && offset < lower->end) {
+      return lower->decl;
+    }
+    return nullptr;
+  }
+
   std::lock_guard<std::mutex> lock(mutex);
   clang::BeforeThanCompare<clang::SourceLocation> comparator(ast->getSourceManager());
 
@@ -193,10 +360,29 @@ clang::Decl *ThreadSafeASTUnit::getDecl(clang::SourceLocation &location) {
   return nullptr;
 }
 
+const MutationSiteIndex &ThreadSafeASTUnit::getMutationSites() const {
+  return mutationSites;
+}
+
 bool ThreadSafeASTUnit::hasAST() const {
   return ast != nullptr;
 }
 
+/// The translation unit findAST parses for the location
+static const std::string &unitFile(const mull::SourceLocation &sourceLocation) {
+  if (sourceLocation.unitFilePath == "/in-memory-file.cc") {
+    return sourceLocation.filePath;
+  }
+  return sourceLocation.unitFilePath;
+}
+
+/// The user identifier of the mutant, without the end location junk detection finds
+static std::string verdictKey(const MutationPoint *point) {
+  auto &location = point->getSourceLocation();
+  return point->getMutatorIdentifier() + ':' + location.filePath + ':' +
+         std::to_string(location.line) + ':' + std::to_string(location.column);
+}
+
 ASTStorage::ASTStorage(Diagnostics &diagnostics, const std::string &cxxCompilationDatabasePath,
                        const std::string &cxxCompilationFlags,
                        const std::unordered_map<std::string, std::string> &bitcodeCompilationFlags)
@@ -204,6 +390,12 @@ ASTStorage::ASTStorage(Diagnostics &diagnostics, const std::string &cxxCompilati
       compilationDatabase(CompilationDatabase::fromFile(
           diagnostics, cxxCompilationDatabasePath, cxxCompilationFlags, bitcodeCompilationFlags)) {}
 
+ASTStorage::~ASTStorage() {
+  for (auto &prefetcher : prefetchers) {
+    prefetcher.join();
+  }
+}
+
 ThreadSafeASTUnit *ASTStorage::findAST(const mull::SourceLocation &sourceLocation) {
   const std::string &sourceFile = sourceLocation.unitFilePath;
   if (llvm::sys::fs::exists(sourceFile)) {
@@ -220,11 +412,33 @@ ThreadSafeASTUnit *ASTStorage::findAST(const mull::SourceLocation &sourceLocatio
 }
 
 ThreadSafeASTUnit *ASTStorage::findAST(const std::string &sourceFile) {
-  std::lock_guard<std::mutex> guard(mutex);
-  if (astUnits.count(sourceFile)) {
-    return astUnits.at(sourceFile).get();
+  std::promise<ThreadSafeASTUnit *> promise;
+  std::shared_future<ThreadSafeASTUnit *> future;
+  bool owner = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto found = astUnits.find(sourceFile);
+    if (found != astUnits.end()) {
+      future = found->second;
+    } else {
+      future = promise.get_future().share();
+      astUnits.emplace(sourceFile, future);
+      owner = true;
+    }
+  }
+  if (owner) {
+    std::unique_ptr<ThreadSafeASTUnit> ast = parse(sourceFile);
+    ThreadSafeASTUnit *unit = ast.get();
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      ownedUnits.push_back(std::move(ast));
+    }
+    promise.set_value(unit);
   }
+  return future.get();
+}
 
+std::vector<const char *> ASTStorage::arguments(const std::string &sourceFile) {
   auto &[compiler, flags] = compilationDatabase.compilationFlagsForFile(sourceFile);
   std::vector<const char *> args({ compiler.c_str() });
   for (auto &flag : flags) {
@@ -233,6 +447,17 @@ ThreadSafeASTUnit *ASTStorage::findAST(const std::string &sourceFile) {
   if (args.size() == 1) {
     args.push_back(sourceFile.c_str());
   }
+  return args;
+}
+
+std::unique_ptr<ThreadSafeASTUnit> ASTStorage::parse(const std::string &sourceFile) {
+  std::vector<const char *> args = arguments(sourceFile);
+
+  if (cache) {
+    if (auto cached = cache->load(sourceFile, args)) {
+      return std::make_unique<ThreadSafeASTUnit>(std::move(cached));
+    }
+  }
 
   clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diagnosticsEngine(
       clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions));
@@ -257,14 +482,115 @@ ThreadSafeASTUnit *ASTStorage::findAST(const std::string &sourceFile) {
     message << "Make sure that the flags provided to Mull are the same flags "
                "that are used for normal compilation.";
     diagnostics.warning(message.str());
+  } else if (cache) {
+    cache->store(sourceFile, args, *ast);
+  }
+
+  return std::make_unique<ThreadSafeASTUnit>(std::unique_ptr<clang::ASTUnit>(std::move(ast)));
+}
+
+void ASTStorage::prefetch(const std::vector<MutationPoint *> &points, unsigned workers) {
+  /// The mutation points of each translation unit
+  std::vector<std::vector<MutationPoint *>> units;
+  std::unordered_map<std::string, size_t> seen;
+  for (auto point : points) {
+    auto &location = point->getSourceLocation();
+    if (location.isNull()) {
+      continue;
+    }
+    auto inserted = seen.emplace(location.unitFilePath, units.size());
+    if (inserted.second) {
+      units.emplace_back();
+    }
+    units[inserted.first->second].push_back(point);
+  }
+  auto shared = std::make_shared<std::vector<std::vector<MutationPoint *>>>(std::move(units));
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  workers = std::max(1u, std::min(workers, unsigned(shared->size())));
+  for (unsigned i = 0; i < workers && !shared->empty(); i++) {
+    prefetchers.emplace_back([this, shared, next]() {
+      for (size_t index = (*next)++; index < shared->size(); index = (*next)++) {
+        auto &unitPoints = shared->at(index);
+        /// Translation units whose mutants all have verdicts are not needed at all
+        JunkVerdict verdict;
+        bool needed = std::any_of(unitPoints.begin(), unitPoints.end(), [&](MutationPoint *point) {
+          return !findVerdict(point, verdict);
+        });
+        if (needed) {
+          findAST(unitPoints.front()->getSourceLocation());
+        }
+      }
+    });
+  }
+}
+
+void ASTStorage::enableCache(const std::string &directory, uint64_t sizeLimit) {
+  std::lock_guard<std::mutex> guard(mutex);
+  cache = std::make_unique<ASTCache>(diagnostics, directory, sizeLimit);
+}
+
+ASTStorage::UnitVerdicts &ASTStorage::findVerdicts(const std::string &sourceFile) {
+  UnitVerdicts *unitVerdicts;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto &found = verdicts[sourceFile];
+    if (!found) {
+      found = std::make_unique<UnitVerdicts>();
+    }
+    unitVerdicts = found.get();
   }
+  std::call_once(unitVerdicts->loaded, [&]() {
+    unitVerdicts->previous = cache->loadVerdicts(sourceFile, arguments(sourceFile));
+  });
+  return *unitVerdicts;
+}
+
+bool ASTStorage::findVerdict(const MutationPoint *point, JunkVerdict &verdict) {
+  if (!cache) {
+    return false;
+  }
+  UnitVerdicts &unitVerdicts = findVerdicts(unitFile(point->getSourceLocation()));
+  std::string key = verdictKey(point);
+  auto found = unitVerdicts.previous.find(key);
+  if (found == unitVerdicts.previous.end()) {
+    return false;
+  }
+  verdict = found->second;
+  return true;
+}
+
+void ASTStorage::recordVerdict(const MutationPoint *point, const JunkVerdict &verdict) {
+  if (!cache) {
+    return;
+  }
+  UnitVerdicts &unitVerdicts = findVerdicts(unitFile(point->getSourceLocation()));
+  std::lock_guard<std::mutex> guard(unitVerdicts.mutex);
+  unitVerdicts.current[verdictKey(point)] = verdict;
+  unitVerdicts.changed = true;
+}
 
-  auto threadSafeAST = new ThreadSafeASTUnit(std::unique_ptr<clang::ASTUnit>(std::move(ast)));
-  astUnits[sourceFile] = std::unique_ptr<ThreadSafeASTUnit>(threadSafeAST);
-  return threadSafeAST;
+void ASTStorage::storeVerdicts() {
+  if (!cache) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex);
+  for (auto &[sourceFile, unitVerdicts] : verdicts) {
+    std::lock_guard<std::mutex> unitGuard(unitVerdicts->mutex);
+    if (!unitVerdicts->changed) {
+      continue;
+    }
+    /// Verdicts of mutants this build did not look at are still valid
+    JunkVerdicts merged = unitVerdicts->current;
+    merged.insert(unitVerdicts->previous.begin(), unitVerdicts->previous.end());
+    cache->storeVerdicts(sourceFile, arguments(sourceFile), merged);
+    unitVerdicts->changed = false;
+  }
 }
 
 void ASTStorage::setAST(const std::string &sourceFile, std::unique_ptr<ThreadSafeASTUnit> astUnit) {
+  std::promise<ThreadSafeASTUnit *> promise;
+  promise.set_value(astUnit.get());
   std::lock_guard<std::mutex> guard(mutex);
-  astUnits[sourceFile] = std::move(astUnit);
+  astUnits[sourceFile] = promise.get_future().share();
+  ownedUnits.push_back(std::move(astUnit));
 }
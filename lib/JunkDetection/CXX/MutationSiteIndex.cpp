@@ -0,0 +1,288 @@
+#include "mull/JunkDetection/CXX/MutationSiteIndex.h"
+
+#include "mull/JunkDetection/CXX/Visitors/InstructionRangeVisitor.h"
+
+#include <clang/AST/ExprCXX.h>
+#include <clang/AST/RecursiveASTVisitor.h>
+
+using namespace mull;
+
+uint32_t mull::mutationSiteKind(MutatorKind kind) {
+  switch (kind) {
+  case MutatorKind::CXX_RemoveVoidCall:
+    return VoidCallSite;
+  case MutatorKind::CXX_ReplaceScalarCall:
+    return ScalarCallSite;
+  case MutatorKind::NegateMutator:
+    return LogicalNotSite;
+  case MutatorKind::CXX_LessThanToLessOrEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_LT;
+
+  case MutatorKind::CXX_LessOrEqualToLessThan:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_LE;
+  case MutatorKind::CXX_GreaterThanToGreaterOrEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_GT;
+  case MutatorKind::CXX_GreaterOrEqualToGreaterThan:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_GE;
+  case MutatorKind::CXX_EqualToNotEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_EQ;
+  case MutatorKind::CXX_NotEqualToEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_NE;
+  case MutatorKind::CXX_GreaterThanToLessOrEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_GT;
+  case MutatorKind::CXX_GreaterOrEqualToLessThan:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_GE;
+  case MutatorKind::CXX_LessThanToGreaterOrEqual:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_LT;
+  case MutatorKind::CXX_LessOrEqualToGreaterThan:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_LE;
+
+  case MutatorKind::CXX_AddToSub:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Add;
+  case MutatorKind::CXX_AddAssignToSubAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_AddAssign;
+  case MutatorKind::CXX_PreIncToPreDec:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_PreInc;
+  case MutatorKind::CXX_PostIncToPostDec:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_PostInc;
+
+  case MutatorKind::CXX_SubToAdd:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Sub;
+  case MutatorKind::CXX_SubAssignToAddAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_SubAssign;
+  case MutatorKind::CXX_PreDecToPreInc:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_PreDec;
+
+  case MutatorKind::CXX_PostDecToPostInc:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_PostDec;
+
+  case MutatorKind::CXX_MulToDiv:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Mul;
+  case MutatorKind::CXX_MulAssignToDivAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_MulAssign;
+
+  case MutatorKind::CXX_DivToMul:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Div;
+  case MutatorKind::CXX_DivAssignToMulAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_DivAssign;
+
+  case MutatorKind::CXX_RemToDiv:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Rem;
+  case MutatorKind::CXX_RemAssignToDivAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_RemAssign;
+
+  case MutatorKind::CXX_BitwiseNotToNoop:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_Not;
+
+  case MutatorKind::CXX_UnaryMinusToNoop:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_Minus;
+
+  case MutatorKind::CXX_LShiftToRShift:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Shl;
+  case MutatorKind::CXX_LShiftAssignToRShiftAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_ShlAssign;
+  case MutatorKind::CXX_RShiftToLShift:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Shr;
+  case MutatorKind::CXX_RShiftAssignToLShiftAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_ShrAssign;
+
+  case MutatorKind::CXX_Bitwise_AndToOr:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_And;
+  case MutatorKind::CXX_Bitwise_AndAssignToOrAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_AndAssign;
+  case MutatorKind::CXX_Bitwise_OrToAnd:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Or;
+  case MutatorKind::CXX_Bitwise_OrAssignToAndAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_OrAssign;
+  case MutatorKind::CXX_Bitwise_XorToOr:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Xor;
+  case MutatorKind::CXX_Bitwise_XorAssignToOrAssign:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_XorAssign;
+
+  case MutatorKind::CXX_AssignConst:
+    return BinaryOperatorSite + clang::BinaryOperator::Opcode::BO_Assign;
+  case MutatorKind::CXX_InitConst:
+    return VariableInitializerSite;
+
+  case MutatorKind::CXX_RemoveNegation:
+    return UnaryOperatorSite + clang::UnaryOperator::Opcode::UO_LNot;
+
+  default:
+    return NoSite;
+  }
+}
+
+bool mull::isRangeSite(uint32_t kind) {
+  return kind == ScalarCallSite || kind == LogicalNotSite;
+}
+
+namespace mull {
+
+class MutationSiteVisitor : public clang::RecursiveASTVisitor<MutationSiteVisitor> {
+public:
+  explicit MutationSiteVisitor(MutationSiteIndex &index) : index(index), decl(nullptr) {}
+
+  void traverse(clang::Decl *declaration) {
+    decl = declaration;
+    TraverseDecl(declaration);
+  }
+
+  bool VisitBinaryOperator(clang::BinaryOperator *binaryOperator) {
+    index.add(binaryOperator->getOperatorLoc(), BinaryOperatorSite + binaryOperator->getOpcode(),
+              binaryOperator);
+    return true;
+  }
+
+  bool VisitUnaryOperator(clang::UnaryOperator *unaryOperator) {
+    index.add(unaryOperator->getOperatorLoc(), UnaryOperatorSite + unaryOperator->getOpcode(),
+              unaryOperator);
+    if (unaryOperator->getOpcode() == clang::UnaryOperatorKind::UO_LNot) {
+      index.logicalNots[decl].push_back(unaryOperator);
+    }
+    return true;
+  }
+
+  /// Also visits the member and operator calls, before the two methods below
+  bool VisitCallExpr(clang::CallExpr *callExpression) {
+    auto *type = callExpression->getType().getTypePtrOrNull();
+    if (!type) {
+      return true;
+    }
+    if (type->isVoidType()) {
+      addVoidCall(callExpression, callExpression->getSourceRange().getBegin());
+    }
+    /// Real Type = float, double, long double, integer
+    if (type->isRealType()) {
+      index.scalarCalls[decl].push_back(callExpression);
+    }
+    return true;
+  }
+
+  bool VisitCXXMemberCallExpr(clang::CXXMemberCallExpr *callExpression) {
+    addVoidCall(callExpression, callExpression->getExprLoc());
+    return true;
+  }
+
+  bool VisitCXXOperatorCallExpr(clang::CXXOperatorCallExpr *callExpression) {
+    addVoidCall(callExpression, callExpression->getOperatorLoc());
+    return true;
+  }
+
+  bool VisitVarDecl(clang::VarDecl *varDecl) {
+    if (varDecl->hasDefinition() == clang::VarDecl::DeclarationOnly || !varDecl->hasInit() ||
+        varDecl->getType().isConstQualified()) {
+      return true;
+    }
+    index.add(varDecl->getLocation(), VariableInitializerSite, varDecl->getInit());
+    return true;
+  }
+
+private:
+  void addVoidCall(clang::CallExpr *callExpression, clang::SourceLocation location) {
+    auto *type = callExpression->getType().getTypePtrOrNull();
+    if (type && type->isVoidType()) {
+      index.add(location, VoidCallSite, callExpression);
+    }
+  }
+
+  MutationSiteIndex &index;
+  clang::Decl *decl;
+};
+
+} // namespace mull
+
+void MutationSiteIndex::build(const std::vector<clang::Decl *> &decls) {
+  MutationSiteVisitor visitor(*this);
+  for (clang::Decl *decl : decls) {
+    visitor.traverse(decl);
+  }
+}
+
+uint64_t MutationSiteIndex::key(clang::SourceLocation location, uint32_t kind) {
+  return (uint64_t(location.getRawEncoding()) << 32) | kind;
+}
+
+void MutationSiteIndex::add(clang::SourceLocation location, uint32_t kind,
+                            clang::Expr *expression) {
+  if (location.isValid()) {
+    sites.emplace(key(location, kind), expression);
+  }
+}
+
+static const clang::Stmt *
+findInnermost(const std::unordered_map<const clang::Decl *, std::vector<const clang::Stmt *>> &map,
+              const VisitorParameters &parameters, const clang::Decl *decl) {
+  auto found = map.find(decl);
+  if (found == map.end()) {
+    return nullptr;
+  }
+  InstructionRangeVisitor visitor(parameters);
+  for (const clang::Stmt *stmt : found->second) {
+    visitor.visitRangeWithASTExpr(stmt);
+  }
+  return visitor.getMatchingASTNode();
+}
+
+const clang::Stmt *MutationSiteIndex::find(uint32_t kind, const VisitorParameters &parameters,
+                                           const clang::Decl *decl) const {
+  switch (kind) {
+  case NoSite:
+    return nullptr;
+  case ScalarCallSite:
+    return findInnermost(scalarCalls, parameters, decl);
+  case LogicalNotSite:
+    return findInnermost(logicalNots, parameters, decl);
+  default: {
+    auto found = sites.find(key(parameters.sourceLocation, kind));
+    return found == sites.end() ? nullptr : found->second;
+  }
+  }
+}
+
+void MutationSiteIndex::forEachSite(
+    llvm::function_ref<void(uint32_t kind, clang::SourceLocation location, const clang::Stmt *)>
+        callback) const {
+  for (auto &site : sites) {
+    callback(uint32_t(site.first), clang::SourceLocation::getFromRawEncoding(site.first >> 32),
+             site.second);
+  }
+}
+
+void MutationSiteIndex::forEachRangeSite(
+    llvm::function_ref<void(uint32_t kind, const clang::Stmt *)> callback) const {
+  for (auto &decl : scalarCalls) {
+    for (const clang::Stmt *stmt : decl.second) {
+      callback(ScalarCallSite, stmt);
+    }
+  }
+  for (auto &decl : logicalNots) {
+    for (const clang::Stmt *stmt : decl.second) {
+      callback(LogicalNotSite, stmt);
+    }
+  }
+}
+
+clang::SourceLocation MutationSiteIndex::lastToken(const clang::Stmt *expression,
+                                                   clang::SourceLocation location,
+                                                   const clang::SourceManager &sourceManager) {
+  clang::SourceLocation begin = expression->getSourceRange().getBegin();
+  bool startsExpression = sourceManager.getExpansionLineNumber(begin, nullptr) ==
+                              sourceManager.getExpansionLineNumber(location, nullptr) &&
+                          sourceManager.getExpansionColumnNumber(begin) ==
+                              sourceManager.getExpansionColumnNumber(location);
+
+  /// There are two types of mutated expressions:
+  /// 1) Remove-Void, CallExpr example: its mutation location and its getStart() are the same.
+  /// 2) Binary Mutation, BinaryOperator example: its mutation location is
+  /// BinaryOperator's getOperatorLoc(), i.e. "+", while the
+  /// [getSourceRange().getBegin(), getSourceRange().getEnd()] range is the whole "a + b"
+  /// expression.
+  clang::SourceLocation last = startsExpression ? expression->getSourceRange().getEnd() : location;
+
+  // For unary operators we shouldn't consider the location of the whole expression, but only
+  // the operator, otherwise it breaks patch reporter in weird ways
+  if (auto unary = llvm::dyn_cast<clang::UnaryOperator>(expression)) {
+    last = unary->getOperatorLoc();
+  }
+  return last;
+}
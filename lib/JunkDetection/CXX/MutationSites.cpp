@@ -0,0 +1,368 @@
+#include "mull/JunkDetection/CXX/MutationSites.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/JunkDetection/CXX/ASTStorage.h"
+#include "mull/JunkDetection/CXX/MutationSiteIndex.h"
+#include "mull/MutationPoint.h"
+#include "mull/Mutators/Mutator.h"
+
+#include <clang/AST/ASTContext.h>
+#include <clang/Basic/CharInfo.h>
+#include <clang/Basic/FileManager.h>
+#include <clang/Lex/Lexer.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/LEB128.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+
+using namespace mull;
+
+/// Sites past these columns are not recorded: the key would not hold them
+static const uint32_t MaxColumn = (1u << 22) - 1;
+static const size_t NoEnclosingRange = std::numeric_limits<size_t>::max();
+
+static uint64_t siteKey(uint32_t line, uint32_t column, uint32_t kind) {
+  return (uint64_t(line) << 32) | (uint64_t(column) << 10) | (kind & 0x3ff);
+}
+
+std::string mull::encodeMutationSites(clang::ASTContext &context) {
+  clang::SourceManager &sourceManager = context.getSourceManager();
+  MutationSiteIndex index;
+  index.build(collectDeclarations(context));
+
+  /// Sorted by path, the output does not depend on the order of the index
+  std::map<std::string, std::vector<RecordedMutationSite>> files;
+  auto fileSites = [&](clang::SourceLocation location) -> std::vector<RecordedMutationSite> * {
+    if (!location.isFileID() || sourceManager.isInSystemHeader(location)) {
+      return nullptr;
+    }
+    const clang::FileEntry *entry =
+        sourceManager.getFileEntryForID(sourceManager.getFileID(location));
+    llvm::StringRef path = entry ? entry->tryGetRealPathName() : llvm::StringRef();
+    if (path.empty()) {
+      path = sourceManager.getFilename(location);
+    }
+    return path.empty() ? nullptr : &files[path.str()];
+  };
+  auto position = [&](clang::SourceLocation location, uint32_t &line, uint32_t &column) {
+    line = sourceManager.getExpansionLineNumber(location);
+    column = sourceManager.getExpansionColumnNumber(location);
+    return line != 0 && column != 0 && column <= MaxColumn;
+  };
+  auto record = [&](std::vector<RecordedMutationSite> *sites,
+                    uint32_t kind,
+                    clang::SourceLocation location,
+                    clang::SourceLocation last,
+                    const clang::Stmt *expression) {
+    if (!sites) {
+      return;
+    }
+    RecordedMutationSite site;
+    site.kind = kind;
+    clang::SourceLocation end = clang::Lexer::getLocForEndOfToken(
+        MutationSiteIndex::lastToken(expression, location, sourceManager),
+        0,
+        sourceManager,
+        context.getLangOpts());
+    if (position(location, site.line, site.column) &&
+        position(last, site.lastLine, site.lastColumn) &&
+        position(end, site.endLine, site.endColumn)) {
+      sites->push_back(site);
+    }
+  };
+
+  index.forEachSite(
+      [&](uint32_t kind, clang::SourceLocation location, const clang::Stmt *expression) {
+        record(fileSites(location), kind, location, location, expression);
+      });
+  /// As InstructionRangeVisitor, only ranges within a single file are looked in
+  index.forEachRangeSite([&](uint32_t kind, const clang::Stmt *expression) {
+    clang::SourceRange range = expression->getSourceRange();
+    if (range.isInvalid() || !range.getEnd().isFileID() ||
+        sourceManager.getFileID(range.getBegin()) != sourceManager.getFileID(range.getEnd())) {
+      return;
+    }
+    record(fileSites(range.getBegin()), kind, range.getBegin(), range.getEnd(), expression);
+  });
+
+  std::string output;
+  llvm::raw_string_ostream stream(output);
+  llvm::encodeULEB128(MutationSitesVersion, stream);
+  llvm::encodeULEB128(files.size(), stream);
+  for (auto &file : files) {
+    auto &sites = file.second;
+    std::sort(sites.begin(), sites.end(), [](auto &lhs, auto &rhs) {
+      return std::tie(lhs.line, lhs.column, lhs.kind) < std::tie(rhs.line, rhs.column, rhs.kind);
+    });
+    llvm::encodeULEB128(file.first.size(), stream);
+    stream << file.first;
+    llvm::encodeULEB128(sites.size(), stream);
+    for (auto &site : sites) {
+      llvm::encodeULEB128(site.kind, stream);
+      llvm::encodeULEB128(site.line, stream);
+      llvm::encodeULEB128(site.column, stream);
+      llvm::encodeULEB128(site.lastLine - site.line, stream);
+      llvm::encodeULEB128(site.lastColumn, stream);
+      llvm::encodeULEB128(site.endLine >= site.line ? site.endLine - site.line : 0, stream);
+      llvm::encodeULEB128(site.endColumn, stream);
+    }
+  }
+  stream.flush();
+  return output;
+}
+
+void mull::recordMutationSites(llvm::Module &module, llvm::StringRef sites) {
+  llvm::LLVMContext &context = module.getContext();
+  llvm::NamedMDNode *node = module.getOrInsertNamedMetadata(MutationSitesMetadata);
+  node->addOperand(llvm::MDNode::get(context, llvm::MDString::get(context, sites)));
+}
+
+bool mull::hasMutationSites(const llvm::Module &module) {
+  return module.getNamedMetadata(MutationSitesMetadata) != nullptr;
+}
+
+namespace {
+/// Bounds-checked cursor over the recorded sites
+class SitesReader {
+public:
+  explicit SitesReader(llvm::StringRef data) : data(data), position(0), failed(false) {}
+
+  uint32_t number() {
+    const char *error = nullptr;
+    unsigned length = 0;
+    auto begin = reinterpret_cast<const uint8_t *>(data.data());
+    uint64_t value =
+        llvm::decodeULEB128(begin + position, &length, begin + data.size(), &error);
+    if (error || value > std::numeric_limits<uint32_t>::max()) {
+      failed = true;
+      return 0;
+    }
+    position += length;
+    return value;
+  }
+
+  llvm::StringRef string(uint32_t length) {
+    if (data.size() - position < length) {
+      failed = true;
+      return {};
+    }
+    llvm::StringRef value = data.substr(position, length);
+    position += length;
+    return value;
+  }
+
+  llvm::StringRef data;
+  size_t position;
+  bool failed;
+};
+} // namespace
+
+static bool rangeContains(const RecordedMutationSite &site, uint32_t line, uint32_t column) {
+  return std::tie(site.line, site.column) <= std::tie(line, column) &&
+         std::tie(line, column) <= std::tie(site.lastLine, site.lastColumn);
+}
+
+static void sortRangeSites(std::vector<RecordedMutationSite> &sites,
+                           std::vector<size_t> &enclosing) {
+  std::sort(sites.begin(), sites.end(), [](auto &lhs, auto &rhs) {
+    return std::tie(lhs.line, lhs.column, rhs.lastLine, rhs.lastColumn) <
+           std::tie(rhs.line, rhs.column, lhs.lastLine, lhs.lastColumn);
+  });
+  /// Ranges of the AST nest: the ranges still open at the beginning of a range enclose it
+  enclosing.assign(sites.size(), NoEnclosingRange);
+  std::vector<size_t> open;
+  for (size_t i = 0; i < sites.size(); i++) {
+    while (!open.empty() && !rangeContains(sites[open.back()], sites[i].line, sites[i].column)) {
+      open.pop_back();
+    }
+    if (!open.empty()) {
+      enclosing[i] = open.back();
+    }
+    open.push_back(i);
+  }
+}
+
+/// The innermost range spanning line:column is the last one starting before it, or encloses it
+static const RecordedMutationSite *findRangeSite(const std::vector<RecordedMutationSite> &sites,
+                                                 const std::vector<size_t> &enclosing,
+                                                 uint32_t line, uint32_t column) {
+  auto after = std::upper_bound(
+      sites.begin(), sites.end(), std::make_pair(line, column), [](auto &location, auto &site) {
+        return location < std::make_pair(site.line, site.column);
+      });
+  size_t index = after - sites.begin();
+  if (index == 0) {
+    return nullptr;
+  }
+  index--;
+  while (index != NoEnclosingRange && !rangeContains(sites[index], line, column)) {
+    index = enclosing[index];
+  }
+  return index != NoEnclosingRange ? &sites[index] : nullptr;
+}
+
+RecordedSitesJunkDetector::RecordedSitesJunkDetector(Diagnostics &diagnostics,
+                                                     const llvm::Module &module)
+    : diagnostics(diagnostics) {
+  const llvm::NamedMDNode *node = module.getNamedMetadata(MutationSitesMetadata);
+  if (!node) {
+    return;
+  }
+  for (const llvm::MDNode *operand : node->operands()) {
+    auto *string = operand->getNumOperands() == 1
+                       ? llvm::dyn_cast<llvm::MDString>(operand->getOperand(0))
+                       : nullptr;
+    SitesReader reader(string ? string->getString() : llvm::StringRef());
+    uint32_t version = reader.number();
+    if (version != MutationSitesVersion) {
+      reader.failed = true;
+    }
+    uint32_t fileCount = reader.failed ? 0 : reader.number();
+    for (uint32_t i = 0; i < fileCount && !reader.failed; i++) {
+      FileSites &file = files[reader.string(reader.number()).str()];
+      uint32_t siteCount = reader.number();
+      for (uint32_t j = 0; j < siteCount && !reader.failed; j++) {
+        RecordedMutationSite site;
+        site.kind = reader.number();
+        site.line = reader.number();
+        site.column = reader.number();
+        site.lastLine = site.line + reader.number();
+        site.lastColumn = reader.number();
+        site.endLine = site.line + reader.number();
+        site.endColumn = reader.number();
+        if (isRangeSite(site.kind)) {
+          file.rangeSites[site.kind].sites.push_back(site);
+        } else {
+          file.sites.emplace(siteKey(site.line, site.column, site.kind), site);
+        }
+      }
+    }
+    if (reader.failed) {
+      diagnostics.warning("Cannot read the mutation sites recorded in " +
+                          module.getSourceFileName() + ", some mutants may be taken for junk");
+    }
+  }
+  for (auto &file : files) {
+    for (auto &pair : file.second.rangeSites) {
+      sortRangeSites(pair.second.sites, pair.second.enclosing);
+    }
+  }
+}
+
+const RecordedSitesJunkDetector::FileSites *
+RecordedSitesJunkDetector::findFile(const std::string &path) {
+  auto found = files.find(path);
+  if (found != files.end()) {
+    return &found->second;
+  }
+  /// The sites are recorded under real paths
+  std::lock_guard<std::mutex> lock(mutex);
+  auto resolved = resolvedPaths.find(path);
+  if (resolved != resolvedPaths.end()) {
+    return resolved->second;
+  }
+  const FileSites *file = nullptr;
+  llvm::SmallString<PATH_MAX> realPath;
+  if (!llvm::sys::fs::real_path(path, realPath)) {
+    found = files.find(realPath.str().str());
+    file = found != files.end() ? &found->second : nullptr;
+  }
+  resolvedPaths.emplace(path, file);
+  return file;
+}
+
+bool RecordedSitesJunkDetector::findEndOfToken(const std::string &path, uint32_t line,
+                                               uint32_t column, uint32_t &endLine,
+                                               uint32_t &endColumn) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto inserted = sources.try_emplace(path);
+  Source &source = inserted.first->second;
+  if (inserted.second) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (buffer) {
+      source.buffer = std::move(buffer.get());
+      llvm::StringRef text = source.buffer->getBuffer();
+      source.lines.push_back(0);
+      for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\n') {
+          source.lines.push_back(i + 1);
+        }
+      }
+    }
+  }
+  if (!source.buffer || line > source.lines.size()) {
+    return false;
+  }
+  llvm::StringRef text = source.buffer->getBuffer();
+  size_t offset = source.lines[line - 1] + column - 1;
+  if (offset >= text.size()) {
+    return false;
+  }
+  endLine = line;
+  endColumn = column;
+  /// As clang::Lexer::getLocForEndOfToken, there is no token at whitespace
+  if (clang::isWhitespace(text[offset])) {
+    return true;
+  }
+  /// Only the length of a single token matters, which the language options hardly change
+  clang::LangOptions options;
+  options.CPlusPlus = true;
+  clang::Lexer lexer(clang::SourceLocation(), options, text.begin(), text.begin() + offset,
+                     text.end());
+  lexer.SetCommentRetentionState(true);
+  clang::Token token;
+  lexer.LexFromRawLexer(token);
+  endColumn += token.getLength();
+  return true;
+}
+
+bool RecordedSitesJunkDetector::isJunk(MutationPoint *point) {
+  const SourceLocation &location = point->getSourceLocation();
+  if (location.isNull()) {
+    return true;
+  }
+  uint32_t kind = mutationSiteKind(point->getMutator()->mutatorKind());
+  const FileSites *file = kind == NoSite ? nullptr : findFile(location.filePath);
+  if (!file) {
+    return true;
+  }
+  auto line = uint32_t(location.line);
+  auto column = uint32_t(location.column);
+
+  const RecordedMutationSite *site = nullptr;
+  if (!isRangeSite(kind)) {
+    auto found = file->sites.find(siteKey(line, column, kind));
+    site = found != file->sites.end() ? &found->second : nullptr;
+  } else {
+    auto found = file->rangeSites.find(kind);
+    if (found != file->rangeSites.end()) {
+      site = findRangeSite(found->second.sites, found->second.enclosing, line, column);
+    }
+  }
+  if (!site) {
+    return true;
+  }
+
+  uint32_t endLine = site->endLine;
+  uint32_t endColumn = site->endColumn;
+  /// The recorded end is that of a mutant at the beginning of the range, or of the operator
+  bool recordedEnd = kind != ScalarCallSite || (site->line == line && site->column == column);
+  if (!recordedEnd) {
+    findEndOfToken(location.filePath, line, column, endLine, endColumn);
+  }
+
+  std::string description = MutationKindToString(point->getMutator()->mutatorKind());
+  diagnostics.debug(std::string("RecordedSitesJunkDetector: mutation \"") + description + "\": " +
+                    location.filePath + ":" + std::to_string(line) + ":" + std::to_string(column) +
+                    " (end: " + std::to_string(endLine) + ":" + std::to_string(endColumn) + ")");
+
+  point->setEndLocation(endLine, endColumn);
+  return false;
+}
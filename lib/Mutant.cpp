@@ -9,7 +9,7 @@ Mutant::Mutant(std::string identifier, std::string mutatorIdentifier, SourceLoca
                SourceLocation endLocation)
     : identifier(std::move(identifier)), mutatorIdentifier(std::move(mutatorIdentifier)),
       sourceLocation(std::move(sourceLocation)), endLocation(std::move(endLocation)),
-      covered(false), mutatorKind(MutatorKind::InvalidKind) {}
+      covered(false), baselineCPUTime(0), mutatorKind(MutatorKind::InvalidKind) {}
 
 const std::string &Mutant::getIdentifier() const {
   return identifier;
@@ -43,6 +43,19 @@ void Mutant::setCovered(bool cover) {
   covered = cover;
 }
 
+void Mutant::addCoveringTest(const std::string &test, long long cpuTime) {
+  coveringTests.push_back(test);
+  baselineCPUTime += cpuTime;
+}
+
+const std::vector<std::string> &Mutant::getCoveringTests() const {
+  return coveringTests;
+}
+
+long long Mutant::getBaselineCPUTime() const {
+  return baselineCPUTime;
+}
+
 bool MutantComparator::operator()(std::unique_ptr<Mutant> &lhs, std::unique_ptr<Mutant> &rhs) {
   return operator()(*lhs, *rhs);
 }
@@ -0,0 +1,259 @@
+#include "mull/MutantManifest.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/LEB128.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include <limits>
+
+using namespace mull;
+
+/// Not printable: never the beginning of a mutant string in the older format
+static const char ManifestMagic[] = "\x7fMUL";
+static const size_t ManifestMagicSize = 4;
+/// Magic, version, size, strings, files, mutators, mutants
+static const size_t ManifestHeaderSize = ManifestMagicSize + 6 * sizeof(uint32_t);
+
+uint32_t MutantManifestWriter::intern(llvm::StringMap<uint32_t> &indices,
+                                      std::vector<uint32_t> &offsets, llvm::StringRef string) {
+  auto inserted = indices.try_emplace(string, offsets.size());
+  if (inserted.second) {
+    offsets.push_back(strings.size());
+    strings.append(string.data(), string.size());
+    strings.push_back('\0');
+  }
+  return inserted.first->second;
+}
+
+void MutantManifestWriter::add(llvm::StringRef mutator, llvm::StringRef file, uint32_t beginLine,
+                               uint32_t beginColumn, uint32_t endLine, uint32_t endColumn) {
+  llvm::raw_string_ostream stream(mutants);
+  llvm::encodeULEB128(intern(fileIndices, fileOffsets, file), stream);
+  llvm::encodeULEB128(intern(mutatorIndices, mutatorOffsets, mutator), stream);
+  llvm::encodeULEB128(beginLine, stream);
+  llvm::encodeULEB128(beginColumn, stream);
+  llvm::encodeULEB128(endLine, stream);
+  llvm::encodeULEB128(endColumn, stream);
+  stream.flush();
+  mutantCount++;
+}
+
+bool MutantManifestWriter::empty() const {
+  return mutantCount == 0;
+}
+
+static void appendWord(std::string &output, uint32_t word) {
+  char bytes[sizeof(uint32_t)];
+  llvm::support::endian::write32le(bytes, word);
+  output.append(bytes, sizeof(bytes));
+}
+
+std::string MutantManifestWriter::encode() const {
+  size_t size = ManifestHeaderSize + strings.size() +
+                (fileOffsets.size() + mutatorOffsets.size()) * sizeof(uint32_t) + mutants.size();
+  std::string output;
+  output.reserve(size);
+  output.append(ManifestMagic, ManifestMagicSize);
+  appendWord(output, MutantManifestVersion);
+  appendWord(output, size);
+  appendWord(output, strings.size());
+  appendWord(output, fileOffsets.size());
+  appendWord(output, mutatorOffsets.size());
+  appendWord(output, mutantCount);
+  output += strings;
+  for (uint32_t offset : fileOffsets) {
+    appendWord(output, offset);
+  }
+  for (uint32_t offset : mutatorOffsets) {
+    appendWord(output, offset);
+  }
+  output += mutants;
+  return output;
+}
+
+void mull::recordMutantManifest(llvm::Module &module, const MutantManifestWriter &manifest) {
+  if (manifest.empty()) {
+    return;
+  }
+  std::string encoding = manifest.encode();
+  llvm::Constant *constant = llvm::ConstantDataArray::getRaw(
+      encoding, encoding.size(), llvm::Type::getInt8Ty(module.getContext()));
+  auto *global = new llvm::GlobalVariable(module,
+                                          constant->getType(),
+                                          true,
+                                          llvm::GlobalVariable::InternalLinkage,
+                                          constant,
+                                          "mull_mutant_manifest");
+  global->setSection(MutantsSection);
+  global->setAlignment(llvm::Align(1));
+  llvm::appendToUsed(module, { global });
+}
+
+namespace {
+/// Bounds-checked cursor over a manifest
+class ManifestReader {
+public:
+  explicit ManifestReader(llvm::StringRef data) : data(data), position(0), failed(false) {}
+
+  uint32_t word() {
+    if (data.size() - position < sizeof(uint32_t)) {
+      failed = true;
+      return 0;
+    }
+    uint32_t value = llvm::support::endian::read32le(data.data() + position);
+    position += sizeof(uint32_t);
+    return value;
+  }
+
+  uint32_t number() {
+    const char *error = nullptr;
+    unsigned length = 0;
+    auto begin = reinterpret_cast<const uint8_t *>(data.data());
+    uint64_t value =
+        llvm::decodeULEB128(begin + position, &length, begin + data.size(), &error);
+    if (error || value > std::numeric_limits<uint32_t>::max()) {
+      failed = true;
+      return 0;
+    }
+    position += length;
+    return value;
+  }
+
+  llvm::StringRef data;
+  size_t position;
+  bool failed;
+};
+} // namespace
+
+/// Reads the manifest at the beginning of `section`, returns its size or 0 if it is malformed
+static size_t readManifest(llvm::StringRef section,
+                           llvm::function_ref<void(const ManifestMutant &)> callback) {
+  ManifestReader header(section);
+  header.position = ManifestMagicSize;
+  uint32_t version = header.word();
+  uint32_t size = header.word();
+  uint32_t stringsSize = header.word();
+  uint32_t fileCount = header.word();
+  uint32_t mutatorCount = header.word();
+  uint32_t mutantCount = header.word();
+  if (header.failed || size < ManifestHeaderSize || size > section.size()) {
+    return 0;
+  }
+  /// A newer format: skipped as a whole
+  if (version != MutantManifestVersion && version != 1) {
+    return size;
+  }
+  bool relativeEndLine = version == 1;
+
+  ManifestReader reader(section.take_front(size));
+  reader.position = ManifestHeaderSize;
+  llvm::StringRef strings = reader.data.substr(reader.position, stringsSize);
+  reader.position += stringsSize;
+  auto readStrings = [&](uint32_t count) {
+    std::vector<llvm::StringRef> table;
+    table.reserve(std::min<size_t>(count, size / sizeof(uint32_t)));
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+      uint32_t offset = reader.word();
+      if (offset >= strings.size()) {
+        reader.failed = true;
+        break;
+      }
+      /// The table ends with a NUL, every string is terminated
+      table.push_back(llvm::StringRef(strings.data() + offset));
+    }
+    return table;
+  };
+  if (strings.size() != stringsSize || (stringsSize != 0 && strings.back() != '\0')) {
+    return 0;
+  }
+  std::vector<llvm::StringRef> files = readStrings(fileCount);
+  std::vector<llvm::StringRef> mutators = readStrings(mutatorCount);
+
+  for (uint32_t i = 0; i < mutantCount && !reader.failed; i++) {
+    uint32_t file = reader.number();
+    uint32_t mutator = reader.number();
+    ManifestMutant mutant;
+    mutant.beginLine = reader.number();
+    mutant.beginColumn = reader.number();
+    mutant.endLine = reader.number();
+    if (relativeEndLine) {
+      mutant.endLine += mutant.beginLine;
+    }
+    mutant.endColumn = reader.number();
+    if (reader.failed || file >= files.size() || mutator >= mutators.size()) {
+      return 0;
+    }
+    mutant.file = files[file];
+    mutant.mutator = mutators[mutator];
+    callback(mutant);
+  }
+  return reader.failed ? 0 : size;
+}
+
+/// mutator:file:line:column:end line:end column, the file may contain colons
+static bool readMutantString(llvm::StringRef string, ManifestMutant &mutant) {
+  auto [mutator, rest] = string.split(':');
+  uint32_t numbers[4];
+  for (int i = 3; i >= 0; i--) {
+    llvm::StringRef number;
+    std::tie(rest, number) = rest.rsplit(':');
+    if (number.getAsInteger(10, numbers[i])) {
+      return false;
+    }
+  }
+  if (mutator.empty() || rest.empty()) {
+    return false;
+  }
+  mutant.mutator = mutator;
+  mutant.file = rest;
+  mutant.beginLine = numbers[0];
+  mutant.beginColumn = numbers[1];
+  mutant.endLine = numbers[2];
+  mutant.endColumn = numbers[3];
+  return true;
+}
+
+bool mull::readMutantManifests(llvm::StringRef section,
+                               llvm::function_ref<void(const ManifestMutant &)> callback) {
+  bool complete = true;
+  while (!section.empty()) {
+    if (section.front() == '\0') {
+      section = section.drop_front();
+      continue;
+    }
+    if (section.substr(0, ManifestMagicSize) == llvm::StringRef(ManifestMagic, ManifestMagicSize)) {
+      size_t size = readManifest(section, callback);
+      if (size == 0) {
+        /// Cannot tell where the next one starts
+        return false;
+      }
+      section = section.drop_front(size);
+      continue;
+    }
+    llvm::StringRef string = section.take_until([](char c) { return c == '\0'; });
+    section = section.drop_front(string.size());
+    ManifestMutant mutant;
+    if (readMutantString(string, mutant)) {
+      callback(mutant);
+    } else {
+      complete = false;
+    }
+  }
+  return complete;
+}
+
+std::string mull::mutantIdentifier(const ManifestMutant &mutant) {
+  std::string identifier;
+  identifier.reserve(mutant.mutator.size() + mutant.file.size() + 24);
+  identifier.append(mutant.mutator.data(), mutant.mutator.size());
+  identifier += ':';
+  identifier.append(mutant.file.data(), mutant.file.size());
+  for (uint32_t number : { mutant.beginLine, mutant.beginColumn, mutant.endLine, mutant.endColumn }) {
+    identifier += ':';
+    identifier += std::to_string(number);
+  }
+  return identifier;
+}
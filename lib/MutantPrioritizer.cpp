@@ -0,0 +1,36 @@
+#include "mull/MutantPrioritizer.h"
+
+using namespace mull;
+
+void MutantPrioritizer::addResult(const std::string &identifier, const std::string &mutator,
+                                  ExecutionStatus status) {
+  /// Neither killed nor survived
+  if (status == NotCovered || status == Invalid || status == DryRun ||
+      status == Equivalent) {
+    return;
+  }
+  bool survived = status == Passed;
+  for (Tally *tally : { &mutants[identifier], &mutators[mutator] }) {
+    tally->survived += survived;
+    tally->total++;
+  }
+}
+
+bool MutantPrioritizer::empty() const {
+  return mutants.empty();
+}
+
+double MutantPrioritizer::survivalChance(const Mutant &mutant) const {
+  /// Laplace's rule of succession: a mutator seen once is not certain to always survive
+  double mutatorChance = 0.5;
+  auto mutator = mutators.find(mutant.getMutatorIdentifier());
+  if (mutator != mutators.end()) {
+    mutatorChance = (mutator->second.survived + 1.0) / (mutator->second.total + 2.0);
+  }
+  /// The mutant's own history weighs most, its mutator's rate counts as one more result
+  auto previous = mutants.find(mutant.getIdentifier());
+  if (previous != mutants.end()) {
+    return (previous->second.survived + mutatorChance) / (previous->second.total + 1.0);
+  }
+  return mutatorChance;
+}
@@ -1,13 +1,50 @@
 #include "mull/MutantRunner.h"
+#include "mull/MutantPrioritizer.h"
 #include "mull/Parallelization/TaskExecutor.h"
 #include "mull/Parallelization/Tasks/MutantExecutionTask.h"
+#include "mull/Parallelization/Tasks/SplitStreamTask.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/Sandbox.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace mull;
 
+/// Expected time of a mutant run: taken from a previous run if possible, otherwise the CPU time
+/// the mutant's timeout is based on
+static long long estimatedCost(const Mutant &mutant, const ExecutionResult &baseline,
+                               const std::unordered_map<std::string, long long> &previousDurations) {
+  if (!mutant.isCovered()) {
+    return 0;
+  }
+  auto previous = previousDurations.find(mutant.getIdentifier());
+  if (previous != previousDurations.end()) {
+    return previous->second;
+  }
+  if (!mutant.getCoveringTests().empty()) {
+    return mutant.getBaselineCPUTime();
+  }
+  return baseline.cpuTime;
+}
+
 MutantRunner::MutantRunner(Diagnostics &diagnostics, const Configuration &configuration,
                            Runner &runner)
     : diagnostics(diagnostics), configuration(configuration), runner(runner) {}
 
+void MutantRunner::setPreviousDurations(std::unordered_map<std::string, long long> durations) {
+  previousDurations = std::move(durations);
+}
+
+void MutantRunner::setResultListener(MutationResultListener listener) {
+  resultListener = std::move(listener);
+}
+
+void MutantRunner::setPrioritizer(const MutantPrioritizer *prioritizer) {
+  this->prioritizer = prioritizer;
+}
+
 std::vector<std::unique_ptr<MutationResult>>
 MutantRunner::runMutants(const std::string &executable,
                          std::vector<std::unique_ptr<Mutant>> &mutants) {
@@ -17,29 +54,125 @@ MutantRunner::runMutants(const std::string &executable,
 std::vector<std::unique_ptr<MutationResult>>
 MutantRunner::runMutants(const std::string &executable, const std::vector<std::string> &extraArgs,
                          std::vector<std::unique_ptr<Mutant>> &mutants) {
+  /// e.g. every result is already known from a cache or a resumed report
+  if (mutants.empty()) {
+    return {};
+  }
+  ExecutionResult baseline = runBaseline(executable, extraArgs);
+  return runMutants(executable, extraArgs, baseline, mutants);
+}
+
+ExecutionResult MutantRunner::runBaseline(const std::string &executable,
+                                          const std::vector<std::string> &extraArgs) {
   SingleTaskExecutor singleTask(diagnostics);
   ExecutionResult baseline;
   singleTask.execute("Baseline run", [&]() {
-    baseline = runner.runProgram(executable,
-                                 extraArgs,
-                                 {},
-                                 configuration.timeout,
-                                 configuration.captureMutantOutput,
-                                 false,
-                                 std::nullopt);
+    /// The baseline's CPU time is the mutants' budget unless per-test timings are known
+    Sandbox sandbox(diagnostics);
+    SandboxLimits limits;
+    limits.wallTime = configuration.timeout;
+    limits.outputLimit = configuration.mutantOutputLimit;
+    /// No mutant is enabled, whatever mull-runner inherited
+    baseline = sandbox.run(executable,
+                           extraArgs,
+                           { { runtime::MutantEnvironmentVariable, "" } },
+                           limits,
+                           configuration.captureMutantOutput,
+                           {});
+  });
+  return baseline;
+}
+
+std::vector<std::unique_ptr<MutationResult>>
+MutantRunner::runMutants(const std::string &executable, const std::vector<std::string> &extraArgs,
+                         const ExecutionResult &baseline,
+                         std::vector<std::unique_ptr<Mutant>> &mutants) {
+
+  /// Longest mutants first: started last, a slow mutant would keep its worker busy long after
+  /// the others ran out of work. Results are reported in the original order.
+  std::unordered_map<const Mutant *, size_t> positions;
+  for (size_t i = 0; i < mutants.size(); i++) {
+    positions[mutants[i].get()] = i;
+  }
+  std::vector<std::unique_ptr<Mutant>> schedule(std::make_move_iterator(mutants.begin()),
+                                                std::make_move_iterator(mutants.end()));
+  std::unordered_map<const Mutant *, std::pair<double, long long>> priorities;
+  for (auto &mutant : schedule) {
+    double chance = prioritizer && mutant->isCovered() ? prioritizer->survivalChance(*mutant) : 0;
+    priorities[mutant.get()] = { chance, estimatedCost(*mutant, baseline, previousDurations) };
+  }
+  std::stable_sort(schedule.begin(), schedule.end(), [&](const auto &lhs, const auto &rhs) {
+    return priorities[lhs.get()] > priorities[rhs.get()];
   });
 
   std::vector<std::unique_ptr<MutationResult>> mutationResults;
+  if (configuration.splitStream) {
+    mutationResults = runSplitStreams(executable, extraArgs, baseline, schedule);
+  }
+  /// Mutants the split streams did not reach run on their own
+  std::unordered_set<const Mutant *> finished;
+  for (auto &result : mutationResults) {
+    finished.insert(result->getMutant());
+  }
+  std::vector<std::unique_ptr<Mutant>> remaining;
+  for (auto &mutant : schedule) {
+    if (!finished.count(mutant.get())) {
+      remaining.push_back(std::move(mutant));
+    }
+  }
+
   std::vector<MutantExecutionTask> tasks;
   tasks.reserve(configuration.parallelization.executionWorkers);
   for (unsigned i = 0; i < configuration.parallelization.executionWorkers; i++) {
-    tasks.emplace_back(configuration, diagnostics, executable, baseline, extraArgs);
+    tasks.emplace_back(
+        configuration, diagnostics, executable, baseline, extraArgs, resultListener);
   }
   TaskExecutor<MutantExecutionTask> mutantRunner(
-      diagnostics, "Running mutants", mutants, mutationResults, std::move(tasks));
+      diagnostics, "Running mutants", remaining, mutationResults, std::move(tasks));
   mutantRunner.execute();
 
+  for (auto *group : { &schedule, &remaining }) {
+    for (auto &mutant : *group) {
+      if (mutant) {
+        size_t position = positions[mutant.get()];
+        mutants[position] = std::move(mutant);
+      }
+    }
+  }
+  std::sort(mutationResults.begin(), mutationResults.end(), [&](const auto &lhs, const auto &rhs) {
+    return positions[lhs->getMutant()] < positions[rhs->getMutant()];
+  });
+
   diagnostics.debug("Done running mutants");
 
   return mutationResults;
 }
+
+std::vector<std::unique_ptr<MutationResult>>
+MutantRunner::runSplitStreams(const std::string &executable,
+                              const std::vector<std::string> &extraArgs,
+                              const ExecutionResult &baseline,
+                              const std::vector<std::unique_ptr<Mutant>> &mutants) {
+  /// One stream per worker, mutants are dealt out in schedule order to keep the streams even
+  std::vector<std::vector<Mutant *>> streams(configuration.parallelization.executionWorkers);
+  size_t next = 0;
+  for (auto &mutant : mutants) {
+    if (mutant->isCovered()) {
+      streams[next++ % streams.size()].push_back(mutant.get());
+    }
+  }
+  streams.erase(std::remove_if(streams.begin(),
+                               streams.end(),
+                               [](auto &stream) { return stream.empty(); }),
+                streams.end());
+
+  std::vector<std::unique_ptr<MutationResult>> results;
+  std::vector<SplitStreamTask> tasks;
+  for (size_t i = 0; i < streams.size(); i++) {
+    tasks.emplace_back(configuration, diagnostics, executable, baseline, extraArgs, resultListener);
+  }
+  TaskExecutor<SplitStreamTask> streamRunner(
+      diagnostics, "Running mutants in split streams", streams, results, std::move(tasks));
+  streamRunner.execute();
+  return results;
+}
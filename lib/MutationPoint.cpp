@@ -1,5 +1,6 @@
 #include "mull/MutationPoint.h"
 
+#include "mull/MutantManifest.h"
 #include "mull/Mutators/Mutator.h"
 #include "mull/Reporters/SourceCodeReader.h"
 
@@ -109,6 +110,12 @@ void MutationPoint::applyMutation() {
   mutator->applyMutation(mutatedFunction, address, irMutator);
 }
 
+void MutationPoint::applyMutation(llvm::Instruction &instruction) {
+  mutator->applyMutation(instruction.getFunction(),
+                         MutationPointAddress::addressFromInstruction(&instruction),
+                         irMutator);
+}
+
 void MutationPoint::setEndLocation(int line, int column) {
   endLocation = SourceLocation(sourceLocation.unitDirectory,
                                sourceLocation.unitFilePath,
@@ -126,24 +133,13 @@ void MutationPoint::updateIdentifier() {
                    ':' + std::to_string(endLocation.column);
 }
 
-void MutationPoint::recordMutation() {
-  assert(originalFunction != nullptr);
-  llvm::Module *module = originalFunction->getParent();
-  std::string encoding = getUserIdentifier();
-  llvm::Constant *constant =
-      llvm::ConstantDataArray::getString(module->getContext(), llvm::StringRef(encoding));
-  auto *global = new llvm::GlobalVariable(*module,
-                                          constant->getType(),
-                                          true,
-                                          llvm::GlobalVariable::InternalLinkage,
-                                          constant,
-                                          encoding);
-#if defined __APPLE__
-  global->setSection("__mull,.mull_mutants");
-#else
-  global->setSection(".mull_mutants");
-#endif
-  llvm::appendToUsed(*module, { global });
+void MutationPoint::recordMutation(MutantManifestWriter &manifest) const {
+  manifest.add(getMutatorIdentifier(),
+               sourceLocation.filePath,
+               sourceLocation.line,
+               sourceLocation.column,
+               endLocation.line,
+               endLocation.column);
 }
 
 std::string MutationPoint::getMutatorIdentifier() const {
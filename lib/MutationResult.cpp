@@ -0,0 +1,49 @@
+#include "mull/MutationResult.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace mull;
+
+std::vector<std::unique_ptr<MutationResult>>
+mull::runRemaining(std::vector<std::unique_ptr<Mutant>> &mutants,
+                   const std::function<std::optional<ExecutionResult>(const Mutant &)> &known,
+                   const RunMutants &run) {
+  std::vector<std::unique_ptr<MutationResult>> results(mutants.size());
+  std::unordered_map<const Mutant *, size_t> positions;
+  std::vector<std::unique_ptr<Mutant>> remaining;
+  for (size_t i = 0; i < mutants.size(); i++) {
+    if (auto result = known(*mutants[i])) {
+      results[i] = std::make_unique<MutationResult>(std::move(*result), mutants[i].get());
+    } else {
+      positions[mutants[i].get()] = i;
+      remaining.push_back(std::move(mutants[i]));
+    }
+  }
+
+  auto fresh = run(remaining);
+  for (auto &result : fresh) {
+    results[positions.at(result->getMutant())] = std::move(result);
+  }
+  for (auto &mutant : remaining) {
+    size_t position = positions.at(mutant.get());
+    mutants[position] = std::move(mutant);
+  }
+  return results;
+}
+
+size_t mull::countKillableMutants(const std::vector<std::unique_ptr<MutationResult>> &results) {
+  return std::count_if(results.begin(), results.end(), [](auto &result) {
+    return result->getExecutionResult().status != Equivalent;
+  });
+}
+
+int mull::mutationScore(const std::vector<std::unique_ptr<MutationResult>> &results) {
+  size_t killable = countKillableMutants(results);
+  size_t killed = std::count_if(results.begin(), results.end(), [](auto &result) {
+    ExecutionStatus status = result->getExecutionResult().status;
+    return status != Equivalent && status != NotCovered && status != Passed;
+  });
+  auto rawScore = killable ? double(killed) / double(killable) : 1.0;
+  return int(rawScore * 100);
+}
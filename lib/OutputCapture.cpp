@@ -0,0 +1,87 @@
+#include "mull/OutputCapture.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace mull;
+
+OutputCapture::OutputCapture(size_t limit, std::string spillPath)
+    : limit(limit), total(0), spillPath(std::move(spillPath)), spillFD(-1) {}
+
+OutputCapture::~OutputCapture() {
+  if (spillFD != -1) {
+    close(spillFD);
+  }
+}
+
+void OutputCapture::spill(const char *data, size_t size) {
+  if (spillFD == -1) {
+    /// Opened on the first byte: silent runs leave no empty files behind
+    spillFD = open(spillPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (spillFD == -1) {
+      spillPath.clear();
+      return;
+    }
+  }
+  while (size > 0) {
+    ssize_t written = write(spillFD, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return;
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+void OutputCapture::append(const char *data, size_t size) {
+  total += size;
+  if (!spillPath.empty()) {
+    spill(data, size);
+  }
+  if (limit == 0) {
+    head.append(data, size);
+    return;
+  }
+  size_t headLimit = limit / 2;
+  size_t tailLimit = limit - headLimit;
+  if (head.size() < headLimit) {
+    size_t count = std::min(size, headLimit - head.size());
+    head.append(data, count);
+    data += count;
+    size -= count;
+  }
+  tail.append(data, size);
+  /// Trimmed in bulk rather than on every chunk: at most twice the limit is ever held
+  if (tail.size() > 2 * tailLimit) {
+    tail.erase(0, tail.size() - tailLimit);
+  }
+}
+
+std::string OutputCapture::take() {
+  if (limit != 0) {
+    size_t tailLimit = limit - limit / 2;
+    if (tail.size() > tailLimit) {
+      tail.erase(0, tail.size() - tailLimit);
+    }
+  }
+  std::string output = std::move(head);
+  size_t omitted = total - output.size() - tail.size();
+  if (omitted != 0) {
+    output += "\n[mull: " + std::to_string(omitted) + " bytes omitted]\n";
+  }
+  output += tail;
+
+  head.clear();
+  tail.clear();
+  total = 0;
+  if (spillFD != -1) {
+    close(spillFD);
+    spillFD = -1;
+  }
+  return output;
+}
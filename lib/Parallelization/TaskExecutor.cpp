@@ -1,37 +1,28 @@
 #include "mull/Parallelization/TaskExecutor.h"
 #include "mull/Diagnostics/Diagnostics.h"
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
 namespace mull {
-std::vector<int> taskBatches(size_t itemsCount, size_t tasks) {
-  assert(itemsCount >= tasks);
-
-  std::vector<int> result;
-
-  int n = itemsCount;
-  int m = tasks;
-
-  int q = 0;
-  int r = 0;
-  int start = 0;
-  int end = 0;
-  int k = 0;
-  int s = 0;
-
-  for (k = 0; k < m; k++) {
-    q = (n - k) / m;
-    r = (n - k) % m;
-
-    start = end;
-    end = end + q + (r != 0);
+WorkQueue::WorkQueue(size_t itemsCount, size_t workers)
+    : next(0), itemsCount(itemsCount), workers(workers) {
+  assert(workers != 0);
+}
 
-    s = s + end - start;
-    result.push_back(end - start);
+bool WorkQueue::take(size_t &begin, size_t &end) {
+  size_t current = next.load();
+  while (current < itemsCount) {
+    /// A quarter of a worker's fair share of what is left: big enough to keep contention low,
+    /// small enough that the last ranges take about the same time on every worker
+    size_t size = std::max<size_t>(1, (itemsCount - current) / (4 * workers));
+    if (next.compare_exchange_weak(current, current + size)) {
+      begin = current;
+      end = current + size;
+      return true;
+    }
   }
-
-  assert(s == n);
-  return result;
+  return false;
 }
 
 void printTimeSummary(Diagnostics &diagnostics, MetricsMeasure measure) {
@@ -16,7 +16,6 @@ void ApplyMutationTask::operator()(iterator begin, iterator end, Out &storage,
                                    progress_counter &counter) {
   for (auto it = begin; it != end; ++it, counter.increment()) {
     auto point = *it;
-    point->recordMutation();
     point->applyMutation();
     if (config.debug.slowIRVerification) {
       auto module = point->getBitcode()->getModule();
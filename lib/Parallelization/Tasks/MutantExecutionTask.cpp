@@ -3,46 +3,144 @@
 #include "mull/Config/Configuration.h"
 #include "mull/Diagnostics/Diagnostics.h"
 #include "mull/ExecutionResult.h"
+#include "mull/ForkServerRunner.h"
 #include "mull/Parallelization/Progress.h"
-#include "mull/Runner.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/Sandbox.h"
 #include "mull/SourceLocation.h"
+#include "mull/TestFramework.h"
 
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/Path.h>
+
+#include <algorithm>
+#include <cctype>
+#include <limits.h>
 #include <sstream>
 
 using namespace mull;
 using namespace std::string_literals;
 
+/// Identifiers contain paths, and can be longer than a file name may be
+static std::string outputFile(const std::string &directory, const std::string &identifier) {
+  std::string name;
+  for (char c : identifier) {
+    name += std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-' ? c : '_';
+  }
+  if (name.size() > 200) {
+    llvm::MD5 md5;
+    md5.update(identifier);
+    llvm::MD5::MD5Result hash;
+    md5.final(hash);
+    name = name.substr(name.size() - 160) + "-" + hash.digest().str().str();
+  }
+  llvm::SmallString<PATH_MAX> path(directory);
+  llvm::sys::path::append(path, name);
+  return path.str().str();
+}
+
 MutantExecutionTask::MutantExecutionTask(const Configuration &configuration,
                                          Diagnostics &diagnostics, const std::string &executable,
-                                         ExecutionResult &baseline,
-                                         const std::vector<std::string> &extraArgs)
+                                         const ExecutionResult &baseline,
+                                         const std::vector<std::string> &extraArgs,
+                                         const MutationResultListener &listener)
     : configuration(configuration), diagnostics(diagnostics), executable(executable),
-      baseline(baseline), extraArgs(extraArgs) {}
+      baseline(baseline), extraArgs(extraArgs), listener(listener),
+      forkServerEnabled(configuration.forkServer) {}
+
+MutantExecutionTask::MutantExecutionTask(MutantExecutionTask &&) noexcept = default;
+MutantExecutionTask::~MutantExecutionTask() = default;
 
 void MutantExecutionTask::operator()(iterator begin, iterator end, Out &storage,
                                      progress_counter &counter) {
-  Runner runner(diagnostics);
+  Sandbox sandbox(diagnostics);
+  TestFramework framework(configuration.testFramework);
+  std::vector<std::string> arguments(extraArgs);
+  std::vector<std::string> failureMarkers;
+  if (configuration.failFast) {
+    auto failFastArguments = framework.failFastArguments();
+    arguments.insert(arguments.end(), failFastArguments.begin(), failFastArguments.end());
+    failureMarkers = configuration.failFastMarkers;
+    if (failureMarkers.empty()) {
+      failureMarkers = framework.failureMarkers();
+    }
+  }
   std::stringstream debugMessage;
   for (auto it = begin; it != end; ++it, counter.increment()) {
     auto &mutant = *it;
     ExecutionResult result;
     if (mutant->isCovered()) {
-      result = runner.runProgram(executable,
-                                 extraArgs,
-                                 { { mutant->getIdentifier(), "1" } },
-                                 std::max(30LL, baseline.runningTime * 10),
-                                 configuration.captureMutantOutput,
-                                 false,
-                                 std::nullopt);
+      /// The fork server always runs the whole test program, the selected tests are cheaper
+      std::vector<std::string> selection =
+          framework.selectTestsArguments(mutant->getCoveringTests());
+      bool selectTests = !selection.empty();
+      /// CPU time does not grow when the machine is busy, unlike wall time: the budget holds
+      /// with every core running a mutant. The wall limit only catches programs that block, it
+      /// leaves room for the CPU budget on a busy machine.
+      long long baselineCPUTime =
+          selectTests ? mutant->getBaselineCPUTime() : baseline.cpuTime;
+      SandboxLimits limits;
+      limits.cpuTime = std::max(30LL, baselineCPUTime * 10);
+      limits.wallTime = std::max<long long>(configuration.timeout, limits.cpuTime * 2);
+      limits.resources = configuration.sandbox;
+      limits.outputLimit = configuration.mutantOutputLimit;
+      if (!configuration.mutantOutputDirectory.empty()) {
+        limits.outputFile =
+            outputFile(configuration.mutantOutputDirectory, mutant->getIdentifier());
+      }
+      std::optional<ExecutionResult> forkResult;
+      if (forkServerEnabled && !selectTests && !forkServer) {
+        forkServer = std::make_unique<ForkServerRunner>(diagnostics);
+        /// The output is watched for failure markers even if it is not kept
+        if (!forkServer->start(executable,
+                               arguments,
+                               {},
+                               configuration.sandbox,
+                               configuration.timeout,
+                               configuration.captureMutantOutput || !failureMarkers.empty())) {
+          diagnostics.warning("Fork server is not available, falling back to regular runs");
+          forkServer.reset();
+          forkServerEnabled = false;
+        }
+      }
+      if (forkServer && !selectTests) {
+        forkResult = forkServer->runMutant(mutant->getIdentifier(),
+                                           limits,
+                                           configuration.captureMutantOutput,
+                                           failureMarkers);
+        if (!forkResult) {
+          /// The server died (e.g. the mutant corrupted it before forking), restart it next time
+          diagnostics.debug("Fork server stopped responding, restarting");
+          forkServer.reset();
+        }
+      }
+      if (forkResult) {
+        result = std::move(*forkResult);
+      } else {
+        std::vector<std::string> mutantArguments(arguments);
+        mutantArguments.insert(mutantArguments.end(), selection.begin(), selection.end());
+        /// Programs built by the AST frontend check getenv("<identifier>") in the mutated code
+        result = sandbox.run(executable,
+                             mutantArguments,
+                             { { runtime::MutantEnvironmentVariable, mutant->getIdentifier() },
+                               { mutant->getIdentifier(), "1" } },
+                             limits,
+                             configuration.captureMutantOutput,
+                             failureMarkers);
+      }
     } else {
       result.status = NotCovered;
     }
-    storage.push_back(std::make_unique<MutationResult>(result, mutant.get()));
+    if (listener) {
+      listener(*mutant, result);
+    }
     SourceLocation sourceLocation = mutant->getSourceLocation();
     debugMessage << sourceLocation.filePath << ":";
     debugMessage << sourceLocation.line << ":" << sourceLocation.column << " ExecutionResult: ";
     debugMessage << result.getStatusAsString();
     diagnostics.debug(debugMessage.str());
     debugMessage.str(std::string());
+    storage.push_back(std::make_unique<MutationResult>(std::move(result), mutant.get()));
   }
 }
@@ -2,10 +2,17 @@
 #include "mull/Config/Configuration.h"
 #include "mull/MutationPoint.h"
 #include "mull/Parallelization/Progress.h"
+#include "mull/Runtime/Runtime.h"
 #include <llvm/IR/Constant.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace mull;
 
@@ -13,13 +20,40 @@ void CloneMutatedFunctionsTask::operator()(iterator begin, iterator end, Out &st
                                            progress_counter &counter) {
   for (auto it = begin; it != end; it++, counter.increment()) {
     Bitcode &bitcode = **it;
-    cloneFunctions(bitcode);
+    cloneFunctions(bitcode, schemata);
   }
 }
 
-void CloneMutatedFunctionsTask::cloneFunctions(Bitcode &bitcode) {
+/// The schema branches around the instruction: it must be free to move into a block of its own
+static bool canGuard(const llvm::Instruction &instruction) {
+  if (instruction.isTerminator() || instruction.isEHPad() ||
+      llvm::isa<llvm::PHINode>(instruction) || llvm::isa<llvm::AllocaInst>(instruction) ||
+      instruction.getType()->isTokenTy()) {
+    return false;
+  }
+  if (auto *call = llvm::dyn_cast<llvm::CallInst>(&instruction)) {
+    return !call->isMustTailCall();
+  }
+  return true;
+}
+
+void CloneMutatedFunctionsTask::cloneFunctions(Bitcode &bitcode, bool schemata) {
   for (auto &pair : bitcode.getMutationPointsMap()) {
     llvm::Function *original = pair.first;
+    if (schemata && pair.second.size() > 1 &&
+        std::all_of(pair.second.begin(), pair.second.end(), [&](MutationPoint *point) {
+          return canGuard(point->getAddress().findInstruction(original));
+        })) {
+      llvm::ValueToValueMapTy map;
+      llvm::Function *schema = llvm::CloneFunction(original, map);
+      schema->setLinkage(llvm::GlobalValue::InternalLinkage);
+      for (MutationPoint *point : pair.second) {
+        point->setMutatedFunction(schema);
+      }
+      schema->setName("mull_" + original->getName() + "_schema");
+      bitcode.addMutantSchema(original);
+      continue;
+    }
     for (MutationPoint *point : pair.second) {
       llvm::ValueToValueMapTy map;
       llvm::Function *mutatedFunction = llvm::CloneFunction(original, map);
@@ -88,9 +122,24 @@ void InsertMutationTrampolinesTask::insertTrampolines(Bitcode &bitcode,
                                                       const Configuration &configuration) {
   llvm::Module *module = bitcode.getModule();
   llvm::LLVMContext &context = module->getContext();
-  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
-  llvm::FunctionType *getEnvType = llvm::FunctionType::get(charPtr, { charPtr }, false);
-  llvm::Value *getenv = module->getOrInsertFunction("getenv", getEnvType).getCallee();
+  llvm::IntegerType *intType = llvm::Type::getInt32Ty(context);
+
+  /// Points sharing an identifier (e.g. in linkonce functions) are enabled together
+  std::vector<std::string> identifiers;
+  std::unordered_map<std::string, uint32_t> mutantIndices;
+  for (auto &pair : bitcode.getMutationPointsMap()) {
+    for (MutationPoint *point : pair.second) {
+      auto inserted = mutantIndices.emplace(point->getUserIdentifier(), identifiers.size());
+      if (inserted.second) {
+        identifiers.push_back(point->getUserIdentifier());
+      }
+    }
+  }
+  if (identifiers.empty()) {
+    return;
+  }
+  llvm::GlobalVariable *activeMutant = runtime::insertMutantActivation(*module, identifiers);
+
   for (auto pair : bitcode.getMutationPointsMap()) {
     llvm::Function *original = pair.first;
 
@@ -112,50 +161,75 @@ void InsertMutationTrampolinesTask::insertTrampolines(Bitcode &bitcode,
     if (configuration.debug.traceMutants) {
       insertTrace(entry, "mull-trace: entering %s\n", original->getName().str());
     }
+    llvm::BasicBlock *dispatch = entry;
+    if (configuration.splitStream) {
+      std::vector<uint32_t> indices;
+      for (auto &point : pair.second) {
+        uint32_t index = mutantIndices[point->getUserIdentifier()];
+        if (std::find(indices.begin(), indices.end(), index) == indices.end()) {
+          indices.push_back(index);
+        }
+      }
+      /// A mutant forked here enables itself: the active mutant is read after the split
+      dispatch = runtime::insertSplitPoint(*module, entry, indices);
+    }
+    auto active = new llvm::LoadInst(intType, activeMutant, "active_mutant", dispatch);
     new llvm::StoreInst(bitcode.getModule()->getFunction(anyPoint->getOriginalFunctionName()),
                         trampoline,
                         originalBlock);
     llvm::BranchInst::Create(trampolineCall, originalBlock);
-    llvm::BasicBlock *head = originalBlock;
-
-    for (auto &point : pair.second) {
-      auto name = llvm::ConstantDataArray::getString(context, point->getUserIdentifier());
-      auto *global = new llvm::GlobalVariable(
-          *module, name->getType(), true, llvm::GlobalValue::PrivateLinkage, name);
-
-      llvm::BasicBlock *mutationCheckBlock =
-          llvm::BasicBlock::Create(context, point->getUserIdentifier() + "_check", original);
+    if (bitcode.hasMutantSchema(original)) {
+      /// A single copy for every mutant: a switch finds out whether it is one of them
+      llvm::BasicBlock *schemaBlock = llvm::BasicBlock::Create(context, "schema", original);
       if (configuration.debug.traceMutants) {
         insertTrace(
-            mutationCheckBlock, "mull-trace: checking for %s\n", point->getUserIdentifier());
+            schemaBlock, "mull-trace: jumping over to schema %s\n", original->getName().str());
       }
-      llvm::Value *nullPtr = llvm::Constant::getNullValue(charPtr);
-      llvm::CmpInst *predicate = llvm::CmpInst::Create(llvm::Instruction::ICmp,
-                                                       llvm::ICmpInst::ICMP_NE,
-                                                       nullPtr,
-                                                       nullPtr,
-                                                       "is_enabled",
-                                                       mutationCheckBlock);
-      llvm::Value *zero = llvm::Constant::getNullValue(llvm::Type::getInt64Ty(context));
-      auto mutantName =
-          llvm::ConstantExpr::getInBoundsGetElementPtr(name->getType(), global, { zero, zero });
-      auto getEnvCall =
-          llvm::CallInst::Create(getEnvType, getenv, { mutantName }, "check_mutation", predicate);
-      predicate->setOperand(0, getEnvCall);
-
-      llvm::BasicBlock *mutationBlock =
-          llvm::BasicBlock::Create(context, point->getUserIdentifier(), original);
-      if (configuration.debug.traceMutants) {
-        insertTrace(mutationBlock, "mull-trace: jumping over to %s\n", point->getUserIdentifier());
+      new llvm::StoreInst(anyPoint->getMutatedFunction(), trampoline, schemaBlock);
+      llvm::BranchInst::Create(trampolineCall, schemaBlock);
+      auto *mutantSwitch =
+          llvm::SwitchInst::Create(active, originalBlock, pair.second.size(), dispatch);
+      std::unordered_set<uint32_t> cases;
+      for (auto &point : pair.second) {
+        uint32_t index = mutantIndices[point->getUserIdentifier()];
+        if (cases.insert(index).second) {
+          mutantSwitch->addCase(llvm::ConstantInt::get(intType, index), schemaBlock);
+        }
       }
-      new llvm::StoreInst(point->getMutatedFunction(), trampoline, mutationBlock);
+    } else {
+      llvm::BasicBlock *head = originalBlock;
 
-      llvm::BranchInst::Create(mutationBlock, head, predicate, mutationCheckBlock);
-      llvm::BranchInst::Create(trampolineCall, mutationBlock);
-      head = mutationCheckBlock;
+      for (auto &point : pair.second) {
+        llvm::BasicBlock *mutationCheckBlock =
+            llvm::BasicBlock::Create(context, point->getUserIdentifier() + "_check", original);
+        if (configuration.debug.traceMutants) {
+          insertTrace(
+              mutationCheckBlock, "mull-trace: checking for %s\n", point->getUserIdentifier());
+        }
+        auto index = llvm::ConstantInt::get(intType, mutantIndices[point->getUserIdentifier()]);
+        llvm::CmpInst *predicate = llvm::CmpInst::Create(llvm::Instruction::ICmp,
+                                                         llvm::ICmpInst::ICMP_EQ,
+                                                         active,
+                                                         index,
+                                                         "is_enabled",
+                                                         mutationCheckBlock);
+
+        llvm::BasicBlock *mutationBlock =
+            llvm::BasicBlock::Create(context, point->getUserIdentifier(), original);
+        if (configuration.debug.traceMutants) {
+          insertTrace(
+              mutationBlock, "mull-trace: jumping over to %s\n", point->getUserIdentifier());
+        }
+        new llvm::StoreInst(point->getMutatedFunction(), trampoline, mutationBlock);
+
+        llvm::BranchInst::Create(mutationBlock, head, predicate, mutationCheckBlock);
+        llvm::BranchInst::Create(trampolineCall, mutationBlock);
+        head = mutationCheckBlock;
+      }
+
+      llvm::BranchInst::Create(head, dispatch);
     }
 
-    llvm::BranchInst::Create(head, entry);
     std::vector<llvm::Value *> args;
     for (auto &arg : original->args()) {
       args.push_back(&arg);
@@ -177,3 +251,106 @@ void InsertMutationTrampolinesTask::insertTrampolines(Bitcode &bitcode,
     }
   }
 }
+
+void ApplyMutantSchemataTask::operator()(iterator begin, iterator end, Out &storage,
+                                         progress_counter &counter) {
+  for (auto it = begin; it != end; it++, counter.increment()) {
+    Bitcode &bitcode = **it;
+    applySchemata(bitcode);
+  }
+}
+
+/// Branching around instructions of the entry block would move the allocas that follow them out
+/// of it, making them dynamic
+static void hoistAllocas(llvm::Function &function) {
+  llvm::BasicBlock &entry = function.getEntryBlock();
+  llvm::Instruction *firstNonAlloca = nullptr;
+  for (auto it = entry.begin(); it != entry.end();) {
+    llvm::Instruction &instruction = *it++;
+    auto *alloca = llvm::dyn_cast<llvm::AllocaInst>(&instruction);
+    if (!alloca || !alloca->isStaticAlloca()) {
+      if (!firstNonAlloca) {
+        firstNonAlloca = &instruction;
+      }
+      continue;
+    }
+    if (firstNonAlloca) {
+      alloca->moveBefore(firstNonAlloca);
+    }
+  }
+}
+
+/// Runs a mutated copy of `instruction` instead of it when `enabled` holds:
+///
+///   head:     ... br %enabled, %mutated, %original
+///   mutated:  <mutated copy>   br %tail
+///   original: <instruction>    br %tail
+///   tail:     phi [<mutated copy>, %mutated], [<instruction>, %original] ...
+static void guardMutation(MutationPoint &point, llvm::Instruction &instruction,
+                          llvm::Value *enabled) {
+  llvm::LLVMContext &context = instruction.getContext();
+  llvm::MDNode *unlikely = llvm::MDBuilder(context).createBranchWeights(1, 1000);
+  llvm::Instruction *mutatedTerminator = nullptr;
+  llvm::Instruction *originalTerminator = nullptr;
+  llvm::SplitBlockAndInsertIfThenElse(
+      enabled, &instruction, &mutatedTerminator, &originalTerminator, unlikely);
+  llvm::BasicBlock *tail = instruction.getParent();
+  instruction.moveBefore(originalTerminator);
+
+  llvm::Instruction *mutated = instruction.clone();
+  mutated->insertBefore(mutatedTerminator);
+  if (!instruction.getType()->isVoidTy()) {
+    llvm::IRBuilder<> builder(&tail->front());
+    llvm::PHINode *phi = builder.CreatePHI(instruction.getType(), 2);
+    instruction.replaceUsesWithIf(phi, [phi](llvm::Use &use) { return use.getUser() != phi; });
+    phi->addIncoming(mutated, mutatedTerminator->getParent());
+    phi->addIncoming(&instruction, originalTerminator->getParent());
+  }
+  /// May replace the copy altogether, the phi follows
+  point.applyMutation(*mutated);
+}
+
+void ApplyMutantSchemataTask::applySchemata(Bitcode &bitcode) {
+  llvm::Module *module = bitcode.getModule();
+  llvm::GlobalVariable *activeMutant = nullptr;
+  llvm::StringMap<uint32_t> mutantIndices;
+  for (auto &pair : bitcode.getMutationPointsMap()) {
+    if (!bitcode.hasMutantSchema(pair.first)) {
+      continue;
+    }
+    if (!activeMutant) {
+      activeMutant = runtime::getActiveMutant(*module);
+      mutantIndices = runtime::getMutantIndices(*module);
+    }
+    llvm::Function *schema = pair.second.front()->getMutatedFunction();
+
+    /// Guards move the instructions around, they are all found first. Of the points sharing an
+    /// identifier, the trampoline used to pick the last one.
+    std::unordered_map<uint32_t, std::pair<MutationPoint *, llvm::Instruction *>> mutants;
+    std::vector<uint32_t> order;
+    for (MutationPoint *point : pair.second) {
+      uint32_t index = mutantIndices[point->getUserIdentifier()];
+      auto &mutant = mutants[index];
+      if (!mutant.first) {
+        order.push_back(index);
+      }
+      mutant = { point, &point->getAddress().findInstruction(schema) };
+    }
+
+    hoistAllocas(*schema);
+    /// The schema is only called with one of its mutants active, which stays so until it returns
+    llvm::BasicBlock &entry = schema->getEntryBlock();
+    auto afterAllocas = entry.getFirstInsertionPt();
+    while (llvm::isa<llvm::AllocaInst>(*afterAllocas)) {
+      afterAllocas++;
+    }
+    llvm::IRBuilder<> builder(&entry, afterAllocas);
+    llvm::Value *active = builder.CreateLoad(builder.getInt32Ty(), activeMutant, "active_mutant");
+    for (uint32_t index : order) {
+      auto &[point, instruction] = mutants[index];
+      builder.SetInsertPoint(instruction);
+      llvm::Value *enabled = builder.CreateICmpEQ(active, builder.getInt32(index), "is_enabled");
+      guardMutation(*point, *instruction, enabled);
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#include "mull/Parallelization/Tasks/SplitStreamTask.h"
+
+#include "mull/Config/Configuration.h"
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/ExecutionResult.h"
+#include "mull/ForkServerRunner.h"
+#include "mull/Parallelization/Progress.h"
+#include "mull/Sandbox.h"
+#include "mull/SourceLocation.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+using namespace mull;
+
+SplitStreamTask::SplitStreamTask(const Configuration &configuration, Diagnostics &diagnostics,
+                                 const std::string &executable, const ExecutionResult &baseline,
+                                 const std::vector<std::string> &extraArgs,
+                                 const MutationResultListener &listener)
+    : configuration(configuration), diagnostics(diagnostics), executable(executable),
+      baseline(baseline), extraArgs(extraArgs), listener(listener) {}
+
+void SplitStreamTask::operator()(iterator begin, iterator end, Out &storage,
+                                 progress_counter &counter) {
+  /// Same budget as a regular run of the mutant, which is an upper bound for the part after the
+  /// split point. The stream itself is the baseline run, interrupted by the mutants.
+  SandboxLimits limits;
+  limits.cpuTime = std::max(30LL, baseline.cpuTime * 10);
+  limits.wallTime = std::max<long long>(configuration.timeout, limits.cpuTime * 2);
+  limits.resources = configuration.sandbox;
+
+  std::stringstream debugMessage;
+  for (auto it = begin; it != end; ++it, counter.increment()) {
+    std::unordered_map<std::string, Mutant *> pending;
+    for (Mutant *mutant : *it) {
+      pending.emplace(mutant->getIdentifier(), mutant);
+    }
+    ForkServerRunner stream(diagnostics);
+    if (!stream.startSplitStream(executable, extraArgs, configuration.sandbox)) {
+      continue;
+    }
+    while (!pending.empty()) {
+      auto identifier = stream.nextSplit(limits.wallTime);
+      if (!identifier) {
+        break;
+      }
+      auto found = pending.find(*identifier);
+      if (found == pending.end()) {
+        /// Another stream's mutant, or one that already ran
+        if (!stream.skipSplit()) {
+          break;
+        }
+        continue;
+      }
+      auto result = stream.runSplit(limits);
+      if (!result) {
+        break;
+      }
+      Mutant *mutant = found->second;
+      pending.erase(found);
+      if (listener) {
+        listener(*mutant, *result);
+      }
+      SourceLocation sourceLocation = mutant->getSourceLocation();
+      debugMessage << sourceLocation.filePath << ":";
+      debugMessage << sourceLocation.line << ":" << sourceLocation.column
+                   << " ExecutionResult (split stream): ";
+      debugMessage << result->getStatusAsString();
+      diagnostics.debug(debugMessage.str());
+      debugMessage.str(std::string());
+      storage.push_back(std::make_unique<MutationResult>(std::move(*result), mutant));
+    }
+    stream.stop();
+  }
+}
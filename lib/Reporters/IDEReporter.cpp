@@ -26,6 +26,10 @@ static bool mutantNotCovered(const ExecutionStatus &status) {
   return status == ExecutionStatus::NotCovered;
 }
 
+static bool mutantEquivalent(const ExecutionStatus &status) {
+  return status == ExecutionStatus::Equivalent;
+}
+
 static void printMutant(Diagnostics &diagnostics, const std::string &reportFilePath,
                         MutatorsFactory &factory, SourceCodeReader &sourceCodeReader,
                         const Mutant &mutant, const std::string &status) {
@@ -100,6 +104,7 @@ void IDEReporter::reportResults(const Result &result) {
   std::vector<Mutant *> killedMutants;
   std::vector<Mutant *> survivedMutants;
   std::vector<Mutant *> notCoveredMutants;
+  std::vector<Mutant *> equivalentMutants;
   for (auto &mutationResult : result.getMutationResults()) {
     auto mutant = mutationResult->getMutant();
     auto &executionResult = mutationResult->getExecutionResult();
@@ -108,13 +113,17 @@ void IDEReporter::reportResults(const Result &result) {
       survivedMutants.push_back(mutant);
     } else if (mutantNotCovered(executionResult.status)) {
       notCoveredMutants.push_back(mutant);
+    } else if (mutantEquivalent(executionResult.status)) {
+      equivalentMutants.push_back(mutant);
     } else {
       killedMutants.push_back(mutant);
     }
   }
 
-  assert(killedMutants.size() + survivedMutants.size() + notCoveredMutants.size() ==
+  assert(killedMutants.size() + survivedMutants.size() + notCoveredMutants.size() +
+             equivalentMutants.size() ==
          result.getMutationResults().size());
+  size_t totalSize = countKillableMutants(result.getMutationResults());
 
   MutatorsFactory factory(diagnostics);
   factory.init();
@@ -125,7 +134,7 @@ void IDEReporter::reportResults(const Result &result) {
                  factory,
                  sourceCodeReader,
                  killedMutants,
-                 result.getMutants().size(),
+                 totalSize,
                  "Killed");
   }
 
@@ -134,18 +143,17 @@ void IDEReporter::reportResults(const Result &result) {
                factory,
                sourceCodeReader,
                survivedMutants,
-               result.getMutants().size(),
+               totalSize,
                "Survived");
   printMutants(diagnostics,
                reportFilePath,
                factory,
                sourceCodeReader,
                notCoveredMutants,
-               result.getMutants().size(),
+               totalSize,
                "Not Covered");
 
-  auto rawScore = double(killedMutants.size()) / double(result.getMutants().size());
-  auto score = int(rawScore * 100);
+  int score = mutationScore(result.getMutationResults());
   std::string scoreMsg = std::string("Mutation score: ") + std::to_string(score) + '%';
 
   if (reportFilePath.empty()) {
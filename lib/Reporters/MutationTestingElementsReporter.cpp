@@ -30,7 +30,8 @@ static bool mutantSurvived(const ExecutionStatus &status) {
 
 static json11::Json createFiles(Diagnostics &diagnostics, const Result &result,
                                 const std::set<Mutant *> &killedMutants,
-                                const std::set<Mutant *> &notCoveredMutants) {
+                                const std::set<Mutant *> &notCoveredMutants,
+                                const std::set<Mutant *> &equivalentMutants) {
   SourceManager sourceManager;
 
   Json::object filesJSON;
@@ -80,6 +81,8 @@ static json11::Json createFiles(Diagnostics &diagnostics, const Result &result,
         status = "Killed";
       } else if (notCoveredMutants.count(mutant) != 0) {
         status = "NoCoverage";
+      } else if (equivalentMutants.count(mutant) != 0) {
+        status = "Ignored";
       }
 
       auto mutator = factory.getMutator(mutant->getMutatorIdentifier());
@@ -139,25 +142,31 @@ void MutationTestingElementsReporter::reportResults(const Result &result) {
 
   std::set<Mutant *> killedMutants;
   std::set<Mutant *> notCoveredMutants;
+  std::set<Mutant *> equivalentMutants;
   for (auto &mutationResult : result.getMutationResults()) {
     auto mutant = mutationResult->getMutant();
     auto &executionResult = mutationResult->getExecutionResult();
 
     if (executionResult.status == NotCovered) {
       notCoveredMutants.insert(mutant);
+    } else if (executionResult.status == Equivalent) {
+      equivalentMutants.insert(mutant);
     } else if (!mutantSurvived(executionResult.status)) {
       killedMutants.insert(mutant);
     }
   }
 
-  auto rawScore = double(killedMutants.size()) / double(result.getMutants().size());
-  auto score = uint(rawScore * 100);
+  int score = mutationScore(result.getMutationResults());
 
   Json json =
       Json::object{ { "config", mullInformation },
-                    { "mutationScore", (int)score },
+                    { "mutationScore", score },
                     { "thresholds", Json::object{ { "high", 80 }, { "low", 60 } } },
-                    { "files", createFiles(diagnostics, result, killedMutants, notCoveredMutants) },
+                    { "files", createFiles(diagnostics,
+                                                   result,
+                                                   killedMutants,
+                                                   notCoveredMutants,
+                                                   equivalentMutants) },
                     { "schemaVersion", "1.7" },
                     {
                         "framework",
@@ -69,6 +69,9 @@ static std::string patchFilename(const std::string patchesPath, const Mutant &mu
     case ExecutionStatus::NotCovered:
       return "uncovered-";
       break;
+    case ExecutionStatus::Equivalent:
+      return "equivalent-";
+      break;
     default:
       return "killed-";
     }
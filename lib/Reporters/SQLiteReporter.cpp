@@ -61,60 +61,115 @@ std::string mull::SQLiteReporter::getDatabasePath() {
   return databasePath;
 }
 
-void mull::SQLiteReporter::reportResults(const Result &result) {
-  sqlite3 *database;
-  sqlite3_open(databasePath.c_str(), &database);
-
-  createTables(diagnostics, database);
+void mull::SQLiteReporter::continueReport(const std::string &path) {
+  databasePath = path;
+  continued = true;
+}
 
-  sqlite_exec(diagnostics, database, "BEGIN TRANSACTION");
+SQLiteReporter::~SQLiteReporter() {
+  closeJournal();
+}
 
-  const char *insertInformationQuery = "INSERT INTO information VALUES (?1, ?2)";
-  sqlite3_stmt *insertInformationStmt;
-  sqlite3_prepare(database, insertInformationQuery, -1, &insertInformationStmt, nullptr);
+static void insertMutant(sqlite3_stmt *stmt, const Mutant &mutant,
+                         const ExecutionResult &execution) {
+  auto &location = mutant.getSourceLocation();
+  auto &endLocation = mutant.getEndLocation();
+
+  int index = 1;
+
+  sqlite3_bind_text(stmt, index++, mutant.getIdentifier().c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, index++, mutant.getMutatorIdentifier().c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, index++, location.filePath.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, index++, location.directory.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int(stmt, index++, location.line);
+  sqlite3_bind_int(stmt, index++, location.column);
+  sqlite3_bind_int(stmt, index++, endLocation.line);
+  sqlite3_bind_int(stmt, index++, endLocation.column);
+  sqlite3_bind_int(stmt, index++, execution.status);
+  sqlite3_bind_int64(stmt, index++, execution.runningTime);
+  /// The outputs may be large, and outlive the statement: no need for SQLite to copy them
+  sqlite3_bind_text(stmt, index++, execution.stdoutOutput.c_str(), -1, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, index++, execution.stderrOutput.c_str(), -1, SQLITE_STATIC);
+  sqlite3_step(stmt);
+  sqlite3_clear_bindings(stmt);
+  sqlite3_reset(stmt);
+}
 
-  for (auto &info : mullInformation) {
-    sqlite3_bind_text(insertInformationStmt, 1, info.first.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(insertInformationStmt, 2, info.second.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_step(insertInformationStmt);
-    sqlite3_clear_bindings(insertInformationStmt);
-    sqlite3_reset(insertInformationStmt);
+void mull::SQLiteReporter::openJournal() {
+  if (journal) {
+    return;
+  }
+  sqlite3_open(databasePath.c_str(), &journal);
+  /// Each result is committed on its own: with WAL and without syncing every commit this stays
+  /// cheap, and committed results survive the run being killed
+  sqlite_exec(diagnostics, journal, "PRAGMA journal_mode = WAL");
+  sqlite_exec(diagnostics, journal, "PRAGMA synchronous = NORMAL");
+
+  createTables(diagnostics, journal);
+
+  /// A continued report already has its information, and results that must not be duplicated
+  if (continued) {
+    sqlite3_stmt *selectMutantsStmt;
+    sqlite3_prepare(journal, "SELECT mutant_id FROM mutant", -1, &selectMutantsStmt, nullptr);
+    while (sqlite3_step(selectMutantsStmt) == SQLITE_ROW) {
+      journaled.insert(reinterpret_cast<char const *>(sqlite3_column_text(selectMutantsStmt, 0)));
+    }
+    sqlite3_finalize(selectMutantsStmt);
+  } else {
+    sqlite_exec(diagnostics, journal, "BEGIN TRANSACTION");
+    const char *insertInformationQuery = "INSERT INTO information VALUES (?1, ?2)";
+    sqlite3_stmt *insertInformationStmt;
+    sqlite3_prepare(journal, insertInformationQuery, -1, &insertInformationStmt, nullptr);
+
+    for (auto &info : mullInformation) {
+      sqlite3_bind_text(insertInformationStmt, 1, info.first.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_bind_text(insertInformationStmt, 2, info.second.c_str(), -1, SQLITE_TRANSIENT);
+      sqlite3_step(insertInformationStmt);
+      sqlite3_clear_bindings(insertInformationStmt);
+      sqlite3_reset(insertInformationStmt);
+    }
+    sqlite3_finalize(insertInformationStmt);
+    sqlite_exec(diagnostics, journal, "END TRANSACTION");
   }
 
   const char *query =
       "INSERT INTO mutant VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12)";
-  sqlite3_stmt *stmt;
-  sqlite3_prepare(database, query, -1, &stmt, nullptr);
+  sqlite3_prepare(journal, query, -1, &insertMutantStmt, nullptr);
+}
 
+void mull::SQLiteReporter::closeJournal() {
+  if (!journal) {
+    return;
+  }
+  sqlite3_finalize(insertMutantStmt);
+  insertMutantStmt = nullptr;
+  sqlite3_close(journal);
+  journal = nullptr;
+}
+
+void mull::SQLiteReporter::reportResult(const Mutant &mutant, const ExecutionResult &result) {
+  std::lock_guard<std::mutex> lock(journalMutex);
+  openJournal();
+  if (journaled.insert(mutant.getIdentifier()).second) {
+    insertMutant(insertMutantStmt, mutant, result);
+  }
+}
+
+void mull::SQLiteReporter::reportResults(const Result &result) {
+  std::lock_guard<std::mutex> lock(journalMutex);
+  openJournal();
+
+  /// Whatever was not reported as it came, e.g. results reused from a cache
+  sqlite_exec(diagnostics, journal, "BEGIN TRANSACTION");
   for (auto &mutationResult : result.getMutationResults()) {
     auto mutant = mutationResult->getMutant();
-    auto location = mutant->getSourceLocation();
-    auto endLocation = mutant->getEndLocation();
-
-    ExecutionResult execution = mutationResult->getExecutionResult();
-
-    int index = 1;
-
-    sqlite3_bind_text(stmt, index++, mutant->getIdentifier().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, index++, mutant->getMutatorIdentifier().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, index++, location.filePath.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, index++, location.directory.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, index++, location.line);
-    sqlite3_bind_int(stmt, index++, location.column);
-    sqlite3_bind_int(stmt, index++, endLocation.line);
-    sqlite3_bind_int(stmt, index++, endLocation.column);
-    sqlite3_bind_int(stmt, index++, execution.status);
-    sqlite3_bind_int64(stmt, index++, execution.runningTime);
-    sqlite3_bind_text(stmt, index++, execution.stdoutOutput.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, index++, execution.stderrOutput.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_step(stmt);
-    sqlite3_clear_bindings(stmt);
-    sqlite3_reset(stmt);
+    if (journaled.insert(mutant->getIdentifier()).second) {
+      insertMutant(insertMutantStmt, *mutant, mutationResult->getExecutionResult());
+    }
   }
+  sqlite_exec(diagnostics, journal, "END TRANSACTION");
 
-  sqlite_exec(diagnostics, database, "END TRANSACTION");
-
-  sqlite3_close(database);
+  closeJournal();
 
   diagnostics.info(std::string("Results can be found at '") + databasePath + "'");
 }
@@ -160,6 +215,7 @@ RawReport mull::SQLiteReporter::loadRawReport(const std::string &databasePath) {
   sqlite3_finalize(selectInfoStmt);
 
   std::unordered_map<std::string, std::vector<ExecutionResult>> mapping;
+  std::unordered_map<std::string, std::string> mutators;
 
   sqlite3_stmt *selectMutantsStmt;
   sqlite3_prepare(database, "select * from mutant", -1, &selectMutantsStmt, nullptr);
@@ -194,10 +250,13 @@ RawReport mull::SQLiteReporter::loadRawReport(const std::string &databasePath) {
     SourceLocation endLocation(
         directory, filename, directory, filename, end_line_number, end_column_number);
     mapping[mutant_id].push_back(executionResult);
+    mutators[mutant_id] = mutator;
   }
   sqlite3_finalize(selectMutantsStmt);
 
   sqlite3_close(database);
 
-  return { .info = std::move(information), .executionResults = std::move(mapping) };
+  return { .info = std::move(information),
+           .executionResults = std::move(mapping),
+           .mutators = std::move(mutators) };
 }
@@ -0,0 +1,195 @@
+#include "mull/ResultCache.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Distributed/Protocol.h"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace mull;
+using namespace std::string_literals;
+
+/// Bumped whenever the key or the entries change meaning
+static const char *CacheVersion = "mull-result-cache-1";
+
+static void add(llvm::MD5 &md5, llvm::StringRef value) {
+  md5.update(value);
+  md5.update(llvm::StringRef("\0", 1));
+}
+
+static std::string digest(llvm::MD5 &md5) {
+  llvm::MD5::MD5Result result;
+  md5.final(result);
+  return result.digest().str().str();
+}
+
+/// NotCovered mutants are never run, Invalid results are not worth keeping. Timeouts depend on
+/// the load of the machine as much as on the mutant, the next run tries again.
+static bool cacheable(const ExecutionResult &result) {
+  return result.status != NotCovered && result.status != Invalid && result.status != Timedout;
+}
+
+ResultCache::ResultCache(Diagnostics &diagnostics, std::string directory, std::string settings)
+    : diagnostics(diagnostics), directory(std::move(directory)), settings(std::move(settings)) {}
+
+void ResultCache::setProgramFiles(std::vector<std::string> files) {
+  programFiles = std::move(files);
+  std::sort(programFiles.begin(), programFiles.end());
+  programFingerprint.reset();
+  keys.clear();
+}
+
+void ResultCache::setTestFiles(std::unordered_map<std::string, std::vector<std::string>> files) {
+  testFiles = std::move(files);
+  for (auto &pair : testFiles) {
+    std::sort(pair.second.begin(), pair.second.end());
+  }
+  testHashes.clear();
+  keys.clear();
+}
+
+const std::string &ResultCache::fileHash(const std::string &path) {
+  auto found = fileHashes.find(path);
+  if (found != fileHashes.end()) {
+    return found->second;
+  }
+  llvm::MD5 md5;
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (buffer) {
+    md5.update(buffer.get()->getBuffer());
+  } else {
+    /// A missing file still has to differ from an empty one
+    add(md5, "missing");
+  }
+  return fileHashes.emplace(path, digest(md5)).first->second;
+}
+
+const std::string &ResultCache::programHash() {
+  if (!programFingerprint) {
+    llvm::MD5 md5;
+    for (auto &file : programFiles) {
+      add(md5, file);
+      add(md5, fileHash(file));
+    }
+    programFingerprint = digest(md5);
+  }
+  return *programFingerprint;
+}
+
+std::string ResultCache::key(const Mutant &mutant) {
+  auto found = keys.find(mutant.getIdentifier());
+  if (found != keys.end()) {
+    return found->second;
+  }
+  llvm::MD5 md5;
+  add(md5, CacheVersion);
+  add(md5, settings);
+  add(md5, mutant.getIdentifier());
+  add(md5, fileHash(mutant.getSourceLocation().filePath));
+
+  std::vector<std::string> tests(mutant.getCoveringTests());
+  bool testsKnown = !tests.empty() && std::all_of(tests.begin(), tests.end(), [&](auto &test) {
+    return testFiles.count(test) != 0;
+  });
+  if (testsKnown) {
+    std::sort(tests.begin(), tests.end());
+    for (auto &test : tests) {
+      auto &testHash = testHashes[test];
+      if (testHash.empty()) {
+        llvm::MD5 testMD5;
+        for (auto &file : testFiles.at(test)) {
+          add(testMD5, file);
+          add(testMD5, fileHash(file));
+        }
+        testHash = digest(testMD5);
+      }
+      add(md5, test);
+      add(md5, testHash);
+    }
+  } else {
+    add(md5, programHash());
+  }
+  return keys.emplace(mutant.getIdentifier(), digest(md5)).first->second;
+}
+
+std::string ResultCache::path(const std::string &key) const {
+  llvm::SmallString<PATH_MAX> path(directory);
+  llvm::sys::path::append(path, key);
+  return path.str().str();
+}
+
+std::optional<ExecutionResult> ResultCache::load(const Mutant &mutant) {
+  if (!mutant.isCovered()) {
+    return std::nullopt;
+  }
+  auto buffer = llvm::MemoryBuffer::getFile(path(key(mutant)));
+  if (!buffer) {
+    return std::nullopt;
+  }
+  std::string content = buffer.get()->getBuffer().str();
+  bool malformed = false;
+  auto message = protocol::decodeMessage(content, malformed);
+  if (!message || message->kind != protocol::MessageKind::Result ||
+      message->identifiers.front() != mutant.getIdentifier()) {
+    diagnostics.debug("Ignoring corrupted cache entry for "s + mutant.getIdentifier());
+    return std::nullopt;
+  }
+  return message->result;
+}
+
+void ResultCache::store(const Mutant &mutant, const ExecutionResult &result) {
+  if (!cacheable(result)) {
+    return;
+  }
+  /// Written aside and renamed: concurrent runs sharing the cache never see partial entries
+  int fd = -1;
+  llvm::SmallString<PATH_MAX> temporaryPath;
+  std::error_code error = llvm::sys::fs::create_directories(directory);
+  if (!error) {
+    error = llvm::sys::fs::createUniqueFile(path("%%%%%%%%.tmp"), fd, temporaryPath);
+  }
+  if (!error) {
+    llvm::raw_fd_ostream stream(fd, true);
+    stream << protocol::encodeResult(mutant.getIdentifier(), result);
+    stream.close();
+    if (stream.has_error()) {
+      error = stream.error();
+      stream.clear_error();
+    }
+  }
+  if (!error) {
+    error = llvm::sys::fs::rename(temporaryPath, path(key(mutant)));
+  }
+  if (error) {
+    if (!temporaryPath.empty()) {
+      llvm::sys::fs::remove(temporaryPath);
+    }
+    diagnostics.warning("Cannot store result of "s + mutant.getIdentifier() + " in " + directory +
+                        ": " + error.message());
+  }
+}
+
+std::vector<std::unique_ptr<MutationResult>>
+ResultCache::run(std::vector<std::unique_ptr<Mutant>> &mutants, const RunMutants &run) {
+  return runRemaining(
+      mutants,
+      [&](const Mutant &mutant) { return load(mutant); },
+      [&](std::vector<std::unique_ptr<Mutant>> &uncached) {
+        std::stringstream message;
+        message << "Result cache: " << mutants.size() - uncached.size() << " of "
+                << mutants.size() << " mutants unchanged";
+        diagnostics.info(message.str());
+
+        auto results = run(uncached);
+        for (auto &result : results) {
+          store(*result->getMutant(), result->getExecutionResult());
+        }
+        return results;
+      });
+}
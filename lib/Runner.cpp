@@ -10,12 +10,7 @@
 using namespace std::string_literals;
 using namespace mull;
 
-static std::pair<std::string, std::string> drainProcess(reproc::process &process,
-                                                        bool captureOutput) {
-  if (!captureOutput) {
-    reproc::drain(process, reproc::sink::null, reproc::sink::null);
-    return std::make_pair("", "");
-  }
+static std::pair<std::string, std::string> drainProcess(reproc::process &process) {
   std::string out;
   reproc::sink::string outSink(out);
   std::string err;
@@ -35,6 +30,11 @@ ExecutionResult Runner::runProgram(const std::string &program,
   reproc::options options;
   options.env.extra = reproc::env(environment);
   options.redirect.err.type = reproc::redirect::type::pipe;
+  /// Nobody reads the output: it goes straight to /dev/null instead of being drained
+  if (!captureOutput) {
+    options.redirect.out.type = reproc::redirect::type::discard;
+    options.redirect.err.type = reproc::redirect::type::discard;
+  }
   options.stop.first.action = reproc::stop::kill;
   options.stop.first.timeout = std::chrono::milliseconds(100);
   options.deadline = std::chrono::milliseconds(timeout);
@@ -54,7 +54,7 @@ ExecutionResult Runner::runProgram(const std::string &program,
     } else if (ec) {
       std::stringstream errorMessage;
       errorMessage << "Cannot run executable: " << ec.message() << '\n';
-      auto outputs = drainProcess(process, true);
+      auto outputs = drainProcess(process);
       errorMessage << "stdout: " << outputs.first << '\n';
       errorMessage << "stderr: " << outputs.second << '\n';
       errorMessage << "command: ";
@@ -68,24 +68,25 @@ ExecutionResult Runner::runProgram(const std::string &program,
 
   int status;
 
-  auto outputs = drainProcess(process, captureOutput);
+  std::pair<std::string, std::string> outputs;
+  if (captureOutput) {
+    outputs = drainProcess(process);
+  }
   std::tie(status, ec) = process.wait(reproc::milliseconds(timeout));
   ExecutionStatus executionStatus = Failed;
   if (ec == std::errc::timed_out) {
     process.kill();
     executionStatus = Timedout;
-  } else if (status == 0) {
-    executionStatus = Passed;
   } else {
-    executionStatus = Failed;
+    executionStatus = executionStatusFromExitStatus(status);
   }
 
   auto elapsed = std::chrono::high_resolution_clock::now() - start;
   ExecutionResult result;
   result.runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
   result.exitStatus = status;
-  result.stdoutOutput = outputs.first;
-  result.stderrOutput = outputs.second;
+  result.stdoutOutput = std::move(outputs.first);
+  result.stderrOutput = std::move(outputs.second);
   result.status = executionStatus;
 
   return result;
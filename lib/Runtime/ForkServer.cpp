@@ -0,0 +1,511 @@
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+using namespace mull;
+
+/// The fork server is equivalent to the following C code:
+///
+///   static int started;
+///   void __mull_fork_server() {
+///     if (started) return;
+///     started = 1;
+///     if (!getenv("MULL_FORK_SERVER")) return;
+///     fflush(NULL);
+///     int word = HELLO;
+///     if (write(STATUS_FD, &word, 4) != 4) return;
+///     for (;;) {
+///       unsigned length;
+///       if (!read_exact(CONTROL_FD, &length, 4)) _exit(0);
+///       char *identifier = malloc(length + 1);
+///       if (!read_exact(CONTROL_FD, identifier, length)) _exit(0);
+///       identifier[length] = 0;
+///       int pid = fork();
+///       if (pid == 0) {
+///         setpgid(0, 0);
+///         close(CONTROL_FD);
+///         close(STATUS_FD);
+///         unsetenv("MULL_FORK_SERVER");
+///         setenv("MULL_MUTANT_ID", identifier, 1);
+///         setenv(identifier, "1", 1);
+///         __mull_reinitialize_mutants();
+///         return;
+///       }
+///       write(STATUS_FD, &pid, 4);
+///       if (pid > 0) {
+///         waitpid(pid, &word, 0);
+///         write(STATUS_FD, &word, 4);
+///       }
+///       free(identifier);
+///     }
+///   }
+///
+/// The child returns into the remaining constructors and main(), so the dynamic linking and
+/// the constructors that already ran are shared by all mutants.
+
+static const char *ForkServerFunctionName = "__mull_fork_server";
+static const char *ReadExactFunctionName = "__mull_read_exact";
+static const char *StartedVariableName = "__mull_fork_server_started";
+
+namespace {
+struct LibC {
+  llvm::FunctionCallee getenv;
+  llvm::FunctionCallee setenv;
+  llvm::FunctionCallee unsetenv;
+  llvm::FunctionCallee fflush;
+  llvm::FunctionCallee read;
+  llvm::FunctionCallee write;
+  llvm::FunctionCallee close;
+  llvm::FunctionCallee fork;
+  llvm::FunctionCallee setpgid;
+  llvm::FunctionCallee waitpid;
+  llvm::FunctionCallee exit;
+  llvm::FunctionCallee malloc;
+  llvm::FunctionCallee free;
+  llvm::FunctionCallee strlen;
+  llvm::FunctionCallee getpid;
+
+  explicit LibC(llvm::Module &module) {
+    llvm::LLVMContext &context = module.getContext();
+    llvm::Type *voidType = llvm::Type::getVoidTy(context);
+    llvm::Type *intType = llvm::Type::getInt32Ty(context);
+    llvm::Type *sizeType = module.getDataLayout().getIntPtrType(context);
+    llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+    llvm::Type *intPtr = intType->getPointerTo();
+
+    auto declare = [&](const char *name, llvm::Type *result, llvm::ArrayRef<llvm::Type *> params) {
+      return module.getOrInsertFunction(name, llvm::FunctionType::get(result, params, false));
+    };
+    getenv = declare("getenv", charPtr, { charPtr });
+    setenv = declare("setenv", intType, { charPtr, charPtr, intType });
+    unsetenv = declare("unsetenv", intType, { charPtr });
+    fflush = declare("fflush", intType, { charPtr });
+    read = declare("read", sizeType, { intType, charPtr, sizeType });
+    write = declare("write", sizeType, { intType, charPtr, sizeType });
+    close = declare("close", intType, { intType });
+    fork = declare("fork", intType, {});
+    setpgid = declare("setpgid", intType, { intType, intType });
+    waitpid = declare("waitpid", intType, { intType, intPtr, intType });
+    exit = declare("_exit", voidType, { intType });
+    malloc = declare("malloc", charPtr, { sizeType });
+    free = declare("free", voidType, { charPtr });
+    strlen = declare("strlen", sizeType, { charPtr });
+    getpid = declare("getpid", intType, {});
+  }
+};
+} // namespace
+
+/// bool __mull_read_exact(int fd, char *buffer, size_t size)
+static llvm::Function *getReadExact(llvm::Module &module, LibC &libc) {
+  if (llvm::Function *existing = module.getFunction(ReadExactFunctionName)) {
+    return existing;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *sizeType = module.getDataLayout().getIntPtrType(context);
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  llvm::FunctionType *type = llvm::FunctionType::get(
+      llvm::Type::getInt1Ty(context), { intType, charType->getPointerTo(), sizeType }, false);
+  llvm::Function *function = llvm::Function::Create(
+      type, llvm::GlobalValue::LinkOnceODRLinkage, ReadExactFunctionName, module);
+  llvm::Argument *fd = function->getArg(0);
+  llvm::Argument *buffer = function->getArg(1);
+  llvm::Argument *size = function->getArg(2);
+
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", function);
+  llvm::BasicBlock *loop = llvm::BasicBlock::Create(context, "loop", function);
+  llvm::BasicBlock *body = llvm::BasicBlock::Create(context, "body", function);
+  llvm::BasicBlock *next = llvm::BasicBlock::Create(context, "next", function);
+  llvm::BasicBlock *done = llvm::BasicBlock::Create(context, "done", function);
+  llvm::BasicBlock *failed = llvm::BasicBlock::Create(context, "failed", function);
+
+  llvm::IRBuilder<> builder(entry);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(loop);
+  llvm::PHINode *offset = builder.CreatePHI(sizeType, 2, "offset");
+  offset->addIncoming(llvm::ConstantInt::get(sizeType, 0), entry);
+  builder.CreateCondBr(builder.CreateICmpUGE(offset, size), done, body);
+
+  builder.SetInsertPoint(body);
+  llvm::Value *position = builder.CreateInBoundsGEP(charType, buffer, offset);
+  llvm::Value *bytes = builder.CreateCall(libc.read, { fd, position, builder.CreateSub(size, offset) });
+  builder.CreateCondBr(
+      builder.CreateICmpSGT(bytes, llvm::ConstantInt::get(sizeType, 0)), next, failed);
+
+  builder.SetInsertPoint(next);
+  offset->addIncoming(builder.CreateAdd(offset, bytes), next);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(done);
+  builder.CreateRet(builder.getTrue());
+
+  builder.SetInsertPoint(failed);
+  builder.CreateRet(builder.getFalse());
+
+  return function;
+}
+
+void runtime::insertForkServer(llvm::Module &module) {
+  if (module.getFunction(ForkServerFunctionName)) {
+    return;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *sizeType = module.getDataLayout().getIntPtrType(context);
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  llvm::Type *charPtr = charType->getPointerTo();
+  LibC libc(module);
+  llvm::Function *readExact = getReadExact(module, libc);
+
+  auto *started = new llvm::GlobalVariable(module,
+                                           intType,
+                                           false,
+                                           llvm::GlobalValue::LinkOnceODRLinkage,
+                                           llvm::ConstantInt::get(intType, 0),
+                                           StartedVariableName);
+
+  llvm::Function *server =
+      llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+                             llvm::GlobalValue::LinkOnceODRLinkage,
+                             ForkServerFunctionName,
+                             module);
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", server);
+  llvm::BasicBlock *checkEnvironment = llvm::BasicBlock::Create(context, "check_env", server);
+  llvm::BasicBlock *hello = llvm::BasicBlock::Create(context, "hello", server);
+  llvm::BasicBlock *readLength = llvm::BasicBlock::Create(context, "read_length", server);
+  llvm::BasicBlock *readIdentifier = llvm::BasicBlock::Create(context, "read_identifier", server);
+  llvm::BasicBlock *forkMutant = llvm::BasicBlock::Create(context, "fork_mutant", server);
+  llvm::BasicBlock *child = llvm::BasicBlock::Create(context, "child", server);
+  llvm::BasicBlock *parent = llvm::BasicBlock::Create(context, "parent", server);
+  llvm::BasicBlock *wait = llvm::BasicBlock::Create(context, "wait", server);
+  llvm::BasicBlock *next = llvm::BasicBlock::Create(context, "next", server);
+  llvm::BasicBlock *shutdown = llvm::BasicBlock::Create(context, "shutdown", server);
+  llvm::BasicBlock *leave = llvm::BasicBlock::Create(context, "leave", server);
+
+  llvm::Value *controlFD = llvm::ConstantInt::get(intType, ForkServerControlFD);
+  llvm::Value *statusFD = llvm::ConstantInt::get(intType, ForkServerStatusFD);
+  llvm::Value *wordSize = llvm::ConstantInt::get(sizeType, sizeof(int32_t));
+
+  llvm::IRBuilder<> builder(entry);
+  llvm::Value *word = builder.CreateAlloca(intType, nullptr, "word");
+  llvm::Value *wordBytes = builder.CreateBitCast(word, charPtr);
+  llvm::Value *isStarted = builder.CreateLoad(intType, started);
+  builder.CreateCondBr(builder.CreateICmpNE(isStarted, builder.getInt32(0)), leave, checkEnvironment);
+
+  builder.SetInsertPoint(checkEnvironment);
+  builder.CreateStore(builder.getInt32(1), started);
+  llvm::Value *enabled =
+      builder.CreateCall(libc.getenv, { builder.CreateGlobalStringPtr(ForkServerEnvironmentVariable) });
+  builder.CreateCondBr(builder.CreateIsNull(enabled), leave, hello);
+
+  builder.SetInsertPoint(hello);
+  /// Anything buffered so far would otherwise be printed again by every child
+  builder.CreateCall(libc.fflush, { llvm::Constant::getNullValue(charPtr) });
+  builder.CreateStore(builder.getInt32(ForkServerHello), word);
+  llvm::Value *helloWritten = builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateCondBr(builder.CreateICmpEQ(helloWritten, wordSize), readLength, leave);
+
+  builder.SetInsertPoint(readLength);
+  llvm::Value *lengthRead = builder.CreateCall(readExact, { controlFD, wordBytes, wordSize });
+  builder.CreateCondBr(lengthRead, readIdentifier, shutdown);
+
+  builder.SetInsertPoint(readIdentifier);
+  llvm::Value *length = builder.CreateZExt(builder.CreateLoad(intType, word), sizeType);
+  llvm::Value *identifier =
+      builder.CreateCall(libc.malloc, { builder.CreateAdd(length, llvm::ConstantInt::get(sizeType, 1)) });
+  llvm::Value *identifierRead = builder.CreateCall(readExact, { controlFD, identifier, length });
+  builder.CreateCondBr(identifierRead, forkMutant, shutdown);
+
+  builder.SetInsertPoint(forkMutant);
+  builder.CreateStore(builder.getInt8(0), builder.CreateInBoundsGEP(charType, identifier, length));
+  llvm::Value *pid = builder.CreateCall(libc.fork, {});
+  builder.CreateCondBr(builder.CreateICmpEQ(pid, builder.getInt32(0)), child, parent);
+
+  builder.SetInsertPoint(child);
+  /// mull-runner kills the whole group, including whatever the mutant spawned
+  builder.CreateCall(libc.setpgid, { builder.getInt32(0), builder.getInt32(0) });
+  builder.CreateCall(libc.close, { controlFD });
+  builder.CreateCall(libc.close, { statusFD });
+  builder.CreateCall(libc.unsetenv, { builder.CreateGlobalStringPtr(ForkServerEnvironmentVariable) });
+  builder.CreateCall(libc.setenv,
+                     { builder.CreateGlobalStringPtr(MutantEnvironmentVariable), identifier, builder.getInt32(1) });
+  /// <identifier>=1 is still what the AST frontend instrumentation looks for
+  builder.CreateCall(libc.setenv, { identifier, builder.CreateGlobalStringPtr("1"), builder.getInt32(1) });
+  builder.CreateCall(getReinitializeMutants(module));
+  builder.CreateBr(leave);
+
+  builder.SetInsertPoint(parent);
+  builder.CreateStore(pid, word);
+  builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateCondBr(builder.CreateICmpSGT(pid, builder.getInt32(0)), wait, next);
+
+  builder.SetInsertPoint(wait);
+  builder.CreateCall(libc.waitpid, { pid, word, builder.getInt32(0) });
+  builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateBr(next);
+
+  builder.SetInsertPoint(next);
+  builder.CreateCall(libc.free, { identifier });
+  builder.CreateBr(readLength);
+
+  builder.SetInsertPoint(shutdown);
+  /// mull-runner closed the control descriptor: the server is no longer needed
+  builder.CreateCall(libc.exit, { builder.getInt32(0) });
+  builder.CreateUnreachable();
+
+  builder.SetInsertPoint(leave);
+  builder.CreateRetVoid();
+
+  llvm::appendToGlobalCtors(module, server, 65535);
+  recordFeature(module, ForkServerFeature);
+}
+
+/// A split point is equivalent to the following C code:
+///
+///   static _Bool split;
+///   static const char *mutants[] = { <identifiers of the function's mutants> };
+///   if (!split) {
+///     split = 1;
+///     __mull_split(mutants, N);
+///   }
+///
+/// where __mull_split is shared by all modules:
+///
+///   static int state, owner; // state: 0 - unknown, 1 - splitting, 2 - not splitting
+///   void __mull_split(const char **mutants, int count) {
+///     if (state == 0) {
+///       state = getenv("MULL_SPLIT_STREAM") ? 1 : 2;
+///       owner = getpid();
+///     }
+///     if (state != 1 || getpid() != owner) return;
+///     fflush(NULL);
+///     for (int i = 0; i < count; i++) {
+///       int word = strlen(mutants[i]);
+///       if (write(STATUS_FD, &word, 4) != 4 ||
+///           write(STATUS_FD, mutants[i], word) != word ||
+///           !read_exact(CONTROL_FD, &word, 4)) {
+///         state = 2;
+///         return;
+///       }
+///       if (word == 0) continue;
+///       int pid = fork();
+///       if (pid == 0) {
+///         setpgid(0, 0);
+///         close(CONTROL_FD);
+///         close(STATUS_FD);
+///         state = 2;
+///         setenv("MULL_MUTANT_ID", mutants[i], 1);
+///         setenv(mutants[i], "1", 1);
+///         __mull_reinitialize_mutants();
+///         return;
+///       }
+///       write(STATUS_FD, &pid, 4);
+///       if (pid > 0) {
+///         waitpid(pid, &word, 0);
+///         write(STATUS_FD, &word, 4);
+///       }
+///     }
+///   }
+///
+/// Everything the program did before reaching the mutated function is shared by its mutants.
+/// Processes forked by the tests themselves (e.g. death tests) never split: they are not the
+/// owner.
+
+static const char *SplitFunctionName = "__mull_split";
+static const char *SplitStateVariableName = "__mull_split_state";
+static const char *SplitOwnerVariableName = "__mull_split_owner";
+static const char *SplitDoneVariableName = "__mull_split_done";
+static const char *SplitMutantsVariableName = "__mull_split_mutants";
+
+static llvm::Function *getSplit(llvm::Module &module) {
+  if (llvm::Function *existing = module.getFunction(SplitFunctionName)) {
+    return existing;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *sizeType = module.getDataLayout().getIntPtrType(context);
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  llvm::Type *charPtr = charType->getPointerTo();
+  LibC libc(module);
+  llvm::Function *readExact = getReadExact(module, libc);
+
+  auto createState = [&](const char *name) {
+    return new llvm::GlobalVariable(module,
+                                    intType,
+                                    false,
+                                    llvm::GlobalValue::LinkOnceODRLinkage,
+                                    llvm::ConstantInt::get(intType, 0),
+                                    name);
+  };
+  llvm::GlobalVariable *state = createState(SplitStateVariableName);
+  llvm::GlobalVariable *owner = createState(SplitOwnerVariableName);
+
+  llvm::Function *split = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), { charPtr->getPointerTo(), intType }, false),
+      llvm::GlobalValue::LinkOnceODRLinkage,
+      SplitFunctionName,
+      module);
+  llvm::Argument *mutants = split->getArg(0);
+  llvm::Argument *count = split->getArg(1);
+
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", split);
+  llvm::BasicBlock *initialize = llvm::BasicBlock::Create(context, "initialize", split);
+  llvm::BasicBlock *checkState = llvm::BasicBlock::Create(context, "check_state", split);
+  llvm::BasicBlock *checkOwner = llvm::BasicBlock::Create(context, "check_owner", split);
+  llvm::BasicBlock *start = llvm::BasicBlock::Create(context, "start", split);
+  llvm::BasicBlock *loop = llvm::BasicBlock::Create(context, "loop", split);
+  llvm::BasicBlock *offer = llvm::BasicBlock::Create(context, "offer", split);
+  llvm::BasicBlock *sendIdentifier = llvm::BasicBlock::Create(context, "send_identifier", split);
+  llvm::BasicBlock *readReply = llvm::BasicBlock::Create(context, "read_reply", split);
+  llvm::BasicBlock *checkReply = llvm::BasicBlock::Create(context, "check_reply", split);
+  llvm::BasicBlock *forkMutant = llvm::BasicBlock::Create(context, "fork_mutant", split);
+  llvm::BasicBlock *child = llvm::BasicBlock::Create(context, "child", split);
+  llvm::BasicBlock *parent = llvm::BasicBlock::Create(context, "parent", split);
+  llvm::BasicBlock *wait = llvm::BasicBlock::Create(context, "wait", split);
+  llvm::BasicBlock *next = llvm::BasicBlock::Create(context, "next", split);
+  llvm::BasicBlock *disable = llvm::BasicBlock::Create(context, "disable", split);
+  llvm::BasicBlock *leave = llvm::BasicBlock::Create(context, "leave", split);
+
+  llvm::Value *controlFD = llvm::ConstantInt::get(intType, runtime::ForkServerControlFD);
+  llvm::Value *statusFD = llvm::ConstantInt::get(intType, runtime::ForkServerStatusFD);
+  llvm::Value *wordSize = llvm::ConstantInt::get(sizeType, sizeof(int32_t));
+
+  llvm::IRBuilder<> builder(entry);
+  llvm::Value *word = builder.CreateAlloca(intType, nullptr, "word");
+  llvm::Value *wordBytes = builder.CreateBitCast(word, charPtr);
+  llvm::Value *currentState = builder.CreateLoad(intType, state);
+  builder.CreateCondBr(builder.CreateICmpEQ(currentState, builder.getInt32(0)), initialize, checkState);
+
+  builder.SetInsertPoint(initialize);
+  llvm::Value *enabled =
+      builder.CreateCall(libc.getenv, { builder.CreateGlobalStringPtr(runtime::SplitStreamEnvironmentVariable) });
+  builder.CreateStore(builder.CreateSelect(builder.CreateIsNull(enabled), builder.getInt32(2), builder.getInt32(1)),
+                      state);
+  builder.CreateStore(builder.CreateCall(libc.getpid, {}), owner);
+  builder.CreateBr(checkState);
+
+  builder.SetInsertPoint(checkState);
+  llvm::Value *splitting = builder.CreateICmpEQ(builder.CreateLoad(intType, state), builder.getInt32(1));
+  builder.CreateCondBr(splitting, checkOwner, leave);
+
+  builder.SetInsertPoint(checkOwner);
+  llvm::Value *isOwner =
+      builder.CreateICmpEQ(builder.CreateCall(libc.getpid, {}), builder.CreateLoad(intType, owner));
+  builder.CreateCondBr(isOwner, start, leave);
+
+  builder.SetInsertPoint(start);
+  /// Anything buffered so far would otherwise be printed again by every child
+  builder.CreateCall(libc.fflush, { llvm::Constant::getNullValue(charPtr) });
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(loop);
+  llvm::PHINode *index = builder.CreatePHI(intType, 2, "index");
+  index->addIncoming(builder.getInt32(0), start);
+  builder.CreateCondBr(builder.CreateICmpSLT(index, count), offer, leave);
+
+  builder.SetInsertPoint(offer);
+  llvm::Value *identifier = builder.CreateLoad(
+      charPtr, builder.CreateInBoundsGEP(charPtr, mutants, builder.CreateZExt(index, sizeType)), "identifier");
+  llvm::Value *length = builder.CreateCall(libc.strlen, { identifier });
+  builder.CreateStore(builder.CreateTrunc(length, intType), word);
+  llvm::Value *lengthWritten = builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateCondBr(builder.CreateICmpEQ(lengthWritten, wordSize), sendIdentifier, disable);
+
+  builder.SetInsertPoint(sendIdentifier);
+  llvm::Value *identifierWritten = builder.CreateCall(libc.write, { statusFD, identifier, length });
+  builder.CreateCondBr(builder.CreateICmpEQ(identifierWritten, length), readReply, disable);
+
+  builder.SetInsertPoint(readReply);
+  llvm::Value *replyRead = builder.CreateCall(readExact, { controlFD, wordBytes, wordSize });
+  builder.CreateCondBr(replyRead, checkReply, disable);
+
+  builder.SetInsertPoint(checkReply);
+  llvm::Value *skip = builder.CreateICmpEQ(builder.CreateLoad(intType, word), builder.getInt32(0));
+  builder.CreateCondBr(skip, next, forkMutant);
+
+  builder.SetInsertPoint(forkMutant);
+  llvm::Value *pid = builder.CreateCall(libc.fork, {});
+  builder.CreateCondBr(builder.CreateICmpEQ(pid, builder.getInt32(0)), child, parent);
+
+  builder.SetInsertPoint(child);
+  /// mull-runner kills the whole group, including whatever the mutant spawned
+  builder.CreateCall(libc.setpgid, { builder.getInt32(0), builder.getInt32(0) });
+  builder.CreateCall(libc.close, { controlFD });
+  builder.CreateCall(libc.close, { statusFD });
+  builder.CreateStore(builder.getInt32(2), state);
+  builder.CreateCall(libc.setenv,
+                     { builder.CreateGlobalStringPtr(runtime::MutantEnvironmentVariable), identifier, builder.getInt32(1) });
+  /// <identifier>=1 is still what the AST frontend instrumentation looks for
+  builder.CreateCall(libc.setenv, { identifier, builder.CreateGlobalStringPtr("1"), builder.getInt32(1) });
+  builder.CreateCall(runtime::getReinitializeMutants(module));
+  builder.CreateBr(leave);
+
+  builder.SetInsertPoint(parent);
+  builder.CreateStore(pid, word);
+  builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateCondBr(builder.CreateICmpSGT(pid, builder.getInt32(0)), wait, next);
+
+  builder.SetInsertPoint(wait);
+  builder.CreateCall(libc.waitpid, { pid, word, builder.getInt32(0) });
+  builder.CreateCall(libc.write, { statusFD, wordBytes, wordSize });
+  builder.CreateBr(next);
+
+  builder.SetInsertPoint(next);
+  index->addIncoming(builder.CreateAdd(index, builder.getInt32(1)), next);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(disable);
+  /// mull-runner is gone: the program finishes unmutated
+  builder.CreateStore(builder.getInt32(2), state);
+  builder.CreateBr(leave);
+
+  builder.SetInsertPoint(leave);
+  builder.CreateRetVoid();
+
+  return split;
+}
+
+llvm::BasicBlock *runtime::insertSplitPoint(llvm::Module &module, llvm::BasicBlock *block,
+                                            llvm::ArrayRef<uint32_t> mutantIndices) {
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *boolType = llvm::Type::getInt1Ty(context);
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+  llvm::Function *function = block->getParent();
+
+  auto *done = new llvm::GlobalVariable(module,
+                                        boolType,
+                                        false,
+                                        llvm::GlobalValue::InternalLinkage,
+                                        llvm::ConstantInt::getFalse(context),
+                                        SplitDoneVariableName);
+  std::vector<llvm::Constant *> identifiers;
+  for (uint32_t index : mutantIndices) {
+    identifiers.push_back(getMutantIdentifier(module, index));
+  }
+  llvm::ArrayType *mutantsType = llvm::ArrayType::get(charPtr, identifiers.size());
+  auto *mutants = new llvm::GlobalVariable(module,
+                                           mutantsType,
+                                           true,
+                                           llvm::GlobalValue::PrivateLinkage,
+                                           llvm::ConstantArray::get(mutantsType, identifiers),
+                                           SplitMutantsVariableName);
+
+  llvm::BasicBlock *splitBlock = llvm::BasicBlock::Create(context, "split", function);
+  llvm::BasicBlock *continuation = llvm::BasicBlock::Create(context, "after_split", function);
+
+  llvm::IRBuilder<> builder(block);
+  builder.CreateCondBr(builder.CreateLoad(boolType, done), continuation, splitBlock);
+
+  builder.SetInsertPoint(splitBlock);
+  builder.CreateStore(builder.getTrue(), done);
+  llvm::Value *first = builder.CreateConstInBoundsGEP2_64(mutantsType, mutants, 0, 0);
+  builder.CreateCall(getSplit(module), { first, builder.getInt32(identifiers.size()) });
+  builder.CreateBr(continuation);
+
+  recordFeature(module, SplitStreamFeature);
+  return continuation;
+}
@@ -0,0 +1,255 @@
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include <cassert>
+
+using namespace mull;
+
+/// Every instrumented module gets the equivalent of the following C code:
+///
+///   static int active_mutant = -1;
+///   static const char *mutants[N] = { "cxx_add_to_sub:/tmp/main.c:2:12:2:13", ... };
+///   static void init_mutants() {
+///     active_mutant = -1;
+///     const char *id = getenv("MULL_MUTANT_ID");
+///     if (!id) return;
+///     for (int i = 0; i < N; i++) {
+///       if (strcmp(id, mutants[i]) == 0) {
+///         active_mutant = i;
+///         return;
+///       }
+///     }
+///   }
+///   static struct node { struct node *next; void (*init)(void); } module = { 0, init_mutants };
+///   __attribute__((constructor(0))) static void register_module() {
+///     module.next = __mull_modules;
+///     __mull_modules = &module;
+///     init_mutants();
+///   }
+///
+/// The trampolines then only compare active_mutant against the mutant's index. The registry
+/// (__mull_modules) lets the fork server re-select the mutant in every module after a fork.
+
+static const char *ActiveMutantVariableName = "__mull_active_mutant";
+static const char *MutantsTableName = "__mull_mutants";
+static const char *InitFunctionName = "__mull_init_mutants";
+static const char *ModuleNodeName = "__mull_module";
+static const char *RegisterFunctionName = "__mull_register_module";
+static const char *RegistryHeadName = "__mull_modules";
+static const char *ReinitializeFunctionName = "__mull_reinitialize_mutants";
+
+/// struct node { struct node *next; void (*init)(void); }, next is kept as i8* so that the type
+/// is the same in every module
+static llvm::StructType *getNodeType(llvm::LLVMContext &context) {
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+  llvm::Type *initPtr =
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false)->getPointerTo();
+  return llvm::StructType::get(context, { charPtr, initPtr });
+}
+
+static llvm::GlobalVariable *getRegistryHead(llvm::Module &module) {
+  if (llvm::GlobalVariable *existing = module.getNamedGlobal(RegistryHeadName)) {
+    return existing;
+  }
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(module.getContext())->getPointerTo();
+  return new llvm::GlobalVariable(module,
+                                  charPtr,
+                                  false,
+                                  llvm::GlobalValue::LinkOnceODRLinkage,
+                                  llvm::Constant::getNullValue(charPtr),
+                                  RegistryHeadName);
+}
+
+static llvm::Function *createInit(llvm::Module &module, llvm::GlobalVariable *activeMutant,
+                                  llvm::GlobalVariable *table, uint64_t count) {
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+  llvm::FunctionCallee getenv = module.getOrInsertFunction(
+      "getenv", llvm::FunctionType::get(charPtr, { charPtr }, false));
+  llvm::FunctionCallee strcmp = module.getOrInsertFunction(
+      "strcmp", llvm::FunctionType::get(intType, { charPtr, charPtr }, false));
+
+  llvm::Function *init =
+      llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+                             llvm::GlobalValue::InternalLinkage,
+                             InitFunctionName,
+                             module);
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", init);
+  llvm::BasicBlock *loop = llvm::BasicBlock::Create(context, "loop", init);
+  llvm::BasicBlock *body = llvm::BasicBlock::Create(context, "body", init);
+  llvm::BasicBlock *next = llvm::BasicBlock::Create(context, "next", init);
+  llvm::BasicBlock *found = llvm::BasicBlock::Create(context, "found", init);
+  llvm::BasicBlock *done = llvm::BasicBlock::Create(context, "done", init);
+
+  llvm::IRBuilder<> builder(entry);
+  builder.CreateStore(builder.getInt32(-1), activeMutant);
+  llvm::Value *identifier =
+      builder.CreateCall(getenv, { builder.CreateGlobalStringPtr(runtime::MutantEnvironmentVariable) });
+  builder.CreateCondBr(builder.CreateIsNull(identifier), done, loop);
+
+  builder.SetInsertPoint(loop);
+  llvm::PHINode *index = builder.CreatePHI(intType, 2, "index");
+  index->addIncoming(builder.getInt32(0), entry);
+  builder.CreateCondBr(builder.CreateICmpULT(index, builder.getInt32(count)), body, done);
+
+  builder.SetInsertPoint(body);
+  llvm::Value *slot = builder.CreateInBoundsGEP(
+      table->getValueType(), table, { builder.getInt64(0), builder.CreateZExt(index, builder.getInt64Ty()) });
+  llvm::Value *name = builder.CreateLoad(charPtr, slot, "name");
+  llvm::Value *comparison = builder.CreateCall(strcmp, { identifier, name });
+  builder.CreateCondBr(builder.CreateICmpEQ(comparison, builder.getInt32(0)), found, next);
+
+  builder.SetInsertPoint(next);
+  index->addIncoming(builder.CreateAdd(index, builder.getInt32(1)), next);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(found);
+  builder.CreateStore(index, activeMutant);
+  builder.CreateBr(done);
+
+  builder.SetInsertPoint(done);
+  builder.CreateRetVoid();
+
+  return init;
+}
+
+static void registerModule(llvm::Module &module, llvm::Function *init) {
+  llvm::LLVMContext &context = module.getContext();
+  llvm::StructType *nodeType = getNodeType(context);
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+  llvm::GlobalVariable *head = getRegistryHead(module);
+
+  auto *node = new llvm::GlobalVariable(
+      module,
+      nodeType,
+      false,
+      llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantStruct::get(nodeType, { llvm::Constant::getNullValue(charPtr), init }),
+      ModuleNodeName);
+
+  llvm::Function *registerFunction =
+      llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+                             llvm::GlobalValue::InternalLinkage,
+                             RegisterFunctionName,
+                             module);
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", registerFunction));
+  builder.CreateStore(builder.CreateLoad(charPtr, head),
+                      builder.CreateStructGEP(nodeType, node, 0));
+  builder.CreateStore(builder.CreateBitCast(node, charPtr), head);
+  builder.CreateCall(init->getFunctionType(), init);
+  builder.CreateRetVoid();
+
+  /// Mutants must be selected before any other constructor can reach a mutated function
+  llvm::appendToGlobalCtors(module, registerFunction, 0);
+}
+
+llvm::GlobalVariable *runtime::insertMutantActivation(llvm::Module &module,
+                                                      llvm::ArrayRef<std::string> identifiers) {
+  if (llvm::GlobalVariable *existing = module.getNamedGlobal(ActiveMutantVariableName)) {
+    return existing;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+
+  auto *activeMutant = new llvm::GlobalVariable(module,
+                                                intType,
+                                                false,
+                                                llvm::GlobalValue::InternalLinkage,
+                                                llvm::ConstantInt::get(intType, -1),
+                                                ActiveMutantVariableName);
+
+  std::vector<llvm::Constant *> names;
+  names.reserve(identifiers.size());
+  llvm::Value *zero = llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), 0);
+  for (auto &identifier : identifiers) {
+    llvm::Constant *string = llvm::ConstantDataArray::getString(context, identifier);
+    auto *global = new llvm::GlobalVariable(
+        module, string->getType(), true, llvm::GlobalValue::PrivateLinkage, string);
+    names.push_back(
+        llvm::ConstantExpr::getInBoundsGetElementPtr(string->getType(), global, { zero, zero }));
+  }
+  llvm::ArrayType *tableType = llvm::ArrayType::get(charPtr, names.size());
+  auto *table = new llvm::GlobalVariable(module,
+                                         tableType,
+                                         true,
+                                         llvm::GlobalValue::PrivateLinkage,
+                                         llvm::ConstantArray::get(tableType, names),
+                                         MutantsTableName);
+
+  registerModule(module, createInit(module, activeMutant, table, names.size()));
+  return activeMutant;
+}
+
+llvm::GlobalVariable *runtime::getActiveMutant(llvm::Module &module) {
+  llvm::GlobalVariable *activeMutant = module.getNamedGlobal(ActiveMutantVariableName);
+  assert(activeMutant && "The mutant activation must be inserted first");
+  return activeMutant;
+}
+
+llvm::GlobalVariable *runtime::getMutantsTable(llvm::Module &module) {
+  llvm::GlobalVariable *table = module.getNamedGlobal(MutantsTableName);
+  assert(table && "The mutant activation must be inserted first");
+  return table;
+}
+
+llvm::Constant *runtime::getMutantIdentifier(llvm::Module &module, uint32_t index) {
+  return getMutantsTable(module)->getInitializer()->getAggregateElement(index);
+}
+
+llvm::StringMap<uint32_t> runtime::getMutantIndices(llvm::Module &module) {
+  llvm::StringMap<uint32_t> indices;
+  uint64_t count = getMutantsTable(module)->getValueType()->getArrayNumElements();
+  for (uint32_t i = 0; i < count; i++) {
+    auto *name =
+        llvm::cast<llvm::GlobalVariable>(getMutantIdentifier(module, i)->stripPointerCasts());
+    indices[llvm::cast<llvm::ConstantDataArray>(name->getInitializer())->getAsCString()] = i;
+  }
+  return indices;
+}
+
+llvm::Function *runtime::getReinitializeMutants(llvm::Module &module) {
+  if (llvm::Function *existing = module.getFunction(ReinitializeFunctionName)) {
+    return existing;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::StructType *nodeType = getNodeType(context);
+  llvm::Type *charPtr = llvm::Type::getInt8Ty(context)->getPointerTo();
+  llvm::FunctionType *initType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), false);
+  llvm::GlobalVariable *head = getRegistryHead(module);
+
+  llvm::Function *reinitialize = llvm::Function::Create(
+      initType, llvm::GlobalValue::LinkOnceODRLinkage, ReinitializeFunctionName, module);
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", reinitialize);
+  llvm::BasicBlock *loop = llvm::BasicBlock::Create(context, "loop", reinitialize);
+  llvm::BasicBlock *body = llvm::BasicBlock::Create(context, "body", reinitialize);
+  llvm::BasicBlock *done = llvm::BasicBlock::Create(context, "done", reinitialize);
+
+  llvm::IRBuilder<> builder(entry);
+  llvm::Value *first = builder.CreateLoad(charPtr, head);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(loop);
+  llvm::PHINode *current = builder.CreatePHI(charPtr, 2, "node");
+  current->addIncoming(first, entry);
+  builder.CreateCondBr(builder.CreateIsNull(current), done, body);
+
+  builder.SetInsertPoint(body);
+  llvm::Value *node = builder.CreateBitCast(current, nodeType->getPointerTo());
+  llvm::Value *init =
+      builder.CreateLoad(initType->getPointerTo(), builder.CreateStructGEP(nodeType, node, 1));
+  builder.CreateCall(initType, init);
+  current->addIncoming(builder.CreateLoad(charPtr, builder.CreateStructGEP(nodeType, node, 0)),
+                       body);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(done);
+  builder.CreateRetVoid();
+
+  return reinitialize;
+}
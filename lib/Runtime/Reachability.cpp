@@ -0,0 +1,68 @@
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+
+#include <set>
+
+using namespace mull;
+
+/// Every module with probes gets the equivalent of the following C code:
+///
+///   static char reached[N];
+///   /// in the unmutated code, at the beginning of each block with a mutant:
+///   reached[index] = 1;
+///
+///   /// see insertMutantsDump
+///   __attribute__((destructor(0))) static void dump_reached();
+///
+/// A byte per mutant rather than a bit: plain stores of the same value, threads need no atomics.
+
+static const char *ReachedVariableName = "__mull_reached";
+static const char *DumpFunctionName = "__mull_dump_reached";
+
+void runtime::insertReachabilityProbes(
+    llvm::Module &module, llvm::ArrayRef<std::pair<llvm::Instruction *, std::string>> probes) {
+  if (probes.empty() || module.getNamedGlobal(ReachedVariableName)) {
+    return;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  uint64_t count = getMutantsTable(module)->getValueType()->getArrayNumElements();
+
+  llvm::StringMap<uint32_t> indices = getMutantIndices(module);
+
+  llvm::ArrayType *reachedType = llvm::ArrayType::get(charType, count);
+  auto *reached = new llvm::GlobalVariable(module,
+                                           reachedType,
+                                           false,
+                                           llvm::GlobalValue::InternalLinkage,
+                                           llvm::ConstantAggregateZero::get(reachedType),
+                                           ReachedVariableName);
+
+  /// Several mutants of an instruction, or of a block, share its block
+  std::set<std::pair<llvm::BasicBlock *, uint32_t>> marked;
+  for (auto &probe : probes) {
+    auto found = indices.find(probe.second);
+    if (found == indices.end()) {
+      continue;
+    }
+    llvm::BasicBlock *block = probe.first->getParent();
+    if (!marked.emplace(block, found->second).second) {
+      continue;
+    }
+    auto insertionPoint = block->getFirstInsertionPt();
+    /// e.g. catchswitch blocks
+    if (insertionPoint == block->end()) {
+      continue;
+    }
+    llvm::IRBuilder<> builder(block, insertionPoint);
+    builder.CreateStore(
+        builder.getInt8(1),
+        builder.CreateConstInBoundsGEP2_64(reachedType, reached, 0, found->second));
+  }
+
+  insertMutantsDump(module, DumpFunctionName, ReachabilityEnvironmentVariable, reached);
+  recordFeature(module, ReachabilityFeature);
+}
@@ -0,0 +1,126 @@
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+using namespace mull;
+
+void runtime::recordFeature(llvm::Module &module, const char *feature) {
+  std::string name = std::string("__mull_runtime_") + feature;
+  if (module.getNamedGlobal(name)) {
+    return;
+  }
+  llvm::Constant *constant = llvm::ConstantDataArray::getString(module.getContext(), feature);
+  auto *global = new llvm::GlobalVariable(module,
+                                          constant->getType(),
+                                          true,
+                                          llvm::GlobalValue::LinkOnceODRLinkage,
+                                          constant,
+                                          name);
+  global->setSection(RuntimeSection);
+  llvm::appendToUsed(module, { global });
+}
+
+/// The destructor is the equivalent of the following C code:
+///
+///   __attribute__((destructor(0))) static void dump() {
+///     const char *path = getenv(environmentVariable);
+///     if (!path) return;
+///     FILE *file = fopen(path, "a");
+///     if (!file) return;
+///     for (int i = 0; i < N; i++) {
+///       if (flags[i]) {
+///         if (marks) fputs(marks[i] ? "+" : "-", file);
+///         fputs(mutants[i], file);
+///         fputs("\n", file);
+///       }
+///     }
+///     fclose(file);
+///   }
+void runtime::insertMutantsDump(llvm::Module &module, const char *name,
+                                const char *environmentVariable, llvm::GlobalVariable *flags,
+                                llvm::GlobalVariable *marks) {
+  llvm::GlobalVariable *table = getMutantsTable(module);
+  uint64_t count = table->getValueType()->getArrayNumElements();
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *intType = llvm::Type::getInt32Ty(context);
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  llvm::Type *charPtr = charType->getPointerTo();
+  auto declare = [&](const char *function, llvm::Type *result,
+                     llvm::ArrayRef<llvm::Type *> params) {
+    return module.getOrInsertFunction(function, llvm::FunctionType::get(result, params, false));
+  };
+  llvm::FunctionCallee getenv = declare("getenv", charPtr, { charPtr });
+  /// FILE * is passed around as i8 *
+  llvm::FunctionCallee fopen = declare("fopen", charPtr, { charPtr, charPtr });
+  llvm::FunctionCallee fputs = declare("fputs", intType, { charPtr, charPtr });
+  llvm::FunctionCallee fclose = declare("fclose", intType, { charPtr });
+
+  llvm::Function *dump =
+      llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+                             llvm::GlobalValue::InternalLinkage,
+                             name,
+                             module);
+  llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", dump);
+  llvm::BasicBlock *open = llvm::BasicBlock::Create(context, "open", dump);
+  llvm::BasicBlock *loop = llvm::BasicBlock::Create(context, "loop", dump);
+  llvm::BasicBlock *body = llvm::BasicBlock::Create(context, "body", dump);
+  llvm::BasicBlock *write = llvm::BasicBlock::Create(context, "write", dump);
+  llvm::BasicBlock *next = llvm::BasicBlock::Create(context, "next", dump);
+  llvm::BasicBlock *close = llvm::BasicBlock::Create(context, "close", dump);
+  llvm::BasicBlock *done = llvm::BasicBlock::Create(context, "done", dump);
+
+  llvm::IRBuilder<> builder(entry);
+  llvm::Value *path = builder.CreateCall(
+      getenv, { builder.CreateGlobalStringPtr(environmentVariable) });
+  builder.CreateCondBr(builder.CreateIsNull(path), done, open);
+
+  builder.SetInsertPoint(open);
+  llvm::Value *file = builder.CreateCall(fopen, { path, builder.CreateGlobalStringPtr("a") });
+  builder.CreateCondBr(builder.CreateIsNull(file), done, loop);
+
+  builder.SetInsertPoint(loop);
+  llvm::PHINode *index = builder.CreatePHI(intType, 2, "index");
+  index->addIncoming(builder.getInt32(0), open);
+  builder.CreateCondBr(builder.CreateICmpULT(index, builder.getInt32(count)), body, close);
+
+  builder.SetInsertPoint(body);
+  llvm::Value *position = builder.CreateZExt(index, builder.getInt64Ty());
+  auto element = [&](llvm::GlobalVariable *array, llvm::Type *type) {
+    return builder.CreateLoad(
+        type,
+        builder.CreateInBoundsGEP(array->getValueType(), array, { builder.getInt64(0), position }));
+  };
+  llvm::Value *flag = element(flags, charType);
+  builder.CreateCondBr(builder.CreateICmpNE(flag, builder.getInt8(0)), write, next);
+
+  builder.SetInsertPoint(write);
+  if (marks) {
+    llvm::Value *mark = element(marks, charType);
+    builder.CreateCall(fputs,
+                       { builder.CreateSelect(builder.CreateICmpNE(mark, builder.getInt8(0)),
+                                              builder.CreateGlobalStringPtr("+"),
+                                              builder.CreateGlobalStringPtr("-")),
+                         file });
+  }
+  llvm::Value *identifier = element(table, charPtr);
+  builder.CreateCall(fputs, { identifier, file });
+  builder.CreateCall(fputs, { builder.CreateGlobalStringPtr("\n"), file });
+  builder.CreateBr(next);
+
+  builder.SetInsertPoint(next);
+  index->addIncoming(builder.CreateAdd(index, builder.getInt32(1)), next);
+  builder.CreateBr(loop);
+
+  builder.SetInsertPoint(close);
+  builder.CreateCall(fclose, { file });
+  builder.CreateBr(done);
+
+  builder.SetInsertPoint(done);
+  builder.CreateRetVoid();
+
+  llvm::appendToGlobalDtors(module, dump, 0);
+}
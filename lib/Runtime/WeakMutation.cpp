@@ -0,0 +1,79 @@
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+
+using namespace mull;
+
+/// Every module with probes gets the equivalent of the following C code:
+///
+///   static char evaluated[N];
+///   static char infected[N];
+///   static char sink;
+///   /// in the unmutated code, right after each mutated instruction:
+///   int mutated = <the mutant's operation on the same operands>;
+///   evaluated[index] = 1;
+///   *(original != mutated ? &infected[index] : &sink) = 1;
+///
+///   /// see insertMutantsDump
+///   __attribute__((destructor(0))) static void dump_infected();
+///
+/// No branches are added to the original code, and every store writes the same value: threads
+/// racing on a flag need no atomics.
+
+static const char *EvaluatedVariableName = "__mull_evaluated";
+static const char *InfectedVariableName = "__mull_infected";
+static const char *SinkVariableName = "__mull_infection_sink";
+static const char *DumpFunctionName = "__mull_dump_infected";
+
+void runtime::insertWeakMutationProbes(llvm::Module &module,
+                                       llvm::ArrayRef<WeakMutationProbe> probes) {
+  if (probes.empty() || module.getNamedGlobal(EvaluatedVariableName)) {
+    for (auto &probe : probes) {
+      probe.mutated->deleteValue();
+    }
+    return;
+  }
+  llvm::LLVMContext &context = module.getContext();
+  llvm::Type *charType = llvm::Type::getInt8Ty(context);
+  uint64_t count = getMutantsTable(module)->getValueType()->getArrayNumElements();
+  llvm::StringMap<uint32_t> indices = getMutantIndices(module);
+
+  llvm::ArrayType *flagsType = llvm::ArrayType::get(charType, count);
+  auto createFlags = [&](llvm::Type *type, const char *name) {
+    return new llvm::GlobalVariable(module,
+                                    type,
+                                    false,
+                                    llvm::GlobalValue::InternalLinkage,
+                                    llvm::Constant::getNullValue(type),
+                                    name);
+  };
+  llvm::GlobalVariable *evaluated = createFlags(flagsType, EvaluatedVariableName);
+  llvm::GlobalVariable *infected = createFlags(flagsType, InfectedVariableName);
+  llvm::GlobalVariable *sink = createFlags(charType, SinkVariableName);
+
+  for (auto &probe : probes) {
+    auto found = indices.find(probe.identifier);
+    if (found == indices.end()) {
+      probe.mutated->deleteValue();
+      continue;
+    }
+    llvm::IRBuilder<> builder(probe.original->getNextNode());
+    llvm::Value *mutated = builder.Insert(probe.mutated, probe.original->getName() + ".weak");
+    llvm::Value *differs = probe.original->getType()->isFloatingPointTy()
+                               ? builder.CreateFCmpUNE(probe.original, mutated)
+                               : builder.CreateICmpNE(probe.original, mutated);
+    builder.CreateStore(builder.getInt8(1),
+                        builder.CreateConstInBoundsGEP2_64(flagsType, evaluated, 0, found->second));
+    builder.CreateStore(
+        builder.getInt8(1),
+        builder.CreateSelect(
+            differs,
+            builder.CreateConstInBoundsGEP2_64(flagsType, infected, 0, found->second),
+            sink));
+  }
+
+  insertMutantsDump(module, DumpFunctionName, WeakMutationEnvironmentVariable, evaluated, infected);
+  recordFeature(module, WeakMutationFeature);
+}
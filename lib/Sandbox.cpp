@@ -0,0 +1,337 @@
+#include "mull/Sandbox.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/FailureMarkers.h"
+#include "mull/OutputCapture.h"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <libproc.h>
+#include <mach/mach_time.h>
+#endif
+
+extern char **environ;
+
+using namespace mull;
+using namespace std::string_literals;
+using Clock = std::chrono::steady_clock;
+
+/// How often the limits are checked while the program is running
+static const int PollIntervalMilliseconds = 10;
+
+std::optional<long long> mull::processCPUTime(pid_t pid) {
+#ifdef __APPLE__
+  rusage_info_v2 info;
+  if (proc_pid_rusage(pid, RUSAGE_INFO_V2, reinterpret_cast<rusage_info_t *>(&info)) != 0) {
+    return std::nullopt;
+  }
+  mach_timebase_info_data_t timebase;
+  mach_timebase_info(&timebase);
+  uint64_t nanoseconds =
+      (info.ri_user_time + info.ri_system_time) * timebase.numer / timebase.denom;
+  return nanoseconds / 1000000;
+#else
+  clockid_t clock;
+  timespec time{};
+  if (clock_getcpuclockid(pid, &clock) != 0 || clock_gettime(clock, &time) != 0) {
+    return std::nullopt;
+  }
+  return time.tv_sec * 1000LL + time.tv_nsec / 1000000;
+#endif
+}
+
+static void setLimit(int resource, rlim_t value) {
+  if (value == 0) {
+    return;
+  }
+  rlimit limit{ value, value };
+  setrlimit(resource, &limit);
+}
+
+void mull::enterSandbox(const SandboxConfig &resources) {
+  const rlim_t megabyte = 1024 * 1024;
+  if (resources.processGroup) {
+    setpgid(0, 0);
+  }
+  setLimit(RLIMIT_AS, resources.memoryLimit * megabyte);
+  if (resources.cpuLimit != 0) {
+    /// The soft limit sends SIGXCPU (reported as Timedout), the hard one a second later SIGKILL
+    rlimit limit{ resources.cpuLimit, resources.cpuLimit + 1 };
+    setrlimit(RLIMIT_CPU, &limit);
+  }
+  setLimit(RLIMIT_NPROC, resources.processLimit);
+  setLimit(RLIMIT_FSIZE, resources.fileSizeLimit * megabyte);
+}
+
+/// Kills the program, and its children if it runs in its own process group
+static void killProgram(pid_t pid, const SandboxConfig &resources) {
+  if (resources.processGroup) {
+    kill(-pid, SIGKILL);
+  }
+  kill(pid, SIGKILL);
+}
+
+static long long milliseconds(const timeval &time) {
+  return time.tv_sec * 1000LL + time.tv_usec / 1000;
+}
+
+#ifdef __APPLE__
+/// Without pipe2, a pipe is only closed on exec once fcntl returns: no fork may happen before
+static std::mutex forkMutex;
+#endif
+
+bool mull::createPipe(int fds[2]) {
+#ifdef __APPLE__
+  std::lock_guard<std::mutex> guard(forkMutex);
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+#else
+  return pipe2(fds, O_CLOEXEC) == 0;
+#endif
+}
+
+pid_t mull::forkProcess() {
+#ifdef __APPLE__
+  std::lock_guard<std::mutex> guard(forkMutex);
+#endif
+  return fork();
+}
+
+/// execve does not search PATH, do it upfront: nothing but async-signal-safe calls may happen
+/// between fork and exec
+static std::string resolveProgram(const std::string &program) {
+  if (program.find('/') != std::string::npos) {
+    return program;
+  }
+  const char *path = getenv("PATH");
+  if (!path) {
+    return program;
+  }
+  std::stringstream directories(path);
+  std::string directory;
+  while (std::getline(directories, directory, ':')) {
+    std::string candidate = (directory.empty() ? "." : directory) + "/" + program;
+    if (access(candidate.c_str(), X_OK) == 0) {
+      return candidate;
+    }
+  }
+  return program;
+}
+
+namespace {
+struct OutputStream {
+  int fd;
+  OutputCapture *sink;
+  FailureMarkers markers;
+
+  /// Returns true if a failure marker was seen
+  bool read() {
+    char buffer[4096];
+    ssize_t bytes = ::read(fd, buffer, sizeof(buffer));
+    if (bytes <= 0) {
+      if (bytes == 0 || errno != EINTR) {
+        close(fd);
+        fd = -1;
+      }
+      return false;
+    }
+    if (sink) {
+      sink->append(buffer, bytes);
+    }
+    return markers.scan(buffer, bytes);
+  }
+};
+} // namespace
+
+Sandbox::Sandbox(Diagnostics &diagnostics) : diagnostics(diagnostics) {}
+
+ExecutionResult Sandbox::run(const std::string &program, const std::vector<std::string> &arguments,
+                             const std::unordered_map<std::string, std::string> &environment,
+                             const SandboxLimits &limits, bool captureOutput,
+                             const std::vector<std::string> &failureMarkers) {
+  std::string executable = resolveProgram(program);
+  std::vector<std::string> allArguments{ program };
+  std::copy(std::begin(arguments), std::end(arguments), std::back_inserter(allArguments));
+  std::vector<char *> argv;
+  for (auto &argument : allArguments) {
+    argv.push_back(const_cast<char *>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  std::vector<std::string> variables;
+  for (char **variable = environ; *variable; variable++) {
+    std::string entry(*variable);
+    if (!environment.count(entry.substr(0, entry.find('=')))) {
+      variables.push_back(entry);
+    }
+  }
+  for (auto &pair : environment) {
+    variables.push_back(pair.first + "=" + pair.second);
+  }
+  std::vector<char *> envp;
+  for (auto &variable : variables) {
+    envp.push_back(const_cast<char *>(variable.c_str()));
+  }
+  envp.push_back(nullptr);
+
+  ExecutionResult result;
+  /// Nobody reads the output: it goes straight to /dev/null instead of through pipes
+  bool discardOutput = !captureOutput && failureMarkers.empty();
+  int out[2] = { -1, -1 }, err[2] = { -1, -1 }, exec[2];
+  if ((!discardOutput && (!createPipe(out) || !createPipe(err))) || !createPipe(exec)) {
+    diagnostics.error("Cannot create pipes: "s + strerror(errno));
+    return result;
+  }
+  /// Reading the terminal from a background process group would stop the program
+  int input = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (discardOutput) {
+    out[1] = err[1] = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  }
+
+  auto start = Clock::now();
+  pid_t pid = forkProcess();
+  if (pid == 0) {
+    dup2(input, STDIN_FILENO);
+    dup2(out[1], STDOUT_FILENO);
+    dup2(err[1], STDERR_FILENO);
+    enterSandbox(limits.resources);
+    execve(executable.c_str(), argv.data(), envp.data());
+    /// The exec pipe is closed on a successful exec, otherwise the parent gets errno
+    int error = errno;
+    (void)!write(exec[1], &error, sizeof(error));
+    _exit(127);
+  }
+  if (pid > 0 && limits.resources.processGroup) {
+    /// Also done by the child, whichever comes first: the group must exist before it is killed
+    setpgid(pid, pid);
+  }
+  close(input);
+  close(out[1]);
+  if (err[1] != out[1]) {
+    close(err[1]);
+  }
+  close(exec[1]);
+
+  int execError = 0;
+  if (pid < 0) {
+    execError = errno;
+  } else {
+    while (read(exec[0], &execError, sizeof(execError)) < 0 && errno == EINTR) {
+    }
+  }
+  close(exec[0]);
+  if (execError != 0) {
+    if (!discardOutput) {
+      close(out[0]);
+      close(err[0]);
+    }
+    if (pid > 0) {
+      waitpid(pid, nullptr, 0);
+    }
+    if (execError == ENOENT) {
+      diagnostics.error("Executable not found: "s + program);
+    } else {
+      diagnostics.error("Cannot run executable: "s + program + ": " + strerror(execError));
+    }
+    return result;
+  }
+
+  std::string stdoutFile, stderrFile;
+  if (!limits.outputFile.empty()) {
+    stdoutFile = limits.outputFile + ".stdout";
+    stderrFile = limits.outputFile + ".stderr";
+  }
+  OutputCapture stdoutOutput(limits.outputLimit, stdoutFile);
+  OutputCapture stderrOutput(limits.outputLimit, stderrFile);
+  OutputStream streams[2] = {
+    { out[0], captureOutput ? &stdoutOutput : nullptr, FailureMarkers(failureMarkers) },
+    { err[0], captureOutput ? &stderrOutput : nullptr, FailureMarkers(failureMarkers) },
+  };
+
+  ExecutionStatus killedWith = Invalid;
+  int status = 0;
+  rusage usage{};
+  long long cpuTime = 0;
+  auto wallDeadline = start + std::chrono::milliseconds(limits.wallTime);
+  while (killedWith == Invalid) {
+    pollfd descriptors[2] = { { streams[0].fd, POLLIN, 0 }, { streams[1].fd, POLLIN, 0 } };
+    int ready = poll(descriptors, 2, PollIntervalMilliseconds);
+    for (int i = 0; ready > 0 && i < 2; i++) {
+      if (streams[i].fd != -1 && (descriptors[i].revents & (POLLIN | POLLHUP | POLLERR)) &&
+          streams[i].read() && killedWith == Invalid) {
+        killedWith = FailFast;
+      }
+    }
+
+    /// The program is not reaped yet: its pid (and process group) cannot be reused by then
+    siginfo_t info{};
+    int waited = waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT);
+    if ((waited == 0 && info.si_pid == pid) || (waited != 0 && errno != EINTR)) {
+      break;
+    }
+    if (killedWith == Invalid && limits.cpuTime > 0) {
+      cpuTime = processCPUTime(pid).value_or(cpuTime);
+      if (cpuTime > limits.cpuTime) {
+        killedWith = Timedout;
+      }
+    }
+    if (killedWith == Invalid && limits.wallTime > 0 && Clock::now() > wallDeadline) {
+      killedWith = Timedout;
+    }
+  }
+  if (killedWith != Invalid) {
+    killProgram(pid, limits.resources);
+  } else if (limits.resources.processGroup) {
+    /// Children left behind would keep running into the next mutants
+    kill(-pid, SIGKILL);
+  }
+  while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+  }
+
+  /// Whatever the program wrote before exiting is already in the pipes, but its own children may
+  /// keep them open: only take what is available
+  for (auto &stream : streams) {
+    while (stream.fd != -1) {
+      pollfd descriptor = { stream.fd, POLLIN, 0 };
+      if (poll(&descriptor, 1, 0) <= 0) {
+        break;
+      }
+      stream.read();
+    }
+    if (stream.fd != -1) {
+      close(stream.fd);
+    }
+  }
+
+  auto elapsed = Clock::now() - start;
+  result.runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+  result.cpuTime = milliseconds(usage.ru_utime) + milliseconds(usage.ru_stime);
+  result.exitStatus =
+      WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status) + SignalExitStatusOffset;
+  result.stdoutOutput = stdoutOutput.take();
+  result.stderrOutput = stderrOutput.take();
+  if (killedWith != Invalid) {
+    result.status = killedWith;
+  } else if (limits.cpuTime > 0 && result.cpuTime > limits.cpuTime) {
+    result.status = Timedout;
+  } else {
+    result.status = executionStatusFromExitStatus(result.exitStatus);
+  }
+  return result;
+}
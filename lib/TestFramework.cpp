@@ -0,0 +1,165 @@
+#include "mull/TestFramework.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+
+using namespace mull;
+
+/// Linux limits a single argument to 128 KiB, macOS the whole command line and environment to
+/// 256 KiB: longer selections would fail with E2BIG
+static const size_t MaxSelectionLength = 32 * 1024;
+
+TestFramework::TestFramework(TestFrameworkKind kind) : kind(kind) {}
+
+bool TestFramework::supportsTestSelection() const {
+  return kind != TestFrameworkKind::None;
+}
+
+std::vector<std::string> TestFramework::listTestsArguments() const {
+  switch (kind) {
+  case TestFrameworkKind::GoogleTest:
+    return { "--gtest_list_tests" };
+  case TestFrameworkKind::Catch2:
+    return { "--list-tests", "--verbosity", "quiet" };
+  case TestFrameworkKind::Doctest:
+    return { "--list-test-cases" };
+  case TestFrameworkKind::None:
+    break;
+  }
+  return {};
+}
+
+/// Drops gtest's trailing comments, e.g. "Test/0  # GetParam() = 42"
+static llvm::StringRef dropComment(llvm::StringRef line) {
+  return line.substr(0, line.find("  #"));
+}
+
+static bool hasPrefix(llvm::StringRef line, llvm::StringRef prefix) {
+  return line.substr(0, prefix.size()) == prefix;
+}
+
+std::vector<std::string> TestFramework::parseTestList(const std::string &output) const {
+  std::vector<std::string> tests;
+  llvm::SmallVector<llvm::StringRef> lines;
+  llvm::StringRef(output).split(lines, '\n', -1, false);
+
+  switch (kind) {
+  case TestFrameworkKind::GoogleTest: {
+    /// Suite.
+    ///   Test
+    std::string suite;
+    for (llvm::StringRef line : lines) {
+      line = dropComment(line.rtrim());
+      if (line.trim().empty()) {
+        continue;
+      }
+      if (line.front() != ' ') {
+        suite = line.str();
+        continue;
+      }
+      std::string test = suite + line.trim().str();
+      if (test.find("DISABLED_") == std::string::npos) {
+        tests.push_back(test);
+      }
+    }
+  } break;
+  case TestFrameworkKind::Catch2: {
+    for (llvm::StringRef line : lines) {
+      line = line.trim();
+      if (!line.empty()) {
+        tests.push_back(line.str());
+      }
+    }
+  } break;
+  case TestFrameworkKind::Doctest: {
+    for (llvm::StringRef line : lines) {
+      line = line.trim();
+      if (line.empty() || hasPrefix(line, "[doctest]") || hasPrefix(line, "=====")) {
+        continue;
+      }
+      tests.push_back(line.str());
+    }
+  } break;
+  case TestFrameworkKind::None:
+    break;
+  }
+
+  return tests;
+}
+
+static std::string escape(const std::string &name, llvm::StringRef special) {
+  std::string escaped;
+  escaped.reserve(name.size());
+  for (char c : name) {
+    if (special.find(c) != llvm::StringRef::npos) {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+static std::string join(const std::vector<std::string> &tests, char separator,
+                        llvm::StringRef special) {
+  std::string joined;
+  for (auto &test : tests) {
+    if (!joined.empty()) {
+      joined += separator;
+    }
+    joined += escape(test, special);
+  }
+  return joined;
+}
+
+std::vector<std::string>
+TestFramework::selectTestsArguments(const std::vector<std::string> &tests) const {
+  if (tests.empty()) {
+    return {};
+  }
+  std::string selection;
+  switch (kind) {
+  case TestFrameworkKind::GoogleTest:
+    selection = "--gtest_filter=" + join(tests, ':', "");
+    break;
+  case TestFrameworkKind::Catch2:
+    selection = join(tests, ',', "\\,[]\"");
+    break;
+  case TestFrameworkKind::Doctest:
+    selection = "--test-case=" + join(tests, ',', "\\,");
+    break;
+  case TestFrameworkKind::None:
+    return {};
+  }
+  if (selection.size() > MaxSelectionLength) {
+    return {};
+  }
+  return { selection };
+}
+
+std::vector<std::string> TestFramework::failFastArguments() const {
+  switch (kind) {
+  case TestFrameworkKind::GoogleTest:
+    return { "--gtest_fail_fast" };
+  case TestFrameworkKind::Catch2:
+    return { "--abort" };
+  case TestFrameworkKind::Doctest:
+    return { "--abort-after=1" };
+  case TestFrameworkKind::None:
+    break;
+  }
+  return {};
+}
+
+std::vector<std::string> TestFramework::failureMarkers() const {
+  switch (kind) {
+  case TestFrameworkKind::GoogleTest:
+    return { "[  FAILED  ]" };
+  case TestFrameworkKind::Catch2:
+    return { "FAILED:" };
+  case TestFrameworkKind::Doctest:
+    return { "ERROR: " };
+  case TestFrameworkKind::None:
+    break;
+  }
+  return {};
+}
@@ -0,0 +1,303 @@
+#include "mull/TrivialCompilerEquivalence.h"
+
+#include "mull/Bitcode.h"
+#include "mull/MutationPoint.h"
+#include "mull/Runtime/Runtime.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DebugInfo.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include <unordered_set>
+
+using namespace mull;
+
+/// Separates a mutant from the one it duplicates in the section entries
+static const char EquivalenceSeparator = '\t';
+
+#if LLVM_VERSION_MAJOR < 14
+using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#else
+using OptimizationLevel = llvm::OptimizationLevel;
+#endif
+
+/// Declares everything the function refers to in `module`. Returns false if the function refers
+/// to itself in a way a copy cannot (block addresses).
+static bool declareReferences(llvm::Module &module, const llvm::Value *value,
+                              llvm::ValueToValueMapTy &map,
+                              std::unordered_set<const llvm::Value *> &visited) {
+  if (!llvm::isa<llvm::Constant>(value) || !visited.insert(value).second) {
+    return true;
+  }
+  if (llvm::isa<llvm::BlockAddress>(value)) {
+    return false;
+  }
+  if (auto global = llvm::dyn_cast<llvm::GlobalValue>(value)) {
+    llvm::GlobalValue *declaration = nullptr;
+    if (auto type = llvm::dyn_cast<llvm::FunctionType>(global->getValueType())) {
+      auto function = llvm::Function::Create(
+          type, llvm::GlobalValue::ExternalLinkage, global->getName(), module);
+      if (auto original = llvm::dyn_cast<llvm::Function>(global)) {
+        /// e.g. readnone lets calls be removed
+        function->setAttributes(original->getAttributes());
+        function->setCallingConv(original->getCallingConv());
+      }
+      declaration = function;
+    } else {
+      auto variable = llvm::dyn_cast<llvm::GlobalVariable>(global);
+      declaration = new llvm::GlobalVariable(module,
+                                             global->getValueType(),
+                                             variable && variable->isConstant(),
+                                             llvm::GlobalValue::ExternalLinkage,
+                                             nullptr,
+                                             global->getName(),
+                                             nullptr,
+                                             global->getThreadLocalMode(),
+                                             global->getAddressSpace());
+    }
+    map[global] = declaration;
+    return true;
+  }
+  for (const llvm::Use &operand : llvm::cast<llvm::Constant>(value)->operands()) {
+    if (!declareReferences(module, operand.get(), map, visited)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::string hashFunction(const llvm::Function &function,
+                                const llvm::GlobalVariable *activeMutant, uint32_t index) {
+  if (function.isDeclaration()) {
+    return {};
+  }
+  llvm::Module module("mull-equivalence", function.getContext());
+  module.setDataLayout(function.getParent()->getDataLayout());
+  module.setTargetTriple(function.getParent()->getTargetTriple());
+
+  llvm::ValueToValueMapTy map;
+  std::unordered_set<const llvm::Value *> visited;
+  if (function.hasPersonalityFn() &&
+      !declareReferences(module, function.getPersonalityFn(), map, visited)) {
+    return {};
+  }
+  for (const llvm::Instruction &instruction : llvm::instructions(function)) {
+    for (const llvm::Use &operand : instruction.operands()) {
+      if (!declareReferences(module, operand.get(), map, visited)) {
+        return {};
+      }
+    }
+  }
+  /// The versions of a function only differ by name
+  llvm::Function *copy = llvm::Function::Create(
+      function.getFunctionType(), llvm::GlobalValue::ExternalLinkage, "function", module);
+  auto argument = copy->arg_begin();
+  for (const llvm::Argument &original : function.args()) {
+    map[&original] = &*argument++;
+  }
+  llvm::SmallVector<llvm::ReturnInst *, 8> returns;
+  llvm::CloneFunctionInto(
+      copy, &function, map, llvm::CloneFunctionChangeType::DifferentModule, returns);
+  llvm::StripDebugInfo(module);
+  if (activeMutant) {
+    if (llvm::Value *declaration = map.lookup(activeMutant)) {
+      std::vector<llvm::LoadInst *> loads;
+      for (llvm::Instruction &instruction : llvm::instructions(copy)) {
+        auto *load = llvm::dyn_cast<llvm::LoadInst>(&instruction);
+        if (load && load->getPointerOperand() == declaration) {
+          loads.push_back(load);
+        }
+      }
+      for (llvm::LoadInst *load : loads) {
+        load->replaceAllUsesWith(llvm::ConstantInt::get(load->getType(), index));
+        load->eraseFromParent();
+      }
+    }
+  }
+
+  llvm::LoopAnalysisManager loopAnalyses;
+  llvm::FunctionAnalysisManager functionAnalyses;
+  llvm::CGSCCAnalysisManager cgsccAnalyses;
+  llvm::ModuleAnalysisManager moduleAnalyses;
+  llvm::PassBuilder passBuilder;
+  passBuilder.registerModuleAnalyses(moduleAnalyses);
+  passBuilder.registerCGSCCAnalyses(cgsccAnalyses);
+  passBuilder.registerFunctionAnalyses(functionAnalyses);
+  passBuilder.registerLoopAnalyses(loopAnalyses);
+  passBuilder.crossRegisterProxies(loopAnalyses, functionAnalyses, cgsccAnalyses, moduleAnalyses);
+  llvm::ModulePassManager passes = passBuilder.buildPerModuleDefaultPipeline(OptimizationLevel::O2);
+  passes.run(module, moduleAnalyses);
+
+  for (llvm::Argument &argument : copy->args()) {
+    argument.setName("");
+  }
+  for (llvm::BasicBlock &block : *copy) {
+    block.setName("");
+    for (llvm::Instruction &instruction : block) {
+      instruction.setName("");
+    }
+  }
+  std::string code;
+  llvm::raw_string_ostream stream(code);
+  copy->print(stream);
+  stream.flush();
+
+  llvm::MD5 md5;
+  md5.update(code);
+  llvm::MD5::MD5Result hash;
+  md5.final(hash);
+  return hash.digest().str().str();
+}
+
+std::string mull::optimizedFunctionHash(const llvm::Function &function) {
+  return hashFunction(function, nullptr, 0);
+}
+
+std::string mull::optimizedFunctionHash(const llvm::Function &schema,
+                                        const llvm::GlobalVariable &activeMutant,
+                                        uint32_t index) {
+  return hashFunction(schema, &activeMutant, index);
+}
+
+Equivalences mull::findEquivalentMutants(Bitcode &bitcode) {
+  Equivalences equivalences;
+  llvm::Module *module = bitcode.getModule();
+  llvm::GlobalVariable *activeMutant = nullptr;
+  llvm::StringMap<uint32_t> mutantIndices;
+  for (auto &pair : bitcode.getMutationPointsMap()) {
+    auto &points = pair.second;
+    /// Mutants of a schema share a copy, each one is compared with its own guard enabled
+    bool schema = bitcode.hasMutantSchema(pair.first);
+    if (schema && !activeMutant) {
+      activeMutant = runtime::getActiveMutant(*module);
+      mutantIndices = runtime::getMutantIndices(*module);
+    }
+    llvm::Function *original = module->getFunction(points.front()->getOriginalFunctionName());
+    if (!original) {
+      continue;
+    }
+    std::string originalHash = optimizedFunctionHash(*original);
+    if (originalHash.empty()) {
+      continue;
+    }
+    /// The first mutant of each kind of code is run, the others follow it
+    std::unordered_map<std::string, std::string> representatives;
+    for (MutationPoint *point : points) {
+      const std::string &identifier = point->getUserIdentifier();
+      if (equivalences.count(identifier) || !point->getMutatedFunction()) {
+        continue;
+      }
+      std::string hash =
+          schema ? optimizedFunctionHash(
+                       *point->getMutatedFunction(), *activeMutant, mutantIndices[identifier])
+                 : optimizedFunctionHash(*point->getMutatedFunction());
+      if (hash.empty()) {
+        continue;
+      }
+      if (hash == originalHash) {
+        equivalences[identifier] = std::string();
+        continue;
+      }
+      auto representative = representatives.emplace(hash, identifier);
+      if (!representative.second && representative.first->second != identifier) {
+        equivalences[identifier] = representative.first->second;
+      }
+    }
+  }
+  return equivalences;
+}
+
+void mull::recordEquivalences(llvm::Module &module, const Equivalences &equivalences) {
+  for (auto &pair : equivalences) {
+    std::string entry = pair.first + EquivalenceSeparator + pair.second;
+    llvm::Constant *constant = llvm::ConstantDataArray::getString(module.getContext(), entry);
+    auto *global = new llvm::GlobalVariable(module,
+                                            constant->getType(),
+                                            true,
+                                            llvm::GlobalVariable::InternalLinkage,
+                                            constant,
+                                            "mull_equivalence");
+    global->setSection(EquivalencesSection);
+    llvm::appendToUsed(module, { global });
+  }
+}
+
+void mull::decodeEquivalence(const std::string &entry, Equivalences &equivalences) {
+  size_t separator = entry.find(EquivalenceSeparator);
+  if (separator == std::string::npos) {
+    return;
+  }
+  equivalences[entry.substr(0, separator)] = entry.substr(separator + 1);
+}
+
+std::vector<std::unique_ptr<MutationResult>>
+mull::runDistinct(std::vector<std::unique_ptr<Mutant>> &mutants, const Equivalences &equivalences,
+                  const RunMutants &run) {
+  if (equivalences.empty()) {
+    return run(mutants);
+  }
+  std::unordered_set<std::string> present;
+  for (auto &mutant : mutants) {
+    present.insert(mutant->getIdentifier());
+  }
+  /// A single lookup: findEquivalentMutants points every duplicate at the first mutant with its
+  /// code, never at another duplicate. It is only merged with a mutant that runs in this run.
+  auto representativeOf = [&](const Mutant &mutant) -> std::string {
+    auto found = equivalences.find(mutant.getIdentifier());
+    if (found == equivalences.end() || found->second.empty() || !present.count(found->second)) {
+      return {};
+    }
+    return found->second;
+  };
+
+  auto known = [&](const Mutant &mutant) -> std::optional<ExecutionResult> {
+    auto found = equivalences.find(mutant.getIdentifier());
+    if (found != equivalences.end() && found->second.empty()) {
+      ExecutionResult result;
+      result.status = Equivalent;
+      return result;
+    }
+    return std::nullopt;
+  };
+  return runRemaining(mutants, known, [&](std::vector<std::unique_ptr<Mutant>> &remaining) {
+    std::vector<std::unique_ptr<Mutant>> distinct;
+    std::vector<std::unique_ptr<Mutant>> followers;
+    for (auto &mutant : remaining) {
+      if (representativeOf(*mutant).empty()) {
+        distinct.push_back(std::move(mutant));
+      } else {
+        followers.push_back(std::move(mutant));
+      }
+    }
+
+    auto results = run(distinct);
+    std::unordered_map<std::string, const ExecutionResult *> resultsByIdentifier;
+    for (auto &result : results) {
+      resultsByIdentifier[result->getMutant()->getIdentifier()] = &result->getExecutionResult();
+    }
+    std::vector<std::unique_ptr<MutationResult>> followerResults;
+    for (auto &mutant : followers) {
+      auto found = resultsByIdentifier.find(representativeOf(*mutant));
+      ExecutionResult result;
+      if (found != resultsByIdentifier.end()) {
+        result = *found->second;
+      } else {
+        result.status = NotCovered;
+      }
+      followerResults.push_back(std::make_unique<MutationResult>(std::move(result), mutant.get()));
+    }
+    std::move(followerResults.begin(), followerResults.end(), std::back_inserter(results));
+
+    /// runRemaining puts the mutants back in place from `remaining`
+    remaining.clear();
+    std::move(distinct.begin(), distinct.end(), std::back_inserter(remaining));
+    std::move(followers.begin(), followers.end(), std::back_inserter(remaining));
+    return results;
+  });
+}
@@ -0,0 +1,150 @@
+#include "mull/WeakMutation.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/MutationPoint.h"
+
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <iterator>
+
+using namespace mull;
+
+/// Block and instruction index, the mutated function is a copy of the original one
+static std::pair<size_t, size_t> positionOf(const llvm::Instruction &instruction) {
+  const llvm::BasicBlock *block = instruction.getParent();
+  return { std::distance(block->getParent()->begin(), block->getIterator()),
+           std::distance(block->begin(), instruction.getIterator()) };
+}
+
+static llvm::Instruction *instructionAt(llvm::Function &function,
+                                        std::pair<size_t, size_t> position) {
+  if (position.first >= function.size()) {
+    return nullptr;
+  }
+  llvm::BasicBlock &block = *std::next(function.begin(), position.first);
+  if (position.second >= block.size()) {
+    return nullptr;
+  }
+  return &*std::next(block.begin(), position.second);
+}
+
+/// The value of the original function standing where `value` stands in the mutated one
+static llvm::Value *correspondingValue(llvm::Function &original, llvm::Function &mutated,
+                                       llvm::Value *value) {
+  if (auto *argument = llvm::dyn_cast<llvm::Argument>(value)) {
+    return argument->getParent() == &mutated ? original.getArg(argument->getArgNo()) : nullptr;
+  }
+  if (auto *instruction = llvm::dyn_cast<llvm::Instruction>(value)) {
+    if (instruction->getFunction() != &mutated) {
+      return nullptr;
+    }
+    llvm::Instruction *candidate = instructionAt(original, positionOf(*instruction));
+    /// The mutation may have added or removed instructions before this one
+    if (!candidate || candidate->getOpcode() != instruction->getOpcode() ||
+        candidate->getType() != instruction->getType()) {
+      return nullptr;
+    }
+    return candidate;
+  }
+  if (llvm::isa<llvm::BlockAddress>(value)) {
+    return nullptr;
+  }
+  if (llvm::isa<llvm::Constant>(value)) {
+    return value;
+  }
+  return nullptr;
+}
+
+llvm::Instruction *mull::createWeakMutation(const MutationPoint &point) {
+  llvm::Function *mutatedFunction = point.getMutatedFunction();
+  if (!mutatedFunction) {
+    return nullptr;
+  }
+  auto *original = llvm::dyn_cast<llvm::Instruction>(point.getOriginalValue());
+  if (!original || original->isTerminator() || llvm::isa<llvm::PHINode>(original) ||
+      original->isEHPad()) {
+    return nullptr;
+  }
+  llvm::Type *type = original->getType();
+  if (!type->isIntegerTy() && !type->isFloatingPointTy()) {
+    return nullptr;
+  }
+  llvm::Function &originalFunction = *original->getFunction();
+  /// Mutators replace the instruction in place, anything else leaves the blocks of different sizes
+  llvm::Instruction *mutated = instructionAt(*mutatedFunction, positionOf(*original));
+  if (!mutated || mutated->getType() != type ||
+      mutated->getParent()->size() != original->getParent()->size() || mutated->isTerminator() ||
+      llvm::isa<llvm::PHINode>(mutated) || mutated->mayHaveSideEffects() ||
+      mutated->mayReadFromMemory()) {
+    return nullptr;
+  }
+
+  llvm::Instruction *copy = mutated->clone();
+  for (unsigned i = 0; i < copy->getNumOperands(); i++) {
+    llvm::Value *operand =
+        correspondingValue(originalFunction, *mutatedFunction, copy->getOperand(i));
+    if (!operand) {
+      copy->deleteValue();
+      return nullptr;
+    }
+    copy->setOperand(i, operand);
+  }
+  /// E.g. `add nsw` mutated into `sub nsw`: poison would make the comparison meaningless
+  copy->dropPoisonGeneratingFlags();
+  /// E.g. a division by a value that may be zero
+  if (copy->isIdenticalTo(original) || !llvm::isSafeToSpeculativelyExecute(copy)) {
+    copy->deleteValue();
+    return nullptr;
+  }
+  copy->setDebugLoc(original->getDebugLoc());
+  return copy;
+}
+
+bool WeakMutationReport::notInfected(const std::string &identifier) const {
+  return evaluated.count(identifier) != 0 && infected.count(identifier) == 0;
+}
+
+WeakMutationReport mull::readWeakMutationReport(Diagnostics &diagnostics,
+                                                const std::string &path) {
+  WeakMutationReport report;
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    diagnostics.warning("Cannot read weak mutation info from " + path + ": " +
+                        buffer.getError().message());
+    return report;
+  }
+  llvm::StringRef content = buffer.get()->getBuffer();
+  while (!content.empty()) {
+    auto [line, rest] = content.split('\n');
+    content = rest;
+    if (line.size() < 2) {
+      continue;
+    }
+    std::string identifier = line.drop_front().str();
+    /// Several processes (or modules) may report the same mutant: infected once is infected
+    if (line.front() == '+') {
+      report.infected.insert(identifier);
+    }
+    report.evaluated.insert(std::move(identifier));
+  }
+  return report;
+}
+
+std::vector<std::unique_ptr<MutationResult>>
+mull::runInfected(std::vector<std::unique_ptr<Mutant>> &mutants, const WeakMutationReport &report,
+                  const RunMutants &run) {
+  auto known = [&](const Mutant &mutant) -> std::optional<ExecutionResult> {
+    if (!report.notInfected(mutant.getIdentifier())) {
+      return std::nullopt;
+    }
+    ExecutionResult result;
+    result.status = Passed;
+    result.stderrOutput = "mull: the mutant's value never differed from the original one";
+    return result;
+  };
+  return runRemaining(mutants, known, run);
+}
@@ -0,0 +1,24 @@
+#include <stdio.h>
+#include <unistd.h>
+
+int sum(int a, int b) {
+  return a + b;
+}
+
+int main() {
+  if (sum(2, 5) != 7) {
+    printf("[  FAILED  ] Sum.works\n");
+    fflush(stdout);
+    // the rest of the suite, must not be waited for
+    sleep(60);
+    return 1;
+  }
+  return 0;
+}
+
+// clang-format off
+
+// RUN: %clang_cc %sysroot %s %pass_mull_ir_frontend -g -o %s-ir.exe
+// RUN: unset TERM; %mull_runner %s-ir.exe -debug -ide-reporter-show-killed | %filecheck %s --dump-input=fail
+// CHECK: {{.*}}main.c:5:12 ExecutionResult: FailFast
+// CHECK: {{.*}}main.c:5:12: warning: Killed: Replaced + with - [cxx_add_to_sub]
@@ -0,0 +1,20 @@
+int sum(int a, int b) {
+  return a + b;
+}
+
+int main() {
+  return sum(2, 5) != 7;
+}
+
+// clang-format off
+
+// RUN: %clang_cc %sysroot %s %pass_mull_ir_frontend -g -fprofile-instr-generate -fcoverage-mapping -o %s-ir.exe
+// RUN: rm -rf %s-cache
+
+// RUN: unset TERM; %mull_runner %s-ir.exe -result-cache %s-cache -ide-reporter-show-killed | %filecheck %s --dump-input=fail --check-prefix=CHECK-FIRST
+// CHECK-FIRST: [info] Result cache: 0 of 1 mutants unchanged
+// CHECK-FIRST: {{.*}}main.c:2:12: warning: Killed: Replaced + with - [cxx_add_to_sub]
+
+// RUN: unset TERM; %mull_runner %s-ir.exe -result-cache %s-cache -ide-reporter-show-killed | %filecheck %s --dump-input=fail --check-prefix=CHECK-SECOND
+// CHECK-SECOND: [info] Result cache: 1 of 1 mutants unchanged
+// CHECK-SECOND: {{.*}}main.c:2:12: warning: Killed: Replaced + with - [cxx_add_to_sub]
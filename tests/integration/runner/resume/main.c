@@ -0,0 +1,19 @@
+int sum(int a, int b) {
+  return a + b;
+}
+
+int main() {
+  return sum(2, 5) != 7;
+}
+
+// clang-format off
+
+// RUN: %clang_cc %sysroot %s %pass_mull_ir_frontend -g -o %s-ir.exe
+// RUN: rm -f %T/resume.sqlite
+// RUN: unset TERM; %mull_runner %s-ir.exe -reporters=SQLite -report-dir %T -report-name resume
+// RUN: unset TERM; %mull_runner %s-ir.exe -reporters=SQLite -resume %T/resume.sqlite -debug | %filecheck %s --dump-input=fail
+// CHECK: [info] Resuming {{.*}}resume.sqlite: 1 mutants have results
+// CHECK-NOT: ExecutionResult:
+// CHECK: [info] Results can be found at '{{.*}}resume.sqlite'
+// RUN: %mull_reporter %T/resume.sqlite -ide-reporter-show-killed | %filecheck %s --dump-input=fail --check-prefix=CHECK-REPORT
+// CHECK-REPORT: {{.*}}main.c:2:12: warning: Killed: Replaced + with - [cxx_add_to_sub]
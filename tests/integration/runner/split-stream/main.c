@@ -0,0 +1,32 @@
+#include <stdio.h>
+
+int sum(int a, int b) {
+  return a + b;
+}
+
+int mul(int a, int b) {
+  return a * b;
+}
+
+int main() {
+  /// Printed once by the unmutated program, not again by every mutant
+  printf("setting up\n");
+  return sum(2, 5) != 7 || mul(2, 1) != 2;
+}
+
+// clang-format off
+
+// RUN: %clang_cc %sysroot %s %pass_mull_ir_frontend -g -o %s-ir.exe
+
+// RUN: %mull_runner %s-ir.exe --allow-surviving -ide-reporter-show-killed | %filecheck %s --dump-input=fail --match-full-lines
+// CHECK-NOT: {{.*}}split points{{.*}}
+// CHECK: [info] Killed mutants (1/2):
+// CHECK: {{.*}}/main.c:4:12: warning: Killed: Replaced + with - [cxx_add_to_sub]
+// CHECK:   return a + b;
+// CHECK:            ^
+// CHECK: [info] Survived mutants (1/2):
+// CHECK: {{.*}}/main.c:8:12: warning: Survived: Replaced * with / [cxx_mul_to_div]
+// CHECK:   return a * b;
+// CHECK:            ^
+
+// RUN: %mull_runner %s-ir.exe --allow-surviving -ide-reporter-show-killed --split-stream=false | %filecheck %s --dump-input=fail --match-full-lines
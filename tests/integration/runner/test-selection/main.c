@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int sum(int a, int b) {
+  return a + b;
+}
+
+int mul(int a, int b) {
+  return a * b;
+}
+
+static int test_sum(void) {
+  sum(1, 2);
+  return 0;
+}
+
+static int test_mul(void) {
+  return mul(2, 3) != 6;
+}
+
+/// Fails whenever a mutant is enabled: it must not run for mutants it does not cover
+static int test_env(void) {
+  const char *mutant = getenv("MULL_MUTANT_ID");
+  return mutant != NULL && mutant[0] != '\0';
+}
+
+struct test {
+  const char *name;
+  int (*run)(void);
+};
+
+static struct test tests[] = {
+  { "Math.sum", test_sum },
+  { "Math.mul", test_mul },
+  { "Other.env", test_env },
+};
+
+/// Mimics the GoogleTest command line
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "--gtest_list_tests") == 0) {
+    printf("Math.\n  sum\n  mul\nOther.\n  env\n");
+    return 0;
+  }
+  const char *filter = NULL;
+  if (argc > 1 && strncmp(argv[1], "--gtest_filter=", strlen("--gtest_filter=")) == 0) {
+    filter = strchr(argv[1], '=');
+  }
+  int failed = 0;
+  for (struct test *test = tests; test != tests + 3; test++) {
+    if (filter && !strstr(filter, test->name)) {
+      continue;
+    }
+    if (test->run()) {
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+// clang-format off
+
+// RUN: %clang_cc %sysroot %s %pass_mull_ir_frontend -g -fprofile-instr-generate -fcoverage-mapping -o %s-ir.exe
+
+// RUN: unset TERM; %mull_runner %s-ir.exe --allow-surviving -ide-reporter-show-killed -test-framework=gtest | %filecheck %s --dump-input=fail --match-full-lines --check-prefix=CHECK-SELECTED
+// CHECK-SELECTED: [info] Killed mutants (1/2):
+// CHECK-SELECTED: {{.*}}/main.c:10:12: warning: Killed: Replaced * with / [cxx_mul_to_div]
+// CHECK-SELECTED: [info] Survived mutants (1/2):
+// CHECK-SELECTED: {{.*}}/main.c:6:12: warning: Survived: Replaced + with - [cxx_add_to_sub]
+
+// RUN: unset TERM; %mull_runner %s-ir.exe --allow-surviving -ide-reporter-show-killed | %filecheck %s --dump-input=fail --match-full-lines --check-prefix=CHECK-ALL
+// CHECK-ALL: [info] Killed mutants (2/2):
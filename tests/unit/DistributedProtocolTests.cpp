@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include "mull/Distributed/Protocol.h"
+
+#include <string>
+#include <vector>
+
+using namespace mull;
+using namespace mull::protocol;
+
+TEST(DistributedProtocol, DecodesRequest) {
+  std::string buffer = encodeRequest(8);
+  bool malformed = true;
+  auto message = decodeMessage(buffer, malformed);
+  ASSERT_TRUE(message.has_value());
+  ASSERT_FALSE(malformed);
+  ASSERT_EQ(message->kind, MessageKind::Request);
+  ASSERT_EQ(message->count, 8U);
+  ASSERT_TRUE(buffer.empty());
+}
+
+TEST(DistributedProtocol, DecodesWork) {
+  std::vector<std::string> identifiers({ "cxx_add_to_sub:main.c:3:12", "cxx_eq_to_ne:x y.c:1:1" });
+  std::string buffer = encodeWork(identifiers);
+  bool malformed = false;
+  auto message = decodeMessage(buffer, malformed);
+  ASSERT_TRUE(message.has_value());
+  ASSERT_EQ(message->kind, MessageKind::Work);
+  ASSERT_EQ(message->identifiers, identifiers);
+}
+
+TEST(DistributedProtocol, DecodesAlive) {
+  std::string buffer = encodeAlive() + encodeRequest(1);
+  bool malformed = true;
+  auto message = decodeMessage(buffer, malformed);
+  ASSERT_TRUE(message.has_value());
+  ASSERT_FALSE(malformed);
+  ASSERT_EQ(message->kind, MessageKind::Alive);
+  ASSERT_EQ(buffer, encodeRequest(1));
+}
+
+TEST(DistributedProtocol, DecodesResult) {
+  ExecutionResult result;
+  result.status = Crashed;
+  result.exitStatus = 11 + SignalExitStatusOffset;
+  result.runningTime = 42;
+  result.cpuTime = 40;
+  result.stdoutOutput = "line 1\nline 2\n";
+  result.stderrOutput = "RESULT 1 2 3\n";
+  std::string buffer = encodeResult("cxx_add_to_sub:main.c:3:12", result);
+  bool malformed = false;
+  auto message = decodeMessage(buffer, malformed);
+  ASSERT_TRUE(message.has_value());
+  ASSERT_EQ(message->kind, MessageKind::Result);
+  ASSERT_EQ(message->identifiers.front(), "cxx_add_to_sub:main.c:3:12");
+  ASSERT_EQ(message->result.status, Crashed);
+  ASSERT_EQ(message->result.exitStatus, result.exitStatus);
+  ASSERT_EQ(message->result.runningTime, 42);
+  ASSERT_EQ(message->result.cpuTime, 40);
+  ASSERT_EQ(message->result.stdoutOutput, result.stdoutOutput);
+  ASSERT_EQ(message->result.stderrOutput, result.stderrOutput);
+}
+
+TEST(DistributedProtocol, WaitsForWholeMessage) {
+  std::string message = encodeWork({ "first", "second" }) + encodeDone();
+  std::string buffer;
+  bool malformed = false;
+  for (size_t i = 0; i < message.size() - encodeDone().size() - 1; i++) {
+    buffer.push_back(message[i]);
+    ASSERT_FALSE(decodeMessage(buffer, malformed).has_value());
+    ASSERT_FALSE(malformed);
+  }
+  buffer = message;
+  ASSERT_EQ(decodeMessage(buffer, malformed)->kind, MessageKind::Work);
+  ASSERT_EQ(decodeMessage(buffer, malformed)->kind, MessageKind::Done);
+  ASSERT_FALSE(decodeMessage(buffer, malformed).has_value());
+  ASSERT_FALSE(malformed);
+}
+
+TEST(DistributedProtocol, RejectsMalformedMessages) {
+  bool malformed = false;
+  std::string unknown = "HELLO\n";
+  ASSERT_FALSE(decodeMessage(unknown, malformed).has_value());
+  ASSERT_TRUE(malformed);
+
+  std::string truncated = "RESULT 12 abc\n";
+  ASSERT_FALSE(decodeMessage(truncated, malformed).has_value());
+  ASSERT_TRUE(malformed);
+}
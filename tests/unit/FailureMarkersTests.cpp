@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+
+#include "mull/FailureMarkers.h"
+
+#include <string>
+#include <vector>
+
+using namespace mull;
+
+TEST(FailureMarkers, FindsMarkerInChunk) {
+  std::vector<std::string> markers({ "[  FAILED  ]" });
+  FailureMarkers failureMarkers(markers);
+  std::string passed = "[       OK ] Sum.positive\n";
+  std::string failed = "[  FAILED  ] Sum.negative\n";
+  ASSERT_FALSE(failureMarkers.scan(passed.data(), passed.size()));
+  ASSERT_TRUE(failureMarkers.scan(failed.data(), failed.size()));
+}
+
+TEST(FailureMarkers, FindsMarkerSplitBetweenChunks) {
+  std::vector<std::string> markers({ "FAILED:" });
+  FailureMarkers failureMarkers(markers);
+  std::string first = "test.cpp:12: FAI";
+  std::string second = "LED:\n";
+  ASSERT_FALSE(failureMarkers.scan(first.data(), first.size()));
+  ASSERT_TRUE(failureMarkers.scan(second.data(), second.size()));
+}
+
+TEST(FailureMarkers, IgnoresEmptyMarkers) {
+  std::vector<std::string> markers({ "" });
+  FailureMarkers failureMarkers(markers);
+  std::string output = "anything";
+  ASSERT_FALSE(failureMarkers.scan(output.data(), output.size()));
+}
@@ -0,0 +1,12 @@
+#include "MutantFactory.h"
+
+using namespace mull;
+
+std::unique_ptr<Mutant> mull_test::mutant(const std::string &identifier,
+                                          const std::string &mutator, const std::string &path,
+                                          size_t line, size_t column) {
+  SourceLocation location("", path, "", path, line, column);
+  auto mutant = std::make_unique<Mutant>(identifier, mutator, location, location);
+  mutant->setCovered(true);
+  return mutant;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "mull/Mutant.h"
+
+#include <memory>
+#include <string>
+
+namespace mull_test {
+
+/// A covered mutant starting and ending at `path`:`line`:`column`
+std::unique_ptr<mull::Mutant> mutant(const std::string &identifier,
+                                     const std::string &mutator = "cxx_add_to_sub",
+                                     const std::string &path = "sum.c", size_t line = 1,
+                                     size_t column = 1);
+
+} // namespace mull_test
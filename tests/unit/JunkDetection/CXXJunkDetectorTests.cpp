@@ -1,6 +1,7 @@
 #include "FixturePaths.h"
 #include "mull/FunctionUnderTest.h"
 #include "mull/JunkDetection/CXX/CXXJunkDetector.h"
+#include "mull/JunkDetection/CXX/MutationSites.h"
 #include "mull/MutationPoint.h"
 #include "mull/Mutators/CXX/CallMutators.h"
 #include "mull/Mutators/NegateConditionMutator.h"
@@ -12,8 +13,11 @@
 #include <mull/Mutators/CXX/RelationalMutators.h>
 #include <mull/Mutators/CXX/RemoveNegation.h>
 
+#include <clang/Lex/Lexer.h>
 #include <gtest/gtest.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
 
 using namespace mull;
 using namespace llvm;
@@ -65,6 +69,40 @@ TEST_P(CXXJunkDetectorTest, detectJunk) {
   ASSERT_EQ(nonJunkMutationPoints.size(), parameter.nonJunkMutants);
 }
 
+TEST_P(CXXJunkDetectorTest, detectJunkFromRecordedSites) {
+  Diagnostics diagnostics;
+  auto &parameter = GetParam();
+  BitcodeLoader loader;
+  auto bitcode = loader.loadBitcodeAtPath(parameter.bitcodePath, diagnostics);
+
+  std::vector<MutationPoint *> points;
+  for (auto &function : bitcode->getModule()->functions()) {
+    FunctionUnderTest functionUnderTest(&function, bitcode.get());
+    functionUnderTest.selectInstructions({});
+    auto mutants = parameter.mutator->getMutations(bitcode.get(), functionUnderTest);
+    std::copy(mutants.begin(), mutants.end(), std::back_inserter(points));
+  }
+  ASSERT_FALSE(points.empty());
+
+  /// As the compiler plugin would have recorded them
+  ASTStorage astStorage(diagnostics, "", "", {});
+  ThreadSafeASTUnit *ast = astStorage.findAST(points.front()->getSourceLocation());
+  ASSERT_TRUE(ast->hasAST());
+  recordMutationSites(*bitcode->getModule(), encodeMutationSites(ast->getASTContext()));
+  ASSERT_TRUE(hasMutationSites(*bitcode->getModule()));
+
+  RecordedSitesJunkDetector detector(diagnostics, *bitcode->getModule());
+
+  std::vector<MutationPoint *> nonJunkMutationPoints;
+  for (auto point : points) {
+    if (!detector.isJunk(point)) {
+      nonJunkMutationPoints.push_back(point);
+    }
+  }
+
+  ASSERT_EQ(nonJunkMutationPoints.size(), parameter.nonJunkMutants);
+}
+
 static const CXXJunkDetectorTestParameter parameters[] = {
   CXXJunkDetectorTestParameter(fixtures::tests_unit_fixtures_mutators_boundary_module_cpp_bc_path(),
                                new cxx::LessThanToLessOrEqual, 3),
@@ -304,3 +342,133 @@ TEST(CXXJunkDetector, no_compdb) {
 
   ASSERT_EQ(nonJunkMutationPoints.size(), 7U);
 }
+
+TEST(CXXJunkDetector, ast_cache) {
+  Diagnostics diagnostics;
+  BitcodeLoader loader;
+  auto bitcode = loader.loadBitcodeAtPath(
+      fixtures::tests_unit_fixtures_mutators_boundary_module_cpp_bc_path(), diagnostics);
+
+  cxx::LessThanToLessOrEqual mutator;
+  std::vector<MutationPoint *> points;
+  for (auto &function : bitcode->getModule()->functions()) {
+    FunctionUnderTest functionUnderTest(&function, bitcode.get());
+    functionUnderTest.selectInstructions({});
+    auto mutants = mutator.getMutations(bitcode.get(), functionUnderTest);
+    std::copy(mutants.begin(), mutants.end(), std::back_inserter(points));
+  }
+
+  llvm::SmallString<PATH_MAX> directory;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("mull-ast-cache", directory));
+
+  auto nonJunkMutants = [&]() {
+    ASTStorage astStorage(diagnostics, "", "", {});
+    astStorage.enableCache(directory.str().str(), 1024 * 1024 * 1024);
+    CXXJunkDetector detector(diagnostics, astStorage);
+    return std::count_if(
+        points.begin(), points.end(), [&](MutationPoint *point) { return !detector.isJunk(point); });
+  };
+
+  /// Parsed, then loaded from the cache
+  ASSERT_EQ(nonJunkMutants(), 3);
+  std::error_code error;
+  size_t entries = 0;
+  for (llvm::sys::fs::directory_iterator it(directory, error), end; !error && it != end;
+       it.increment(error)) {
+    entries += llvm::sys::path::extension(it->path()) == ".ast";
+  }
+  ASSERT_EQ(entries, 1U);
+  ASSERT_EQ(nonJunkMutants(), 3);
+
+  llvm::sys::fs::remove_directories(directory);
+}
+
+TEST(CXXJunkDetector, junk_verdicts) {
+  Diagnostics diagnostics;
+  BitcodeLoader loader;
+  auto bitcode = loader.loadBitcodeAtPath(
+      fixtures::tests_unit_fixtures_mutators_boundary_module_cpp_bc_path(), diagnostics);
+
+  cxx::LessThanToLessOrEqual mutator;
+  std::vector<MutationPoint *> points;
+  for (auto &function : bitcode->getModule()->functions()) {
+    FunctionUnderTest functionUnderTest(&function, bitcode.get());
+    functionUnderTest.selectInstructions({});
+    auto mutants = mutator.getMutations(bitcode.get(), functionUnderTest);
+    std::copy(mutants.begin(), mutants.end(), std::back_inserter(points));
+  }
+
+  llvm::SmallString<PATH_MAX> directory;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("mull-ast-cache", directory));
+
+  std::vector<std::pair<size_t, size_t>> ends;
+  {
+    ASTStorage astStorage(diagnostics, "", "", {});
+    astStorage.enableCache(directory.str().str(), 1024 * 1024 * 1024);
+    CXXJunkDetector detector(diagnostics, astStorage);
+    for (auto point : points) {
+      detector.isJunk(point);
+      ends.emplace_back(point->getEndLocation().line, point->getEndLocation().column);
+    }
+    astStorage.storeVerdicts();
+  }
+
+  /// Without the ASTs, the verdicts are all there is to go by
+  std::error_code error;
+  for (llvm::sys::fs::directory_iterator it(directory, error), end; !error && it != end;
+       it.increment(error)) {
+    if (llvm::sys::path::extension(it->path()) == ".ast") {
+      llvm::sys::fs::remove(it->path());
+    }
+  }
+
+  ASTStorage astStorage(diagnostics, "", "", {});
+  astStorage.enableCache(directory.str().str(), 1024 * 1024 * 1024);
+  CXXJunkDetector detector(diagnostics, astStorage);
+  size_t nonJunkMutants = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    JunkVerdict verdict;
+    ASSERT_TRUE(astStorage.findVerdict(points[i], verdict));
+    if (!detector.isJunk(points[i])) {
+      nonJunkMutants++;
+      ASSERT_EQ(points[i]->getEndLocation().line, ends[i].first);
+      ASSERT_EQ(points[i]->getEndLocation().column, ends[i].second);
+    }
+  }
+  ASSERT_EQ(nonJunkMutants, 3U);
+
+  llvm::sys::fs::remove_directories(directory);
+}
+
+TEST(CXXJunkDetector, recorded_locations) {
+  Diagnostics diagnostics;
+  BitcodeLoader loader;
+  auto bitcode = loader.loadBitcodeAtPath(
+      fixtures::tests_unit_fixtures_mutators_boundary_module_cpp_bc_path(), diagnostics);
+
+  cxx::LessThanToLessOrEqual mutator;
+  ASTStorage astStorage(diagnostics, "", "", {});
+  size_t checked = 0;
+  for (auto &function : bitcode->getModule()->functions()) {
+    FunctionUnderTest functionUnderTest(&function, bitcode.get());
+    functionUnderTest.selectInstructions({});
+    for (auto point : mutator.getMutations(bitcode.get(), functionUnderTest)) {
+      auto &sourceLocation = point->getSourceLocation();
+      ThreadSafeASTUnit *ast = astStorage.findAST(sourceLocation);
+      ASSERT_TRUE(ast->hasAST());
+      clang::SourceManager &sourceManager = ast->getSourceManager();
+
+      /// Resolved from the tables recorded with the unit, checked against the source manager
+      clang::SourceLocation location = ast->getLocation(sourceLocation);
+      ASSERT_EQ(sourceManager.getExpansionLineNumber(location), sourceLocation.line);
+      ASSERT_EQ(sourceManager.getExpansionColumnNumber(location), sourceLocation.column);
+      ASSERT_NE(ast->getDecl(location), nullptr);
+      ASSERT_FALSE(ast->isInSystemHeader(location));
+      ASSERT_EQ(ast->getLocForEndOfToken(location),
+                clang::Lexer::getLocForEndOfToken(
+                    location, 0, sourceManager, ast->getASTContext().getLangOpts()));
+      checked++;
+    }
+  }
+  ASSERT_NE(checked, 0U);
+}
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+
+#include "mull/MutantManifest.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <string>
+#include <vector>
+
+using namespace mull;
+
+static std::vector<std::string> readIdentifiers(llvm::StringRef section, bool &complete) {
+  std::vector<std::string> identifiers;
+  complete = readMutantManifests(section, [&](const ManifestMutant &mutant) {
+    identifiers.push_back(mutantIdentifier(mutant));
+  });
+  return identifiers;
+}
+
+TEST(MutantManifest, ReadsWrittenMutants) {
+  MutantManifestWriter manifest;
+  manifest.add("cxx_add_to_sub", "/src/sum.c", 1, 34, 1, 35);
+  manifest.add("cxx_remove_void_call", "/src/sum.c", 3, 5, 4, 12);
+  manifest.add("cxx_add_to_sub", "/src/mul.c", 200000, 70000, 200000, 70001);
+
+  bool complete = false;
+  auto identifiers = readIdentifiers(manifest.encode(), complete);
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(identifiers,
+            std::vector<std::string>({ "cxx_add_to_sub:/src/sum.c:1:34:1:35",
+                                       "cxx_remove_void_call:/src/sum.c:3:5:4:12",
+                                       "cxx_add_to_sub:/src/mul.c:200000:70000:200000:70001" }));
+}
+
+TEST(MutantManifest, KeepsEndLocationAsIs) {
+  MutantManifestWriter manifest;
+  /// IR mutants keep the end 0:0 without junk detection
+  manifest.add("cxx_assign_const", "/src/sum.c", 7, 5, 0, 0);
+  manifest.add("cxx_add_to_sub", "/src/sum.c", 12, 3, 10, 4);
+
+  bool complete = false;
+  auto identifiers = readIdentifiers(manifest.encode(), complete);
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(identifiers,
+            std::vector<std::string>({ "cxx_assign_const:/src/sum.c:7:5:0:0",
+                                       "cxx_add_to_sub:/src/sum.c:12:3:10:4" }));
+}
+
+TEST(MutantManifest, StoresStringsOnce) {
+  MutantManifestWriter manifest;
+  std::string file(200, 'f');
+  for (uint32_t line = 1; line <= 100; line++) {
+    manifest.add("cxx_add_to_sub", file, line, 1, line, 2);
+  }
+  /// The strings versions wrote 100 * 220 bytes
+  ASSERT_LT(manifest.encode().size(), file.size() + 100 * 8);
+}
+
+TEST(MutantManifest, ReadsLinkedSections) {
+  MutantManifestWriter first;
+  first.add("cxx_add_to_sub", "/src/sum.c", 1, 34, 1, 35);
+  MutantManifestWriter second;
+  second.add("cxx_sub_to_add", "/src/c:/sub.c", 2, 3, 2, 4);
+
+  /// Padding between sections and strings written by older versions
+  std::string section = first.encode() + std::string(3, '\0') + second.encode() + '\0' +
+                        "cxx_mul_to_div:/src/c:/mul.c:5:6:5:7" + '\0';
+  bool complete = false;
+  auto identifiers = readIdentifiers(section, complete);
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(identifiers,
+            std::vector<std::string>({ "cxx_add_to_sub:/src/sum.c:1:34:1:35",
+                                       "cxx_sub_to_add:/src/c:/sub.c:2:3:2:4",
+                                       "cxx_mul_to_div:/src/c:/mul.c:5:6:5:7" }));
+}
+
+TEST(MutantManifest, RejectsTruncatedManifest) {
+  MutantManifestWriter manifest;
+  manifest.add("cxx_add_to_sub", "/src/sum.c", 1, 34, 1, 35);
+  std::string encoding = manifest.encode();
+
+  bool complete = true;
+  auto identifiers = readIdentifiers(llvm::StringRef(encoding).drop_back(2), complete);
+  ASSERT_FALSE(complete);
+  ASSERT_TRUE(identifiers.empty());
+}
+
+TEST(MutantManifest, RecordsManifestInModule) {
+  llvm::LLVMContext context;
+  llvm::Module module("manifest", context);
+  MutantManifestWriter manifest;
+  manifest.add("cxx_add_to_sub", "/src/sum.c", 1, 34, 1, 35);
+  recordMutantManifest(module, manifest);
+
+  auto global = module.getGlobalVariable("mull_mutant_manifest", true);
+  ASSERT_NE(global, nullptr);
+  ASSERT_EQ(global->getSection(), MutantsSection);
+  auto data = llvm::cast<llvm::ConstantDataSequential>(global->getInitializer());
+  ASSERT_EQ(data->getRawDataValues(), manifest.encode());
+}
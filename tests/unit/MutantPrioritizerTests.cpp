@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+
+#include "mull/MutantPrioritizer.h"
+#include "tests/unit/Helpers/MutantFactory.h"
+
+#include <memory>
+#include <string>
+
+using namespace mull;
+using mull_test::mutant;
+
+TEST(MutantPrioritizer, UnknownMutantsAreEquallyLikely) {
+  MutantPrioritizer prioritizer;
+  ASSERT_TRUE(prioritizer.empty());
+  ASSERT_EQ(prioritizer.survivalChance(*mutant("cxx_add_to_sub:sum.c:1:34", "cxx_add_to_sub")),
+            0.5);
+}
+
+TEST(MutantPrioritizer, UsesMutatorSurvivalRate) {
+  MutantPrioritizer prioritizer;
+  prioritizer.addResult("cxx_add_to_sub:sum.c:1:34", "cxx_add_to_sub", Failed);
+  prioritizer.addResult("cxx_add_to_sub:sum.c:2:10", "cxx_add_to_sub", Crashed);
+  prioritizer.addResult("cxx_remove_void_call:sum.c:3:5", "cxx_remove_void_call", Passed);
+  prioritizer.addResult("cxx_remove_void_call:sum.c:4:5", "cxx_remove_void_call", NotCovered);
+  ASSERT_FALSE(prioritizer.empty());
+
+  auto add = mutant("cxx_add_to_sub:sum.c:7:1", "cxx_add_to_sub");
+  auto call = mutant("cxx_remove_void_call:sum.c:8:1", "cxx_remove_void_call");
+  ASSERT_DOUBLE_EQ(prioritizer.survivalChance(*add), 0.25);
+  ASSERT_DOUBLE_EQ(prioritizer.survivalChance(*call), 2.0 / 3.0);
+}
+
+TEST(MutantPrioritizer, PreviousSurvivorsComeFirst) {
+  MutantPrioritizer prioritizer;
+  for (int i = 0; i < 8; i++) {
+    prioritizer.addResult("cxx_add_to_sub:sum.c:" + std::to_string(i), "cxx_add_to_sub", Failed);
+  }
+  prioritizer.addResult("cxx_add_to_sub:sum.c:8", "cxx_add_to_sub", Passed);
+  prioritizer.addResult("cxx_add_to_sub:sum.c:8", "cxx_add_to_sub", Passed);
+
+  auto survivor = mutant("cxx_add_to_sub:sum.c:8", "cxx_add_to_sub");
+  auto killed = mutant("cxx_add_to_sub:sum.c:0", "cxx_add_to_sub");
+  auto unknown = mutant("cxx_add_to_sub:sum.c:9", "cxx_add_to_sub");
+  ASSERT_GT(prioritizer.survivalChance(*survivor), 0.5);
+  ASSERT_GT(prioritizer.survivalChance(*survivor), prioritizer.survivalChance(*unknown));
+  ASSERT_GT(prioritizer.survivalChance(*unknown), prioritizer.survivalChance(*killed));
+}
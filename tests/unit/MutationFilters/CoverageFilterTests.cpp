@@ -0,0 +1,94 @@
+#include "mull/Config/Configuration.h"
+#include "mull/Filters/CoverageFilter.h"
+#include "tests/unit/Helpers/MutantFactory.h"
+
+#include <gtest/gtest.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <memory>
+#include <string>
+
+using namespace mull;
+
+static bool covered(CoverageFilter &filter, const std::string &path, size_t line, size_t column) {
+  auto mutant = mull_test::mutant("cxx_add_to_sub", "cxx_add_to_sub", path, line, column);
+  return filter.covered(mutant.get());
+}
+
+TEST(CoverageFilter, MutantOnRegionBoundariesIsNotCovered) {
+  Configuration configuration;
+  CoverageFilter filter(configuration, { { "sum.c", 3, 5, 3, 20 } });
+  ASSERT_TRUE(covered(filter, "sum.c", 3, 4));
+  ASSERT_FALSE(covered(filter, "sum.c", 3, 5));
+  ASSERT_FALSE(covered(filter, "sum.c", 3, 20));
+  ASSERT_TRUE(covered(filter, "sum.c", 3, 21));
+}
+
+TEST(CoverageFilter, NestedRegions) {
+  Configuration configuration;
+  CoverageFilter filter(configuration,
+                        { { "sum.c", 2, 1, 8, 1 }, { "sum.c", 4, 3, 5, 10 } });
+  ASSERT_FALSE(covered(filter, "sum.c", 2, 1));
+  ASSERT_FALSE(covered(filter, "sum.c", 4, 5));
+  ASSERT_FALSE(covered(filter, "sum.c", 6, 1));
+  ASSERT_FALSE(covered(filter, "sum.c", 8, 1));
+  ASSERT_TRUE(covered(filter, "sum.c", 8, 2));
+}
+
+TEST(CoverageFilter, AdjacentRegionsOnTheSameLine) {
+  Configuration configuration;
+  CoverageFilter filter(configuration,
+                        { { "sum.c", 3, 11, 3, 20 }, { "sum.c", 3, 5, 3, 10 } });
+  ASSERT_FALSE(covered(filter, "sum.c", 3, 10));
+  ASSERT_FALSE(covered(filter, "sum.c", 3, 11));
+  ASSERT_TRUE(covered(filter, "sum.c", 3, 21));
+}
+
+TEST(CoverageFilter, RegionsAcrossLines) {
+  Configuration configuration;
+  CoverageFilter filter(configuration,
+                        { { "sum.c", 3, 30, 5, 2 }, { "sum.c", 7, 1, 7, 5 } });
+  ASSERT_TRUE(covered(filter, "sum.c", 3, 29));
+  ASSERT_FALSE(covered(filter, "sum.c", 3, 80));
+  ASSERT_FALSE(covered(filter, "sum.c", 4, 1));
+  ASSERT_FALSE(covered(filter, "sum.c", 5, 1));
+  ASSERT_TRUE(covered(filter, "sum.c", 5, 3));
+  ASSERT_TRUE(covered(filter, "sum.c", 6, 40));
+  ASSERT_FALSE(covered(filter, "sum.c", 7, 3));
+}
+
+TEST(CoverageFilter, FilesWithoutCoverageAreCovered) {
+  Configuration configuration;
+  CoverageFilter filter(configuration, { { "sum.c", 3, 5, 3, 20 } });
+  ASSERT_TRUE(covered(filter, "mul.c", 3, 10));
+}
+
+TEST(CoverageFilter, FindsFileByRawAndAbsolutePath) {
+  llvm::SmallString<128> root;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("mull-coverage-filter", root));
+  llvm::SmallString<128> directory(root);
+  llvm::sys::path::append(directory, "src");
+  ASSERT_FALSE(llvm::sys::fs::create_directory(directory));
+  llvm::SmallString<128> file(root);
+  llvm::sys::path::append(file, "sum.c");
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream stream(file, error);
+    stream << "int sum(int a, int b) { return a + b; }";
+  }
+  llvm::SmallString<128> rawPath(directory);
+  llvm::sys::path::append(rawPath, "..", "sum.c");
+  llvm::SmallString<128> absolutePath;
+  ASSERT_FALSE(llvm::sys::fs::real_path(file, absolutePath));
+
+  Configuration configuration;
+  CoverageFilter filter(configuration, { { rawPath.str().str(), 1, 25, 1, 38 } });
+  ASSERT_FALSE(covered(filter, rawPath.str().str(), 1, 34));
+  ASSERT_FALSE(covered(filter, absolutePath.str().str(), 1, 34));
+  ASSERT_TRUE(covered(filter, absolutePath.str().str(), 1, 1));
+
+  llvm::sys::fs::remove_directories(root);
+}
@@ -9,6 +9,7 @@
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Verifier.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <mull/Diagnostics/Diagnostics.h>
@@ -92,6 +93,41 @@ TEST(MutationPoint, OriginalValuePresent) {
   }
 }
 
+TEST(MutationPoint, MutantSchemata) {
+  Diagnostics diagnostics;
+  BitcodeLoader loader;
+  Configuration configuration{};
+  configuration.mutantSchemata = true;
+  auto bitcode = loader.loadBitcodeAtPath(
+      fixtures::tests_unit_fixtures_mutators_replace_assignment_module_c_bc_path(), diagnostics);
+
+  llvm::Function *function = bitcode->getModule()->getFunction("replace_assignment");
+  cxx::NumberAssignConst mutator;
+  FunctionUnderTest functionUnderTest(function, bitcode.get());
+  functionUnderTest.selectInstructions({});
+  auto mutationPoints = mutator.getMutations(bitcode.get(), functionUnderTest);
+
+  ASSERT_EQ(2U, mutationPoints.size());
+
+  for (auto *mutation : mutationPoints) {
+    bitcode->addMutation(mutation);
+  }
+  size_t originalBlocks = function->size();
+
+  CloneMutatedFunctionsTask::cloneFunctions(*bitcode, configuration.mutantSchemata);
+  ASSERT_TRUE(bitcode->hasMutantSchema(function));
+  llvm::Function *schema = mutationPoints[0]->getMutatedFunction();
+  ASSERT_EQ(schema, mutationPoints[1]->getMutatedFunction());
+
+  DeleteOriginalFunctionsTask::deleteFunctions(*bitcode);
+  InsertMutationTrampolinesTask::insertTrampolines(*bitcode, configuration);
+  ApplyMutantSchemataTask::applySchemata(*bitcode);
+
+  /// Each mutant branches around its own instruction: three blocks more
+  ASSERT_EQ(schema->size(), originalBlocks + 3 * mutationPoints.size());
+  ASSERT_FALSE(llvm::verifyModule(*bitcode->getModule(), &llvm::errs()));
+}
+
 TEST(MutationPoint, dump) {
   Diagnostics diagnostics;
   BitcodeLoader loader;
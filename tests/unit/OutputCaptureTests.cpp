@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+
+#include "mull/OutputCapture.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+
+#include <string>
+
+using namespace mull;
+
+static void append(OutputCapture &capture, const std::string &data) {
+  capture.append(data.data(), data.size());
+}
+
+TEST(OutputCapture, KeepsEverythingWithoutLimit) {
+  OutputCapture capture;
+  append(capture, "hello ");
+  append(capture, std::string(10000, 'x'));
+  ASSERT_EQ(capture.take(), "hello " + std::string(10000, 'x'));
+}
+
+TEST(OutputCapture, KeepsOutputUnderLimit) {
+  OutputCapture capture(16);
+  append(capture, "0123456789");
+  append(capture, "abcdef");
+  ASSERT_EQ(capture.take(), "0123456789abcdef");
+}
+
+TEST(OutputCapture, KeepsHeadAndTail) {
+  OutputCapture capture(8);
+  append(capture, "head");
+  for (int i = 0; i < 1000; i++) {
+    append(capture, "....");
+  }
+  append(capture, "ta");
+  append(capture, "il");
+  ASSERT_EQ(capture.take(), "head\n[mull: 4000 bytes omitted]\ntail");
+}
+
+TEST(OutputCapture, TakeResets) {
+  OutputCapture capture(4);
+  append(capture, "0123456789");
+  ASSERT_EQ(capture.take(), "01\n[mull: 6 bytes omitted]\n89");
+  append(capture, "ab");
+  ASSERT_EQ(capture.take(), "ab");
+}
+
+TEST(OutputCapture, SpillsWholeOutput) {
+  llvm::SmallString<128> root;
+  llvm::sys::fs::createUniqueDirectory("mull-output-capture", root);
+  llvm::SmallString<128> path(root);
+  llvm::sys::path::append(path, "mutant.stdout");
+
+  OutputCapture capture(4, path.str().str());
+  append(capture, "0123456789");
+  ASSERT_EQ(capture.take(), "01\n[mull: 6 bytes omitted]\n89");
+
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  ASSERT_TRUE(bool(buffer));
+  ASSERT_EQ(buffer.get()->getBuffer().str(), "0123456789");
+  llvm::sys::fs::remove_directories(root);
+}
@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/ResultCache.h"
+#include "tests/unit/Helpers/MutantFactory.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mull;
+
+namespace {
+class ResultCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    llvm::sys::fs::createUniqueDirectory("mull-result-cache", root);
+    cacheDirectory = file("cache");
+    writeFile("sum.c", "int sum(int a, int b) { return a + b; }");
+    writeFile("sum_test.c", "assert(sum(2, 3) == 5);");
+    writeFile("mul_test.c", "assert(mul(2, 3) == 6);");
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(root);
+  }
+
+  std::string file(const std::string &name) {
+    llvm::SmallString<128> path(root);
+    llvm::sys::path::append(path, name);
+    return path.str().str();
+  }
+
+  void writeFile(const std::string &name, const std::string &content) {
+    std::error_code error;
+    llvm::raw_fd_ostream stream(file(name), error);
+    stream << content;
+  }
+
+  std::unique_ptr<Mutant> mutant(const std::string &identifier) {
+    return mull_test::mutant(identifier, "cxx_add_to_sub", file("sum.c"), 1, 34);
+  }
+
+  ResultCache cache() {
+    ResultCache cache(diagnostics, cacheDirectory, "settings");
+    cache.setProgramFiles({ file("sum.c"), file("sum_test.c"), file("mul_test.c") });
+    cache.setTestFiles({ { "Sum.works", { file("sum.c"), file("sum_test.c") } },
+                         { "Mul.works", { file("mul_test.c") } } });
+    return cache;
+  }
+
+  Diagnostics diagnostics;
+  llvm::SmallString<128> root;
+  std::string cacheDirectory;
+};
+} // namespace
+
+TEST_F(ResultCacheTest, LoadsStoredResult) {
+  auto sum = mutant("cxx_add_to_sub:sum.c:1:34:1:35");
+  ExecutionResult result;
+  result.status = Failed;
+  result.exitStatus = 1;
+  result.runningTime = 12;
+  result.stdoutOutput = "sum(2, 3) != 5";
+
+  ASSERT_FALSE(cache().load(*sum).has_value());
+  cache().store(*sum, result);
+  auto loaded = cache().load(*sum);
+  ASSERT_TRUE(loaded.has_value());
+  ASSERT_EQ(loaded->status, Failed);
+  ASSERT_EQ(loaded->exitStatus, 1);
+  ASSERT_EQ(loaded->runningTime, 12);
+  ASSERT_EQ(loaded->stdoutOutput, "sum(2, 3) != 5");
+}
+
+TEST_F(ResultCacheTest, DoesNotStoreTimeouts) {
+  auto sum = mutant("cxx_add_to_sub:sum.c:1:34:1:35");
+  ExecutionResult result;
+  result.status = Timedout;
+  cache().store(*sum, result);
+  ASSERT_FALSE(cache().load(*sum).has_value());
+}
+
+TEST_F(ResultCacheTest, KeyChangesWithMutatedCode) {
+  auto sum = mutant("cxx_add_to_sub:sum.c:1:34:1:35");
+  std::string before = cache().key(*sum);
+  writeFile("sum.c", "int sum(int a, int b) { return b + a; }");
+  ASSERT_NE(before, cache().key(*sum));
+}
+
+TEST_F(ResultCacheTest, KeyDependsOnlyOnCoveringTests) {
+  auto sum = mutant("cxx_add_to_sub:sum.c:1:34:1:35");
+  sum->addCoveringTest("Sum.works", 10);
+  std::string before = cache().key(*sum);
+
+  writeFile("mul_test.c", "assert(mul(2, 3) == 6 && mul(0, 1) == 0);");
+  ASSERT_EQ(before, cache().key(*sum));
+
+  writeFile("sum_test.c", "assert(sum(2, 3) == 5 && sum(0, 0) == 0);");
+  ASSERT_NE(before, cache().key(*sum));
+}
+
+TEST_F(ResultCacheTest, KeyDependsOnWholeProgramWithoutCoveringTests) {
+  auto sum = mutant("cxx_add_to_sub:sum.c:1:34:1:35");
+  std::string before = cache().key(*sum);
+  writeFile("mul_test.c", "assert(mul(2, 3) == 6 && mul(0, 1) == 0);");
+  ASSERT_NE(before, cache().key(*sum));
+}
+
+TEST_F(ResultCacheTest, RunsOnlyUncachedMutants) {
+  std::vector<std::unique_ptr<Mutant>> mutants;
+  mutants.push_back(mutant("cxx_add_to_sub:sum.c:1:34:1:35"));
+  mutants.push_back(mutant("cxx_remove_void_call:sum.c:1:25:1:40"));
+  mutants.push_back(mutant("cxx_replace_scalar_call:sum.c:1:25:1:40"));
+  ExecutionResult killed;
+  killed.status = Failed;
+  cache().store(*mutants[1], killed);
+
+  std::vector<std::string> ran;
+  auto results = cache().run(mutants, [&](std::vector<std::unique_ptr<Mutant>> &uncached) {
+    std::vector<std::unique_ptr<MutationResult>> results;
+    for (auto &mutant : uncached) {
+      ran.push_back(mutant->getIdentifier());
+      ExecutionResult survived;
+      survived.status = Passed;
+      results.push_back(std::make_unique<MutationResult>(survived, mutant.get()));
+    }
+    return results;
+  });
+
+  ASSERT_EQ(ran,
+            std::vector<std::string>({ "cxx_add_to_sub:sum.c:1:34:1:35",
+                                       "cxx_replace_scalar_call:sum.c:1:25:1:40" }));
+  ASSERT_EQ(results.size(), 3U);
+  for (size_t i = 0; i < mutants.size(); i++) {
+    ASSERT_NE(mutants[i], nullptr);
+    ASSERT_EQ(results[i]->getMutant(), mutants[i].get());
+  }
+  ASSERT_EQ(results[0]->getExecutionResult().status, Passed);
+  ASSERT_EQ(results[1]->getExecutionResult().status, Failed);
+  ASSERT_EQ(results[2]->getExecutionResult().status, Passed);
+
+  /// Stored by the first run
+  ASSERT_EQ(cache().load(*mutants[0])->status, Passed);
+}
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/ExecutionResult.h"
+#include "mull/Sandbox.h"
+
+#include <csignal>
+
+using namespace mull;
+
+TEST(Sandbox, ExecutionStatusFromExitStatus) {
+  ASSERT_EQ(executionStatusFromExitStatus(0), Passed);
+  ASSERT_EQ(executionStatusFromExitStatus(1), Failed);
+  ASSERT_EQ(executionStatusFromExitStatus(255), Failed);
+  ASSERT_EQ(executionStatusFromExitStatus(SignalExitStatusOffset + SIGSEGV), Crashed);
+  ASSERT_EQ(executionStatusFromExitStatus(SignalExitStatusOffset + SIGABRT), Crashed);
+  ASSERT_EQ(executionStatusFromExitStatus(SignalExitStatusOffset + SIGXCPU), Timedout);
+  ASSERT_EQ(executionStatusFromExitStatus(SignalExitStatusOffset + SIGKILL), AbnormalExit);
+  ASSERT_EQ(executionStatusFromExitStatus(SignalExitStatusOffset + SIGXFSZ), AbnormalExit);
+}
+
+TEST(Sandbox, ReportsCrashes) {
+  Diagnostics diagnostics;
+  Sandbox sandbox(diagnostics);
+  SandboxLimits limits;
+  limits.wallTime = 5000;
+  ExecutionResult result = sandbox.run("sh", { "-c", "kill -SEGV $$" }, {}, limits, false, {});
+  ASSERT_EQ(result.status, Crashed);
+}
+
+TEST(Sandbox, KillsProgramOverCPUBudget) {
+  Diagnostics diagnostics;
+  Sandbox sandbox(diagnostics);
+  SandboxLimits limits;
+  limits.cpuTime = 100;
+  limits.wallTime = 10000;
+  ExecutionResult result =
+      sandbox.run("sh", { "-c", "while :; do :; done" }, {}, limits, false, {});
+  ASSERT_EQ(result.status, Timedout);
+  ASSERT_GE(result.cpuTime, 100);
+}
+
+TEST(Sandbox, PassesEnvironment) {
+  Diagnostics diagnostics;
+  Sandbox sandbox(diagnostics);
+  SandboxLimits limits;
+  limits.wallTime = 5000;
+  ExecutionResult result =
+      sandbox.run("sh", { "-c", "echo $MULL_SANDBOX_TEST" }, { { "MULL_SANDBOX_TEST", "42" } },
+                  limits, true, {});
+  ASSERT_EQ(result.status, Passed);
+  ASSERT_EQ(result.stdoutOutput, "42\n");
+}
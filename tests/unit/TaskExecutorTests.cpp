@@ -115,3 +115,48 @@ TEST(TaskExecutor, SequentialExecution_EmptyTask_MoreWorkers) {
 
   ASSERT_EQ(expected, out);
 }
+
+TEST(TaskExecutor, ParallelExecution_AddNumber_KeepsOrder) {
+  Diagnostics diagnostics;
+  int workers = 4;
+  std::vector<AddNumberTask> tasks;
+  for (int i = 0; i < workers; i++) {
+    tasks.emplace_back(AddNumberTask());
+  }
+
+  std::vector<int> in;
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; i++) {
+    in.push_back(i);
+    expected.push_back(i + 1);
+  }
+  std::vector<int> out;
+
+  TaskExecutor<AddNumberTask> executor(diagnostics, "increment numbers", in, out, std::move(tasks));
+  executor.execute();
+
+  ASSERT_EQ(expected, out);
+}
+
+TEST(WorkQueue, TakesEveryItemOnce) {
+  size_t items = 1000;
+  WorkQueue queue(items, 4);
+  std::vector<int> taken(items, 0);
+  size_t previousSize = items;
+  size_t begin = 0;
+  size_t end = 0;
+  size_t next = 0;
+  while (queue.take(begin, end)) {
+    ASSERT_EQ(next, begin);
+    ASSERT_LT(begin, end);
+    /// Ranges only get smaller towards the end of the input
+    ASSERT_LE(end - begin, previousSize);
+    previousSize = end - begin;
+    for (size_t i = begin; i < end; i++) {
+      taken[i]++;
+    }
+    next = end;
+  }
+  ASSERT_EQ(items, next);
+  ASSERT_EQ(std::vector<int>(items, 1), taken);
+}
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include "mull/TestFramework.h"
+
+#include <string>
+#include <vector>
+
+using namespace mull;
+
+TEST(TestFramework, GoogleTest_ParseTestList) {
+  TestFramework framework(TestFrameworkKind::GoogleTest);
+  std::string output = "Sum.\n"
+                       "  positive\n"
+                       "  DISABLED_negative\n"
+                       "Values/Param.  # TypeParam = int\n"
+                       "  check/0  # GetParam() = 1\n";
+  std::vector<std::string> expected({ "Sum.positive", "Values/Param.check/0" });
+  ASSERT_EQ(framework.parseTestList(output), expected);
+}
+
+TEST(TestFramework, GoogleTest_SelectTests) {
+  TestFramework framework(TestFrameworkKind::GoogleTest);
+  std::vector<std::string> expected({ "--gtest_filter=Sum.positive:Sum.zero" });
+  ASSERT_EQ(framework.selectTestsArguments({ "Sum.positive", "Sum.zero" }), expected);
+  ASSERT_TRUE(framework.selectTestsArguments({}).empty());
+}
+
+TEST(TestFramework, GoogleTest_TooManyTestsRunEverything) {
+  TestFramework framework(TestFrameworkKind::GoogleTest);
+  std::vector<std::string> tests(10000, "Suite.test");
+  ASSERT_TRUE(framework.selectTestsArguments(tests).empty());
+}
+
+TEST(TestFramework, Catch2_ParseAndSelectTests) {
+  TestFramework framework(TestFrameworkKind::Catch2);
+  std::vector<std::string> tests({ "sum works", "sum, [of] two" });
+  ASSERT_EQ(framework.parseTestList("sum works\nsum, [of] two\n"), tests);
+  std::vector<std::string> expected({ "sum works,sum\\, \\[of\\] two" });
+  ASSERT_EQ(framework.selectTestsArguments(tests), expected);
+}
+
+TEST(TestFramework, Doctest_ParseAndSelectTests) {
+  TestFramework framework(TestFrameworkKind::Doctest);
+  std::string output = "[doctest] doctest version is \"2.4.11\"\n"
+                       "[doctest] run with \"--help\" for options\n"
+                       "================================================\n"
+                       "[doctest] listing all test case names\n"
+                       "================================================\n"
+                       "sum\n"
+                       "sum, negative\n"
+                       "================================================\n"
+                       "[doctest] unskipped test cases passing the current filters: 2\n";
+  std::vector<std::string> tests({ "sum", "sum, negative" });
+  ASSERT_EQ(framework.parseTestList(output), tests);
+  std::vector<std::string> expected({ "--test-case=sum,sum\\, negative" });
+  ASSERT_EQ(framework.selectTestsArguments(tests), expected);
+}
+
+TEST(TestFramework, None_DoesNotSelectTests) {
+  TestFramework framework(TestFrameworkKind::None);
+  ASSERT_FALSE(framework.supportsTestSelection());
+  ASSERT_TRUE(framework.listTestsArguments().empty());
+  ASSERT_TRUE(framework.selectTestsArguments({ "test" }).empty());
+}
+
+TEST(TestFramework, FailFast) {
+  std::vector<std::string> gtest({ "--gtest_fail_fast" });
+  ASSERT_EQ(TestFramework(TestFrameworkKind::GoogleTest).failFastArguments(), gtest);
+  std::vector<std::string> catch2({ "--abort" });
+  ASSERT_EQ(TestFramework(TestFrameworkKind::Catch2).failFastArguments(), catch2);
+  std::vector<std::string> doctest({ "--abort-after=1" });
+  ASSERT_EQ(TestFramework(TestFrameworkKind::Doctest).failFastArguments(), doctest);
+  ASSERT_TRUE(TestFramework(TestFrameworkKind::None).failFastArguments().empty());
+  ASSERT_TRUE(TestFramework(TestFrameworkKind::None).failureMarkers().empty());
+}
@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+
+#include "mull/TrivialCompilerEquivalence.h"
+#include "tests/unit/Helpers/MutantFactory.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mull;
+using mull_test::mutant;
+
+static const char *Functions = R"(
+define i32 @original(i32 %x) {
+  %result = mul i32 %x, 1
+  ret i32 %result
+}
+
+define i32 @mul_to_div(i32 %x) {
+  %result = sdiv i32 %x, 1
+  ret i32 %result
+}
+
+define i32 @add_to_sub(i32 %x) {
+  %result = add i32 %x, 1
+  ret i32 %result
+}
+
+define i32 @sub_to_add(i32 %x) {
+  %result = sub i32 %x, 1
+  ret i32 %result
+}
+
+define i32 @add_negated(i32 %x) {
+  %result = add i32 %x, -1
+  ret i32 %result
+}
+
+@__mull_active_mutant = internal global i32 -1
+
+define i32 @schema(i32 %x) {
+entry:
+  %active = load i32, i32* @__mull_active_mutant
+  %mul_to_div = icmp eq i32 %active, 0
+  br i1 %mul_to_div, label %div, label %not_div
+div:
+  %divided = sdiv i32 %x, 1
+  br label %tail
+not_div:
+  %mul_to_add = icmp eq i32 %active, 1
+  br i1 %mul_to_add, label %add, label %mul
+add:
+  %added = add i32 %x, 1
+  br label %tail
+mul:
+  %multiplied = mul i32 %x, 1
+  br label %tail
+tail:
+  %result = phi i32 [ %divided, %div ], [ %added, %add ], [ %multiplied, %mul ]
+  ret i32 %result
+}
+)";
+
+namespace {
+class TrivialCompilerEquivalenceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    llvm::SMDiagnostic error;
+    module = llvm::parseAssemblyString(Functions, error, context);
+    ASSERT_NE(module, nullptr);
+  }
+
+  std::string hash(const std::string &name) {
+    return optimizedFunctionHash(*module->getFunction(name));
+  }
+
+  llvm::LLVMContext context;
+  std::unique_ptr<llvm::Module> module;
+};
+} // namespace
+
+TEST_F(TrivialCompilerEquivalenceTest, OptimizedCodeDecides) {
+  ASSERT_FALSE(hash("original").empty());
+  ASSERT_EQ(hash("original"), hash("mul_to_div"));
+  ASSERT_EQ(hash("sub_to_add"), hash("add_negated"));
+  ASSERT_NE(hash("original"), hash("add_to_sub"));
+  ASSERT_NE(hash("add_to_sub"), hash("sub_to_add"));
+}
+
+TEST_F(TrivialCompilerEquivalenceTest, SchemaMutantsAreHashedOneByOne) {
+  llvm::Function &schema = *module->getFunction("schema");
+  llvm::GlobalVariable &active = *module->getNamedGlobal("__mull_active_mutant");
+  ASSERT_EQ(optimizedFunctionHash(schema, active, 0), hash("original"));
+  ASSERT_EQ(optimizedFunctionHash(schema, active, 1), hash("add_to_sub"));
+  ASSERT_EQ(optimizedFunctionHash(schema, active, 2), hash("original"));
+}
+
+TEST(TrivialCompilerEquivalence, DecodesRecordedEquivalences) {
+  llvm::LLVMContext context;
+  llvm::Module module("equivalences", context);
+  recordEquivalences(module, { { "a:sum.c:1:1:1:2", "" }, { "b:sum.c:1:1:1:2", "c:sum.c:1:1:1:2" } });
+
+  Equivalences decoded;
+  for (auto &global : module.globals()) {
+    if (global.getSection() == EquivalencesSection) {
+      auto data = llvm::cast<llvm::ConstantDataArray>(global.getInitializer());
+      decodeEquivalence(data->getAsCString().str(), decoded);
+    }
+  }
+  ASSERT_EQ(decoded.size(), 2U);
+  ASSERT_EQ(decoded["a:sum.c:1:1:1:2"], "");
+  ASSERT_EQ(decoded["b:sum.c:1:1:1:2"], "c:sum.c:1:1:1:2");
+}
+
+TEST(TrivialCompilerEquivalence, RunsDistinctMutantsOnly) {
+  std::vector<std::unique_ptr<Mutant>> mutants;
+  mutants.push_back(mutant("equivalent"));
+  mutants.push_back(mutant("duplicate"));
+  mutants.push_back(mutant("representative"));
+  mutants.push_back(mutant("orphan"));
+  Equivalences equivalences = { { "equivalent", "" },
+                                { "duplicate", "representative" },
+                                /// The mutant it duplicates was filtered out
+                                { "orphan", "filtered" } };
+
+  std::vector<std::string> ran;
+  auto results = runDistinct(mutants, equivalences, [&](std::vector<std::unique_ptr<Mutant>> &run) {
+    std::vector<std::unique_ptr<MutationResult>> results;
+    for (auto &mutant : run) {
+      ran.push_back(mutant->getIdentifier());
+      ExecutionResult result;
+      result.status = mutant->getIdentifier() == "orphan" ? Passed : Failed;
+      results.push_back(std::make_unique<MutationResult>(result, mutant.get()));
+    }
+    return results;
+  });
+
+  ASSERT_EQ(ran, std::vector<std::string>({ "representative", "orphan" }));
+  ASSERT_EQ(results.size(), 4U);
+  for (size_t i = 0; i < mutants.size(); i++) {
+    ASSERT_NE(mutants[i], nullptr);
+    ASSERT_EQ(results[i]->getMutant(), mutants[i].get());
+  }
+  ASSERT_EQ(results[0]->getExecutionResult().status, Equivalent);
+  ASSERT_EQ(results[1]->getExecutionResult().status, Failed);
+  ASSERT_EQ(results[2]->getExecutionResult().status, Failed);
+  ASSERT_EQ(results[3]->getExecutionResult().status, Passed);
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/WeakMutation.h"
+#include "tests/unit/Helpers/MutantFactory.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mull;
+using mull_test::mutant;
+
+static const char *Function = R"(
+define i32 @sum(i32 %a, i32 %b) {
+  %result = add nsw i32 %a, %b
+  ret i32 %result
+}
+)";
+
+TEST(WeakMutation, ProbesCompareWithTheOriginalValue) {
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic error;
+  auto module = llvm::parseAssemblyString(Function, error, context);
+  ASSERT_NE(module, nullptr);
+  runtime::insertMutantActivation(*module, { "add_to_sub", "filtered" });
+
+  llvm::Instruction *original = &module->getFunction("sum")->getEntryBlock().front();
+  auto *sub = llvm::BinaryOperator::CreateSub(original->getOperand(0), original->getOperand(1));
+  runtime::insertWeakMutationProbes(*module, { { original, sub, "add_to_sub" } });
+
+  ASSERT_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+  ASSERT_EQ(sub->getParent(), original->getParent());
+  ASSERT_EQ(original->getNextNode(), sub);
+  auto *comparison = llvm::dyn_cast<llvm::ICmpInst>(sub->getNextNode());
+  ASSERT_NE(comparison, nullptr);
+  ASSERT_EQ(comparison->getPredicate(), llvm::CmpInst::ICMP_NE);
+  ASSERT_EQ(comparison->getOperand(0), original);
+  ASSERT_EQ(comparison->getOperand(1), sub);
+}
+
+TEST(WeakMutation, ReadsReport) {
+  llvm::SmallString<128> path;
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("mull", "weak-mutation", fd, path));
+  {
+    llvm::raw_fd_ostream stream(fd, true);
+    /// Two processes: each appends what it saw
+    stream << "+infected\n-never\n-infected\n-never\n";
+  }
+  Diagnostics diagnostics;
+  WeakMutationReport report = readWeakMutationReport(diagnostics, path.str().str());
+  llvm::sys::fs::remove(path);
+
+  ASSERT_TRUE(report.notInfected("never"));
+  ASSERT_FALSE(report.notInfected("infected"));
+  /// Never evaluated: nothing is known about it
+  ASSERT_FALSE(report.notInfected("unknown"));
+}
+
+TEST(WeakMutation, RunsInfectedMutantsOnly) {
+  std::vector<std::unique_ptr<Mutant>> mutants;
+  mutants.push_back(mutant("infected"));
+  mutants.push_back(mutant("never"));
+  mutants.push_back(mutant("unknown"));
+  WeakMutationReport report;
+  report.evaluated = { "infected", "never" };
+  report.infected = { "infected" };
+
+  std::vector<std::string> ran;
+  auto results = runInfected(mutants, report, [&](std::vector<std::unique_ptr<Mutant>> &run) {
+    std::vector<std::unique_ptr<MutationResult>> results;
+    for (auto &mutant : run) {
+      ran.push_back(mutant->getIdentifier());
+      ExecutionResult result;
+      result.status = Failed;
+      results.push_back(std::make_unique<MutationResult>(result, mutant.get()));
+    }
+    return results;
+  });
+
+  ASSERT_EQ(ran, std::vector<std::string>({ "infected", "unknown" }));
+  ASSERT_EQ(results.size(), 3U);
+  ASSERT_EQ(results[0]->getExecutionResult().status, Failed);
+  ASSERT_EQ(results[1]->getExecutionResult().status, Passed);
+  ASSERT_EQ(results[1]->getMutant(), mutants[1].get());
+  ASSERT_EQ(results[2]->getExecutionResult().status, Failed);
+}
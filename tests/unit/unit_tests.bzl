@@ -73,6 +73,10 @@ def mull_unit_tests(name):
             deps = ["//:libmull_%s" % llvm_version],
         )
 
+        native.filegroup(
+            name = "MutationFilters/CoverageFilterTests.cpp_%s_fixtures" % llvm_version,
+        )
+
         native.filegroup(
             name = "MutationFilters/GitDiffReaderTests.cpp_%s_fixtures" % llvm_version,
         )
@@ -113,6 +117,46 @@ def mull_unit_tests(name):
             name = "TaskExecutorTests.cpp_%s_fixtures" % llvm_version,
         )
 
+        native.filegroup(
+            name = "SandboxTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "FailureMarkersTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "DistributedProtocolTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "ResultCacheTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "OutputCaptureTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "MutantPrioritizerTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "TrivialCompilerEquivalenceTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "MutantManifestTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "WeakMutationTests.cpp_%s_fixtures" % llvm_version,
+        )
+
+        native.filegroup(
+            name = "TestFrameworkTests.cpp_%s_fixtures" % llvm_version,
+        )
+
         native.filegroup(
             name = "MutationPointTests.cpp_%s_fixtures" % llvm_version,
             srcs = [
@@ -47,8 +47,12 @@ std::vector<std::unique_ptr<Reporter>> ReportersCLIOptions::reporters(ReporterPa
           new mull::IDEReporter(diagnostics, params.IDEReporterShowKilled, directory, name));
     } break;
     case ReporterKind::SQLite: {
-      reporters.emplace_back(
-          new mull::SQLiteReporter(diagnostics, directory, name, params.mullInformation));
+      auto reporter =
+          new mull::SQLiteReporter(diagnostics, directory, name, params.mullInformation);
+      if (!params.resumedReport.empty()) {
+        reporter->continueReport(params.resumedReport);
+      }
+      reporters.emplace_back(reporter);
     } break;
     case ReporterKind::Patches: {
       reporters.emplace_back(new mull::PatchesReporter(
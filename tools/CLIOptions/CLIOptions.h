@@ -30,6 +30,18 @@ opt<std::string> TestProgram( \
     value_desc("path"), \
     cat(MullCategory))
 
+#define TestFrameworkOption_() \
+opt<TestFrameworkKind> TestFrameworkOption( \
+    "test-framework", \
+    desc("Test framework of the test program, enables running only the tests covering a mutant"), \
+    Optional, \
+    values( \
+      clEnumValN(TestFrameworkKind::GoogleTest, "gtest", "GoogleTest"), \
+      clEnumValN(TestFrameworkKind::Catch2, "catch2", "Catch2"), \
+      clEnumValN(TestFrameworkKind::Doctest, "doctest", "doctest")), \
+    value_desc("framework"), \
+    cat(MullCategory))
+
 #define SQLiteReport_() \
 opt<std::string> SQLiteReport( \
     Positional, \
@@ -181,6 +193,78 @@ opt<bool> NoMutantOutput( \
     init(false), \
     cat(MullCategory)) \
 
+#define ForkServer_() \
+opt<bool> ForkServer( \
+    "fork-server", \
+    desc("Runs mutants as forks of a single test program instance. Requires a program built with forkServer: true"), \
+    Optional, \
+    init(false), \
+    cat(MullCategory)) \
+
+#define SplitStream_() \
+opt<bool> SplitStream( \
+    "split-stream", \
+    desc("Forks mutants from the unmutated test program when their function is first called. Requires a program built with splitStream: true"), \
+    Optional, \
+    init(false), \
+    cat(MullCategory)) \
+
+#define FailFast_() \
+opt<bool> FailFast( \
+    "fail-fast", \
+    desc("Stops a mutant run on the first failing test (requires -test-framework or failFastMarkers)"), \
+    Optional, \
+    init(false), \
+    cat(MullCategory)) \
+
+#define PreviousReport_() \
+list<std::string> PreviousReport( \
+    "previous-report", \
+    desc("SQLite report of a previous run, mutants that took longest there are run first (can be repeated)"), \
+    ZeroOrMore, \
+    value_desc("path"), \
+    cat(MullCategory)) \
+
+#define PrioritizeSurvivors_() \
+opt<bool> PrioritizeSurvivors( \
+    "prioritize-survivors", \
+    desc("Runs first the mutants that survived, or whose mutators' mutants mostly survived, in the previous reports"), \
+    Optional, \
+    init(false), \
+    cat(MullCategory)) \
+
+#define Resume_() \
+opt<std::string> Resume( \
+    "resume", \
+    desc("SQLite report of an interrupted run, mutants that already have results there are not run again"), \
+    Optional, \
+    value_desc("path"), \
+    cat(MullCategory)) \
+
+#define ResultCache_() \
+opt<std::string> ResultCache( \
+    "result-cache", \
+    desc("Reuses results of previous runs for mutants whose code and tests did not change (overrides resultCache)"), \
+    Optional, \
+    value_desc("directory"), \
+    cat(MullCategory)) \
+
+#define CoordinatorAddress_() \
+opt<std::string> CoordinatorAddress( \
+    "coordinator", \
+    desc("Listens on <host>:<port> (loopback if <host> is omitted) or unix:<path> and hands out mutants to workers (see -worker) instead of running them"), \
+    Optional, \
+    value_desc("address"), \
+    cat(MullCategory)) \
+
+#define WorkerAddress_() \
+opt<std::string> WorkerAddress( \
+    "worker", \
+    desc("Runs mutants handed out by the coordinator at <host>:<port> or unix:<path>"), \
+    Optional, \
+    value_desc("address"), \
+    cat(MullCategory)) \
+
 #define NoOutput_() \
 opt<bool> NoOutput( \
     "no-output", \
@@ -232,6 +316,8 @@ struct ReporterParameters {
   bool compilationDatabaseAvailable;
   bool IDEReporterShowKilled;
   std::unordered_map<std::string, std::string> mullInformation;
+  /// SQLite report continued by the SQLite reporter instead of creating a new one
+  std::string resumedReport;
 };
 
 class ReportersCLIOptions {
@@ -1,11 +1,11 @@
 #include "ASTInstrumentation.h"
+#include "ASTMutationPoint.h"
 #include "ASTNodeFactory.h"
 
 #include <clang/AST/AST.h>
+#include <clang/AST/ASTConsumer.h>
 #include <clang/Sema/Sema.h>
 
-#include <sstream>
-
 namespace mull {
 namespace cxx {
 
@@ -23,16 +23,23 @@ void ASTInstrumentation::instrumentTranslationUnit() {
   context.getTranslationUnitDecl()->addDecl(cLinkageSpecDecl);
 }
 
-void ASTInstrumentation::addMutantStringDefinition(std::string identifier, int mutator, int line,
-                                                   int column) {
-  std::ostringstream mis;
-
-  mis << "mull_mutation_" << mutator << "_" << line << "_" << column;
-  std::string variableName = mis.str();
+void ASTInstrumentation::addMutant(const ASTMutationPoint &mutation) {
+  manifest.add(mutation.mutatorIdentifier,
+               mutation.sourceFilePath,
+               mutation.beginLine,
+               mutation.beginColumn,
+               mutation.endLine,
+               mutation.endColumn);
+}
 
-  clang::IdentifierInfo &varDeclIdentifierInfo = context.Idents.get(variableName);
+void ASTInstrumentation::addMutantManifestDefinition(clang::ASTConsumer &consumer) {
+  if (manifest.empty()) {
+    return;
+  }
+  std::string encoding = manifest.encode();
+  clang::IdentifierInfo &varDeclIdentifierInfo = context.Idents.get("mull_mutant_manifest");
 
-  clang::StringLiteral *literal = factory.createStringLiteral(identifier);
+  clang::StringLiteral *literal = factory.createStringLiteral(encoding);
 #if LLVM_VERSION_MAJOR >= 13
   literal->setValueKind(clang::VK_PRValue);
 #else
@@ -40,8 +47,9 @@ void ASTInstrumentation::addMutantStringDefinition(std::string identifier, int m
 #endif
 
   clang::QualType qualType =
-      factory.getStringLiteralArrayType(context.getConstType(context.CharTy), identifier.size());
+      factory.getStringLiteralArrayType(context.getConstType(context.CharTy), encoding.size());
 
+  /// One per translation unit: internal, kept alive by the used attribute
   clang::VarDecl *varDecl = clang::VarDecl::Create(context,
                                                    context.getTranslationUnitDecl(),
                                                    NULL_LOCATION,
@@ -49,38 +57,18 @@ void ASTInstrumentation::addMutantStringDefinition(std::string identifier, int m
                                                    &varDeclIdentifierInfo,
                                                    qualType,
                                                    context.getTrivialTypeSourceInfo(qualType),
-                                                   clang::StorageClass::SC_Extern);
+                                                   clang::StorageClass::SC_Static);
   varDecl->setInit(literal);
-
-#if defined __APPLE__
-  const char *mullSection = "__mull,.mull_mutants";
-#else
-  const char *mullSection = ".mull_mutants";
-#endif
-
-  clang::SectionAttr *mullSectionAttr = factory.createSectionAttr(mullSection);
-  varDecl->addAttr(mullSectionAttr);
+  varDecl->addAttr(factory.createSectionAttr(mull::MutantsSection));
+  varDecl->addAttr(clang::UsedAttr::CreateImplicit(context));
   context.getTranslationUnitDecl()->addDecl(varDecl);
 
   assert(varDecl->isThisDeclarationADefinition() == clang::VarDecl::Definition);
 
-  /// This is the most sensitive line of the whole Clang AST-related
-  /// instrumentation and mutation done by Mull. Currently it seems to be the
-  /// only way to add a new function declaration to an existing Clang AST.
-  /// See clang::ParseAST() function with the following line:
-  /// """
-  ///   // Process any TopLevelDecls generated by #pragma weak.
-  ///   for (Decl *D : S.WeakTopLevelDecls())
-  ///     Consumer->HandleTopLevelDecl(DeclGroupRef(D));
-  ///
-  ///   Consumer->HandleTranslationUnit(S.getASTContext());
-  /// """
-  /// When a declaration is added to the weak top-level decls, the call
-  /// HandleTopLevelDecl() with one of the codegen hooks, generates the
-  /// actual definitions. Without this workaround, only a declaration of a new
-  /// function will appear in the generated LLVM IR.
-  /// TODO: Is it the only place to make the codegen generate the function definition?
-  sema.WeakTopLevelDecls().push_back(varDecl);
+  /// The whole translation unit has been parsed at this point, WeakTopLevelDecls (see
+  /// MullClangPlugin.cpp) are already handed out: the declaration goes straight to the consumers,
+  /// the code generator among them.
+  consumer.HandleTopLevelDecl(clang::DeclGroupRef(varDecl));
 }
 
 clang::FunctionDecl *ASTInstrumentation::getGetenvFuncDecl() {
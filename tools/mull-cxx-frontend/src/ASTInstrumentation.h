@@ -1,8 +1,11 @@
 #pragma once
 
+#include "mull/MutantManifest.h"
+
 #include <string>
 
 namespace clang {
+class ASTConsumer;
 class ASTContext;
 class DeclContext;
 class FunctionDecl;
@@ -12,6 +15,7 @@ class Sema;
 namespace mull {
 namespace cxx {
 
+class ASTMutationPoint;
 class ASTNodeFactory;
 
 class ASTInstrumentation {
@@ -19,13 +23,16 @@ class ASTInstrumentation {
   clang::Sema &sema;
   ASTNodeFactory &factory;
   clang::FunctionDecl *getenvFuncDecl;
+  MutantManifestWriter manifest;
 
 public:
   ASTInstrumentation(clang::ASTContext &context, clang::Sema &sema, ASTNodeFactory &factory)
       : context(context), sema(sema), factory(factory), getenvFuncDecl(nullptr) {}
   void instrumentTranslationUnit();
   clang::FunctionDecl *getGetenvFuncDecl();
-  void addMutantStringDefinition(std::string identifier, int mutator, int line, int column);
+  void addMutant(const ASTMutationPoint &mutation);
+  /// Emits the manifest of the mutants added so far
+  void addMutantManifestDefinition(clang::ASTConsumer &consumer);
 
 private:
   clang::FunctionDecl *createGetEnvFuncDecl(clang::DeclContext *declContext);
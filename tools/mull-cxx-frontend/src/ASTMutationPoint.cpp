@@ -11,19 +11,12 @@ ASTMutationPoint::ASTMutationPoint(std::unique_ptr<ASTMutation> mutation,
                                    int beginLine, int beginColumn, int endLine, int endColumn)
     : mutation(std::move(mutation)), mutationType(mutationType), mutableStmt(toBeMutatedStmt),
       sourceFilePath(sourceFilePath), beginLine(beginLine), beginColumn(beginColumn),
-      endLine(endLine), endColumn(endColumn) {
+      endLine(endLine), endColumn(endColumn), mutatorIdentifier(mutationIdentifier) {
   std::ostringstream mis;
   /// mutator:file:line:col:1
   mis << mutationIdentifier << ":" << sourceFilePath << ":" << beginLine << ":" << beginColumn
       << ":" << endLine << ":" << endColumn;
   this->mutationIdentifier = mis.str();
-
-  std::ostringstream mbis;
-
-  /// mutator:file:begin_line:begin_col:end_line:end_col
-  mbis << mutationIdentifier << ":" << sourceFilePath << ":" << beginLine << ":" << beginColumn
-       << ":" << endLine << ":" << endColumn;
-  this->mutationBinaryRecord = mbis.str();
 }
 
 void ASTMutationPoint::performMutation(ASTMutator &mutator) {
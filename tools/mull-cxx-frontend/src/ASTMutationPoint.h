@@ -22,7 +22,7 @@ public:
   int endLine;
   int endColumn;
   std::string mutationIdentifier;
-  std::string mutationBinaryRecord;
+  std::string mutatorIdentifier;
   ASTMutationPoint(std::unique_ptr<ASTMutation> mutation, mull::MutatorKind mutationType,
                    std::string mutationIdentifier, clang::Stmt *toBeMutatedStmt,
                    std::string sourceFilePath, int beginLine, int beginColumn, int endLine,
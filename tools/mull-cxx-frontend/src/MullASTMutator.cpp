@@ -13,6 +13,10 @@ void MullASTMutator::instrumentTranslationUnit() {
   instrumentation.instrumentTranslationUnit();
 }
 
+void MullASTMutator::finalizeTranslationUnit(clang::ASTConsumer &consumer) {
+  instrumentation.addMutantManifestDefinition(consumer);
+}
+
 void MullASTMutator::performUnaryOperatorOpcodeMutation(
     ASTMutationPoint &mutation, UnaryOperatorOpcodeMutation &unaryOperatorOpcodeMutator) {
   clang::UnaryOperator *oldUnaryOperator =
@@ -25,10 +29,7 @@ void MullASTMutator::performUnaryOperatorOpcodeMutation(
 
   clangAstMutator.replaceExpression(
       oldUnaryOperator, newUnaryOperator, mutation.mutationIdentifier);
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performUnaryOperatorRemovalMutation(
@@ -38,10 +39,7 @@ void MullASTMutator::performUnaryOperatorRemovalMutation(
                                     unaryNotToNoopMutator.unaryOperator->getSubExpr(),
                                     mutation.mutationIdentifier);
 
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performBinaryMutation(ASTMutationPoint &mutation,
@@ -71,10 +69,7 @@ void MullASTMutator::performBinaryMutation(ASTMutationPoint &mutation,
 
   clangAstMutator.replaceExpression(
       oldBinaryOperator, newBinaryOperator, mutation.mutationIdentifier);
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performRemoveVoidMutation(ASTMutationPoint &mutation,
@@ -82,10 +77,7 @@ void MullASTMutator::performRemoveVoidMutation(ASTMutationPoint &mutation,
   clang::CallExpr *callExpr = clang::dyn_cast<clang::CallExpr>(mutation.mutableStmt);
   clangAstMutator.replaceStatement(callExpr, nullptr, mutation.mutationIdentifier);
 
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performReplaceScalarMutation(
@@ -104,10 +96,7 @@ void MullASTMutator::performReplaceScalarMutation(
   }
 
   clangAstMutator.replaceExpression(callExpr, replacementLiteral, mutation.mutationIdentifier);
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performReplaceNumericAssignmentMutation(
@@ -130,10 +119,7 @@ void MullASTMutator::performReplaceNumericAssignmentMutation(
       replaceNumericAssignmentMutator.assignmentBinaryOperator->getRHS(),
       replacementLiteral,
       mutation.mutationIdentifier);
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 void MullASTMutator::performReplaceNumericInitAssignmentMutation(
@@ -156,10 +142,7 @@ void MullASTMutator::performReplaceNumericInitAssignmentMutation(
 
   clangAstMutator.replaceExpression(
       oldAssignedExpr, replacementLiteral, mutation.mutationIdentifier);
-  instrumentation.addMutantStringDefinition(mutation.mutationBinaryRecord,
-                                            static_cast<int>(mutation.mutationType),
-                                            mutation.beginLine,
-                                            mutation.beginColumn);
+  instrumentation.addMutant(mutation);
 }
 
 [[noreturn]] void MullASTMutator::notImplemented() noexcept {
@@ -7,6 +7,7 @@
 #include "ClangASTMutator.h"
 
 namespace clang {
+class ASTConsumer;
 class ASTContext;
 class FunctionDecl;
 } // namespace clang
@@ -21,6 +22,8 @@ public:
         clangAstMutator(context, factory, instrumentation) {}
 
   void instrumentTranslationUnit();
+  /// Once every function is mutated
+  void finalizeTranslationUnit(clang::ASTConsumer &consumer);
   void performBinaryMutation(ASTMutationPoint &mutation, BinaryMutation &binaryMutator) override;
   void performRemoveVoidMutation(ASTMutationPoint &mutation,
                                  RemoveVoidMutation &removeVoidMutator) override;
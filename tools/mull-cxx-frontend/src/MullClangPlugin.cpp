@@ -84,6 +84,10 @@ public:
   // been called on with HandleTopLevelDecl(). At this point, it is possible to
   // visualize the final mutated AST tree.
   void HandleTranslationUnit(ASTContext &context) override {
+    if (astMutator) {
+      /// Runs before the code generator's HandleTranslationUnit: the manifest is still emitted
+      astMutator->finalizeTranslationUnit(instance.getASTConsumer());
+    }
     // The following is useful for debugging mutations:
     // context.getTranslationUnitDecl()->print(llvm::errs(), 2);
     // context.getTranslationUnitDecl()->dump();
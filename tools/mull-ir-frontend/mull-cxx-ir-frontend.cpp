@@ -1,19 +1,69 @@
+#include <clang/AST/ASTConsumer.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendPluginRegistry.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Passes/PassPlugin.h>
 #include <llvm/Support/raw_ostream.h>
 #include <mull/Driver.h>
+#include <mull/JunkDetection/CXX/MutationSites.h>
 
 namespace {
 
+/// Sites of the translation unit being compiled, from the plugin action to the pass: with both
+/// -fplugin and -fpass-plugin, the compiler loads this library once and runs them one after the
+/// other on each translation unit
+std::string mutationSites;
+bool mutationSitesRecorded = false;
+
 class MullIRFrontend : public llvm::PassInfoMixin<MullIRFrontend> {
 public:
   llvm::PreservedAnalyses run(llvm::Module &module, llvm::ModuleAnalysisManager &mam) {
+    if (mutationSitesRecorded) {
+      mull::recordMutationSites(module, mutationSites);
+      mutationSites.clear();
+      mutationSitesRecorded = false;
+    }
     mull::mutateBitcode(module);
+    /// Only of use to junk detection, kept out of the compiler's output
+    if (llvm::NamedMDNode *sites = module.getNamedMetadata(mull::MutationSitesMetadata)) {
+      module.eraseNamedMetadata(sites);
+    }
     return llvm::PreservedAnalyses::none();
   }
 };
 
+class MutationSitesConsumer : public clang::ASTConsumer {
+public:
+  void HandleTranslationUnit(clang::ASTContext &context) override {
+    mutationSites = mull::encodeMutationSites(context);
+    mutationSitesRecorded = true;
+  }
+};
+
+/// Loaded with -fplugin, records the mutation sites while the compiler has the AST at hand, so
+/// that junk detection does not parse the sources again
+class MutationSitesAction : public clang::PluginASTAction {
+protected:
+  std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance &instance,
+                                                        llvm::StringRef file) override {
+    return std::make_unique<MutationSitesConsumer>();
+  }
+
+  bool ParseArgs(const clang::CompilerInstance &instance,
+                 const std::vector<std::string> &args) override {
+    return true;
+  }
+
+  ActionType getActionType() override {
+    /// Runs before the code generator, which runs the passes
+    return AddBeforeMainAction;
+  }
+};
+
+clang::FrontendPluginRegistry::Add<MutationSitesAction>
+    mutationSitesAction("mull-mutation-sites", "Mull: record mutation sites");
+
 extern "C" __attribute__((visibility("default"))) LLVM_ATTRIBUTE_WEAK ::llvm::PassPluginLibraryInfo
 llvmGetPassPluginInfo() {
 #if LLVM_VERSION_MAJOR > 13
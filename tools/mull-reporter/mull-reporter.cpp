@@ -84,6 +84,7 @@ chooseExecutionResult(const std::vector<mull::ExecutionResult> &results) {
   SELECT_MATCHING_STATUS(FailFast);
   SELECT_MATCHING_STATUS(NotCovered);
   SELECT_MATCHING_STATUS(DryRun);
+  SELECT_MATCHING_STATUS(Equivalent);
   SELECT_MATCHING_STATUS(Passed);
 
   return results[0];
@@ -159,7 +160,8 @@ int main(int argc, char **argv) {
                                    // we should not need the database at this point
                                    .compilationDatabaseAvailable = true,
                                    .IDEReporterShowKilled = tool::IDEReporterShowKilled,
-                                   .mullInformation = raw.info };
+                                   .mullInformation = raw.info,
+                                   .resumedReport = {} };
 
   std::vector<std::unique_ptr<mull::Reporter>> reporters = reportersOption.reporters(params);
 
@@ -170,21 +172,7 @@ int main(int argc, char **argv) {
       });
 
   // Calculate mutation score for later threshold comparison
-  int killedMutantsCount = 0;
-  int totalMutantsCount = 0;
-
-  for (auto &mutationResult : mutationResults) {
-    auto &executionResult = mutationResult->getExecutionResult();
-
-    totalMutantsCount++;
-    if ((executionResult.status != mull::ExecutionStatus::NotCovered) &&
-        (executionResult.status != mull::ExecutionStatus::Passed)) {
-      killedMutantsCount++;
-    }
-  }
-
-  auto rawScore = double(killedMutantsCount) / double(totalMutantsCount);
-  auto score = int(rawScore * 100);
+  int score = mull::mutationScore(mutationResults);
 
   auto result = std::make_unique<mull::Result>(std::move(mutants), std::move(mutationResults));
   for (auto &reporter : reporters) {
@@ -1,6 +1,7 @@
 #include "DynamicLibraries.h"
 #include "ObjectFile.h"
 #include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Runtime/Runtime.h"
 
 #include <llvm/Object/ELFObjectFile.h>
 #include <llvm/Object/ELFTypes.h>
@@ -173,3 +174,25 @@ bool mull::hasCoverage(mull::Diagnostics &diagnostics, const std::string &path)
 
   return false;
 }
+
+bool mull::hasRuntimeFeature(mull::Diagnostics &diagnostics, const std::string &path,
+                             const std::string &feature) {
+  auto [buffer, objectFile] = loadObjectFile(diagnostics, path);
+  if (!objectFile) {
+    return false;
+  }
+
+  for (auto &section : objectFile->sections()) {
+    if (getSectionName(section) != runtime::RuntimeSectionName) {
+      continue;
+    }
+    /// The section holds null-terminated feature names
+    llvm::SmallVector<llvm::StringRef> features;
+    getSectionContent(section).split(features, '\0', -1, false);
+    if (llvm::is_contained(features, feature)) {
+      return true;
+    }
+  }
+
+  return false;
+}
@@ -15,5 +15,7 @@ std::vector<std::string> getDynamicLibraryDependencies(mull::Diagnostics &diagno
                                                        const std::string &executablePath);
 
 bool hasCoverage(mull::Diagnostics &diagnostics, const std::string &path);
+bool hasRuntimeFeature(mull::Diagnostics &diagnostics, const std::string &path,
+                       const std::string &feature);
 
 } // namespace mull
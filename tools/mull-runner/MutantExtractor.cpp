@@ -1,6 +1,9 @@
 #include "MutantExtractor.h"
 #include "ObjectFile.h"
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/StringMap.h>
 #include <llvm/Object/ObjectFile.h>
+#include <mull/MutantManifest.h>
 #include <sstream>
 #include <unordered_set>
 
@@ -29,58 +32,100 @@ static std::vector<std::string> split(const std::string &input, char delimiter)
 
 MutantExtractor::MutantExtractor(Diagnostics &diagnostics) : diagnostics(diagnostics) {}
 
-std::vector<std::string> MutantExtractor::extractMutants(const std::string &executable) {
+void MutantExtractor::readSection(const std::string &executable, llvm::StringRef sectionName,
+                                  llvm::function_ref<void(llvm::StringRef)> read) {
   auto [buffer, objectFile] = loadObjectFile(diagnostics, executable);
   if (!objectFile) {
     diagnostics.warning("Skipping: "s + executable);
-    return {};
+    return;
   }
   for (auto &section : objectFile->sections()) {
     llvm::StringRef name = getSectionName(section);
-    if (name == ".mull_mutants") {
+    if (name == sectionName) {
       llvm::Expected<llvm::StringRef> content = section.getContents();
       if (!content) {
-        return {};
+        llvm::consumeError(content.takeError());
+        return;
       }
-      return split(content.get().str(), '\0');
+      read(content.get());
+      return;
     }
   }
-
-  return {};
 }
 
-std::vector<std::unique_ptr<Mutant>>
-MutantExtractor::extractMutants(const std::vector<std::string> &mutantHolders) {
-  std::vector<std::string> encodings;
-  for (auto &holder : mutantHolders) {
-    auto mutants = extractMutants(holder);
-    std::move(std::begin(mutants), std::end(mutants), std::back_inserter(encodings));
+namespace {
+/// A mutant as found in the manifests, with its strings interned
+struct MutantKey {
+  uint32_t mutator;
+  uint32_t file;
+  uint32_t beginLine;
+  uint32_t beginColumn;
+  uint32_t endLine;
+  uint32_t endColumn;
+
+  bool operator==(const MutantKey &other) const {
+    return mutator == other.mutator && file == other.file && beginLine == other.beginLine &&
+           beginColumn == other.beginColumn && endLine == other.endLine &&
+           endColumn == other.endColumn;
   }
+};
 
-  std::unordered_set<std::string> deduplicatedEncodings;
-  for (auto &encoding : encodings) {
-    deduplicatedEncodings.insert(encoding);
+struct MutantKeyHash {
+  size_t operator()(const MutantKey &key) const {
+    return llvm::hash_combine(key.mutator,
+                              key.file,
+                              key.beginLine,
+                              key.beginColumn,
+                              key.endLine,
+                              key.endColumn);
   }
-  std::vector<std::unique_ptr<Mutant>> mutants;
-  for (auto &encoding : deduplicatedEncodings) {
-    std::vector<std::string> chunks = split(encoding, ':');
+};
+} // namespace
 
-    std::string mutator = chunks[0];
-    std::string location = chunks[1];
-    int beginLine = std::stoi(chunks[2]);
-    int beginColumn = std::stoi(chunks[3]);
-    int endLine = std::stoi(chunks[4]);
-    int endColumn = std::stoi(chunks[5]);
+std::vector<std::unique_ptr<Mutant>>
+MutantExtractor::extractMutants(const std::vector<std::string> &mutantHolders) {
+  /// The same mutant shows up once per translation unit including it, e.g. from a header
+  llvm::StringMap<uint32_t> strings;
+  auto intern = [&](llvm::StringRef string) {
+    return strings.try_emplace(string, strings.size()).first->second;
+  };
+  std::unordered_set<MutantKey, MutantKeyHash> seen;
+  std::vector<std::unique_ptr<Mutant>> mutants;
 
-    auto mutant = std::make_unique<Mutant>(
-        encoding,
-        mutator,
-        mull::SourceLocation("", location, "", location, beginLine, beginColumn),
-        mull::SourceLocation("", location, "", location, endLine, endColumn));
-    mutants.push_back(std::move(mutant));
+  for (auto &holder : mutantHolders) {
+    readSection(holder, MutantsSectionName, [&](llvm::StringRef section) {
+      bool complete = readMutantManifests(section, [&](const ManifestMutant &mutant) {
+        MutantKey key{ intern(mutant.mutator), intern(mutant.file), mutant.beginLine,
+                       mutant.beginColumn,     mutant.endLine,      mutant.endColumn };
+        if (!seen.insert(key).second) {
+          return;
+        }
+        std::string file = mutant.file.str();
+        mutants.push_back(std::make_unique<Mutant>(
+            mutantIdentifier(mutant),
+            mutant.mutator.str(),
+            mull::SourceLocation("", file, "", file, mutant.beginLine, mutant.beginColumn),
+            mull::SourceLocation("", file, "", file, mutant.endLine, mutant.endColumn)));
+      });
+      if (!complete) {
+        diagnostics.warning("Some mutants of "s + holder + " cannot be read");
+      }
+    });
   }
 
   std::sort(std::begin(mutants), std::end(mutants), MutantComparator());
 
   return mutants;
 }
+
+Equivalences MutantExtractor::extractEquivalences(const std::vector<std::string> &mutantHolders) {
+  Equivalences equivalences;
+  for (auto &holder : mutantHolders) {
+    readSection(holder, EquivalencesSectionName, [&](llvm::StringRef section) {
+      for (auto &entry : split(section.str(), '\0')) {
+        decodeEquivalence(entry, equivalences);
+      }
+    });
+  }
+  return equivalences;
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringRef.h>
 #include <memory>
 #include <mull/Diagnostics/Diagnostics.h>
 #include <mull/Mutant.h>
+#include <mull/TrivialCompilerEquivalence.h>
 #include <vector>
 
 namespace mull {
@@ -12,9 +15,12 @@ public:
   explicit MutantExtractor(Diagnostics &diagnostics);
   std::vector<std::unique_ptr<Mutant>>
   extractMutants(const std::vector<std::string> &mutantHolders);
+  Equivalences extractEquivalences(const std::vector<std::string> &mutantHolders);
 
 private:
-  std::vector<std::string> extractMutants(const std::string &executable);
+  /// `read` gets the section's contents straight from the mapped file
+  void readSection(const std::string &executable, llvm::StringRef sectionName,
+                   llvm::function_ref<void(llvm::StringRef)> read);
   Diagnostics &diagnostics;
 };
 
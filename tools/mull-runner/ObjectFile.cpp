@@ -74,7 +74,8 @@ getObjectFile(mull::Diagnostics &diagnostics, const std::string &executablePath,
 
 mull::OwnedObjectFile mull::loadObjectFile(mull::Diagnostics &diagnostics,
                                            const std::string &executablePath) {
-  auto bufferOr = llvm::MemoryBuffer::getFile(executablePath);
+  /// Without a NUL terminator to add, the file is always mapped rather than read
+  auto bufferOr = llvm::MemoryBuffer::getFile(executablePath, false, false);
   if (!bufferOr) {
     diagnostics.error("Cannot open executable: "s + executablePath);
     return {};
@@ -0,0 +1,155 @@
+#include "TestSelection.h"
+#include "MergeInstProfile.h"
+#include "mull/Config/Configuration.h"
+#include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Filters/CoverageFilter.h"
+#include "mull/Mutant.h"
+#include "mull/Parallelization/TaskExecutor.h"
+#include "mull/Runner.h"
+#include "mull/Sandbox.h"
+#include "mull/TestFramework.h"
+
+#include <llvm/Support/FileSystem.h>
+
+#include <utility>
+
+using namespace mull;
+using namespace std::string_literals;
+
+namespace {
+
+struct TestCoverage {
+  std::string test;
+  /// Becomes the mutants' CPU budget, see MutantExecutionTask
+  long long cpuTime;
+  std::vector<Mutant *> reached;
+  std::vector<std::string> executedFiles;
+};
+
+class TestCoverageTask {
+public:
+  using In = const std::vector<std::string>;
+  using Out = std::vector<TestCoverage>;
+  using iterator = In::const_iterator;
+
+  TestCoverageTask(Diagnostics &diagnostics, const Configuration &configuration,
+                   const TestFramework &framework, const std::string &testProgram,
+                   const std::vector<std::string> &extraArgs,
+                   const std::vector<std::string> &objects, const std::vector<Mutant *> &mutants)
+      : diagnostics(diagnostics), configuration(configuration), framework(framework),
+        testProgram(testProgram), extraArgs(extraArgs), objects(objects), mutants(mutants) {}
+
+  void operator()(iterator begin, iterator end, Out &storage, progress_counter &counter) {
+    Sandbox sandbox(diagnostics);
+    /// Per-test ranges would flood the output
+    Configuration quietConfiguration(configuration);
+    quietConfiguration.debug.coverage = false;
+    /// Tests already run in parallel, each loads its coverage on one thread
+    quietConfiguration.parallelization.workers = 1;
+    for (auto it = begin; it != end; ++it, counter.increment()) {
+      const std::string &test = *it;
+      llvm::SmallString<PATH_MAX> rawPath;
+      llvm::sys::fs::getPotentiallyUniqueTempFileName("mull", "test-raw-coverage", rawPath);
+      llvm::SmallString<PATH_MAX> indexedPath;
+      llvm::sys::fs::getPotentiallyUniqueTempFileName("mull", "test-indexed-coverage", indexedPath);
+
+      std::vector<std::string> arguments(extraArgs);
+      auto selection = framework.selectTestsArguments({ test });
+      arguments.insert(arguments.end(), selection.begin(), selection.end());
+      SandboxLimits limits;
+      limits.wallTime = configuration.timeout;
+      ExecutionResult result = sandbox.run(testProgram,
+                                           arguments,
+                                           { { "LLVM_PROFILE_FILE", rawPath.str().str() } },
+                                           limits,
+                                           false,
+                                           {});
+
+      std::vector<Mutant *> reached;
+      std::vector<std::string> executedFiles;
+      if (llvm::sys::fs::exists(rawPath) &&
+          mergeRawInstProfile(diagnostics, rawPath.str().str(), indexedPath.str().str())) {
+        CoverageFilter coverage(
+            quietConfiguration, diagnostics, indexedPath.str().str(), objects);
+        for (Mutant *mutant : mutants) {
+          if (coverage.covered(mutant)) {
+            reached.push_back(mutant);
+          }
+        }
+        executedFiles = coverage.getExecutedFiles();
+      } else {
+        diagnostics.debug("No coverage collected for test "s + test);
+      }
+      llvm::sys::fs::remove(rawPath);
+      llvm::sys::fs::remove(indexedPath);
+      storage.push_back({ test, result.cpuTime, std::move(reached), std::move(executedFiles) });
+    }
+  }
+
+private:
+  Diagnostics &diagnostics;
+  const Configuration &configuration;
+  const TestFramework &framework;
+  const std::string &testProgram;
+  const std::vector<std::string> &extraArgs;
+  const std::vector<std::string> &objects;
+  const std::vector<Mutant *> &mutants;
+};
+
+} // namespace
+
+std::unordered_map<std::string, std::vector<std::string>>
+mull::collectPerTestCoverage(Diagnostics &diagnostics, const Configuration &configuration,
+                             const TestFramework &framework, const std::string &testProgram,
+                             const std::vector<std::string> &extraArgs,
+                             const std::vector<std::string> &objects,
+                             std::vector<std::unique_ptr<Mutant>> &mutants) {
+  std::vector<Mutant *> coveredMutants;
+  for (auto &mutant : mutants) {
+    if (mutant->isCovered()) {
+      coveredMutants.push_back(mutant.get());
+    }
+  }
+  if (coveredMutants.empty()) {
+    return {};
+  }
+
+  std::vector<std::string> tests;
+  SingleTaskExecutor singleTask(diagnostics);
+  singleTask.execute("Listing tests", [&]() {
+    Runner runner(diagnostics);
+    std::vector<std::string> arguments(extraArgs);
+    auto listArguments = framework.listTestsArguments();
+    arguments.insert(arguments.end(), listArguments.begin(), listArguments.end());
+    ExecutionResult result = runner.runProgram(
+        testProgram, arguments, {}, configuration.timeout, true, false, std::nullopt);
+    if (result.status == Passed) {
+      tests = framework.parseTestList(result.stdoutOutput);
+    }
+  });
+  if (tests.empty()) {
+    diagnostics.warning("Could not list tests of "s + testProgram +
+                        ", every mutant will run the whole test program");
+    return {};
+  }
+
+  TestCoverageTask::Out coverage;
+  std::vector<TestCoverageTask> tasks;
+  tasks.reserve(configuration.parallelization.executionWorkers);
+  for (unsigned i = 0; i < configuration.parallelization.executionWorkers; i++) {
+    tasks.emplace_back(
+        diagnostics, configuration, framework, testProgram, extraArgs, objects, coveredMutants);
+  }
+  TaskExecutor<TestCoverageTask> executor(
+      diagnostics, "Collecting per-test coverage", tests, coverage, std::move(tasks));
+  executor.execute();
+
+  std::unordered_map<std::string, std::vector<std::string>> executedFiles;
+  for (auto &testCoverage : coverage) {
+    for (Mutant *mutant : testCoverage.reached) {
+      mutant->addCoveringTest(testCoverage.test, testCoverage.cpuTime);
+    }
+    executedFiles[testCoverage.test] = std::move(testCoverage.executedFiles);
+  }
+  return executedFiles;
+}
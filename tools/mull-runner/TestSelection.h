@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mull {
+
+class Diagnostics;
+class Mutant;
+class TestFramework;
+struct Configuration;
+
+/// Lists the tests of the test program, runs each of them separately to collect its coverage,
+/// and records on every covered mutant which tests reach it. Returns the source files each test
+/// executes.
+std::unordered_map<std::string, std::vector<std::string>>
+collectPerTestCoverage(Diagnostics &diagnostics, const Configuration &configuration,
+                       const TestFramework &framework, const std::string &testProgram,
+                       const std::vector<std::string> &extraArgs,
+                       const std::vector<std::string> &objects,
+                       std::vector<std::unique_ptr<Mutant>> &mutants);
+
+} // namespace mull
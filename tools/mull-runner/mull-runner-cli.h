@@ -17,6 +17,15 @@ AllowSurvivingEnabled_();
 MutationScoreThreshold_();
 Timeout_();
 Workers_();
+ForkServer_();
+SplitStream_();
+FailFast_();
+PreviousReport_();
+PrioritizeSurvivors_();
+Resume_();
+ResultCache_();
+CoordinatorAddress_();
+WorkerAddress_();
 NoOutput_();
 NoTestOutput_();
 NoMutantOutput_();
@@ -27,6 +36,7 @@ IDEReporterShowKilled_();
 IncludeNotCovered_();
 RunnerArgs_();
 TestProgram_();
+TestFrameworkOption_();
 LDSearchPaths_();
 CoverageInfo_();
 DebugCoverage_();
@@ -36,9 +46,19 @@ void dumpCLIInterface(mull::Diagnostics &diagnostics, std::string out) {
   Option *reporters = &(Option &)ReportersOption;
   std::vector<Option *> mullOptions({
       &(Option &)TestProgram,
+      &TestFrameworkOption,
 
       &Workers,
       &Timeout,
+      &ForkServer,
+      &SplitStream,
+      &FailFast,
+      &(Option &)PreviousReport,
+      &PrioritizeSurvivors,
+      &Resume,
+      &ResultCache,
+      &CoordinatorAddress,
+      &WorkerAddress,
 
       &ReportName,
       &ReportDirectory,
@@ -1,22 +1,34 @@
 #include "DynamicLibraries.h"
 #include "MergeInstProfile.h"
 #include "MutantExtractor.h"
+#include "TestSelection.h"
 #include "mull-runner-cli.h"
 #include "mull/Config/Configuration.h"
 #include "mull/Diagnostics/Diagnostics.h"
+#include "mull/Distributed/Coordinator.h"
+#include "mull/Distributed/Worker.h"
 #include "mull/Filters/CoverageFilter.h"
 #include "mull/Filters/Filters.h"
+#include "mull/Filters/ReachabilityFilter.h"
 #include "mull/Metrics/MetricsMeasure.h"
+#include "mull/MutantPrioritizer.h"
 #include "mull/MutantRunner.h"
 #include "mull/Parallelization/TaskExecutor.h"
+#include "mull/Reporters/SQLiteReporter.h"
+#include "mull/ResultCache.h"
 #include "mull/Result.h"
 #include "mull/Runner.h"
+#include "mull/Runtime/Runtime.h"
+#include "mull/TestFramework.h"
+#include "mull/TrivialCompilerEquivalence.h"
+#include "mull/WeakMutation.h"
 #include "mull/Version.h"
 
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/ManagedStatic.h>
 
 #include <algorithm>
+#include <csignal>
 #include <memory>
 #include <string>
 #include <unistd.h>
@@ -37,10 +49,28 @@ static std::string validateInputFile(const std::string &inputFile, mull::Diagnos
   return inputRealPath.str().str();
 }
 
+/// Whatever besides the code and the tests changes the outcome of a mutant run
+static std::string resultCacheSettings(const mull::Configuration &configuration,
+                                       const std::vector<std::string> &extraArgs) {
+  std::stringstream settings;
+  settings << mull::mullVersionString() << "\n"
+           << int(configuration.testFramework) << " " << configuration.failFast << " "
+           << configuration.timeout << "\n";
+  for (auto &marker : configuration.failFastMarkers) {
+    settings << marker << "\n";
+  }
+  for (auto &argument : extraArgs) {
+    settings << argument << "\n";
+  }
+  return settings.str();
+}
+
 int main(int argc, char **argv) {
   llvm::llvm_shutdown_obj llvmShutdownObj;
   mull::Diagnostics diagnostics;
   llvm::cl::SetVersionPrinter(mull::printVersionInformation);
+  /// A fork server dying mid-write must be reported as an error, not kill mull-runner
+  signal(SIGPIPE, SIG_IGN);
 
   tool::ReportersCLIOptions reportersOption(diagnostics, tool::ReportersOption);
 
@@ -92,6 +122,30 @@ int main(int argc, char **argv) {
     configuration.includeNotCovered = tool::IncludeNotCovered.getValue();
   }
 
+  if (tool::TestFrameworkOption.getNumOccurrences()) {
+    configuration.testFramework = tool::TestFrameworkOption.getValue();
+  }
+
+  if (tool::FailFast.getNumOccurrences()) {
+    configuration.failFast = tool::FailFast.getValue();
+  }
+
+  if (tool::PrioritizeSurvivors.getNumOccurrences()) {
+    configuration.prioritizeSurvivors = tool::PrioritizeSurvivors.getValue();
+  }
+
+  if (tool::ForkServer.getNumOccurrences()) {
+    configuration.forkServer = tool::ForkServer.getValue();
+  }
+
+  if (tool::SplitStream.getNumOccurrences()) {
+    configuration.splitStream = tool::SplitStream.getValue();
+  }
+
+  if (tool::ResultCache.getNumOccurrences()) {
+    configuration.resultCache = tool::ResultCache.getValue();
+  }
+
   configuration.executable = inputFile;
 
   if (tool::Workers.getNumOccurrences()) {
@@ -114,6 +168,15 @@ int main(int argc, char **argv) {
     configuration.captureMutantOutput = false;
   }
 
+  if (!configuration.mutantOutputDirectory.empty()) {
+    if (std::error_code error =
+            llvm::sys::fs::create_directories(configuration.mutantOutputDirectory)) {
+      diagnostics.warning("Cannot create "s + configuration.mutantOutputDirectory + ": " +
+                          error.message() + ", mutant output is not saved");
+      configuration.mutantOutputDirectory.clear();
+    }
+  }
+
   if (tool::DebugCoverage.getNumOccurrences()) {
     configuration.debug.coverage = tool::DebugCoverage.getValue();
   }
@@ -128,7 +191,8 @@ int main(int argc, char **argv) {
                                        std::make_pair("URL", mull::mullHomepageString()),
                                        std::make_pair("Mull Version", mull::mullVersionString()),
                                        std::make_pair("LLVM Version", mull::llvmVersionString()),
-                                   } };
+                                   },
+                                   .resumedReport = tool::Resume.getValue() };
   std::vector<std::unique_ptr<mull::Reporter>> reporters = reportersOption.reporters(params);
 
   std::string testProgram = configuration.executable;
@@ -150,6 +214,55 @@ int main(int argc, char **argv) {
                          mull::getDynamicLibraryDependencies(diagnostics, configuration.executable),
                          librarySearchPaths);
 
+  if (configuration.forkServer) {
+    /// The fork server replaces runs of the test program, it cannot serve a separate one
+    if (testProgram != configuration.executable) {
+      diagnostics.warning("Fork server cannot be used with a separate test program, disabling it");
+      configuration.forkServer = false;
+    } else if (std::none_of(
+                   std::begin(mutantHolders), std::end(mutantHolders), [&](auto &holder) {
+                     return mull::hasRuntimeFeature(
+                         diagnostics, holder, mull::runtime::ForkServerFeature);
+                   })) {
+      diagnostics.warning("The program was built without fork server support (forkServer: true), "
+                          "disabling it");
+      configuration.forkServer = false;
+    }
+  }
+
+  if (configuration.splitStream) {
+    if (testProgram != configuration.executable) {
+      diagnostics.warning("Split streams cannot be used with a separate test program, disabling them");
+      configuration.splitStream = false;
+    } else if (std::none_of(
+                   std::begin(mutantHolders), std::end(mutantHolders), [&](auto &holder) {
+                     return mull::hasRuntimeFeature(
+                         diagnostics, holder, mull::runtime::SplitStreamFeature);
+                   })) {
+      diagnostics.warning("The program was built without split points (splitStream: true), "
+                          "disabling split streams");
+      configuration.splitStream = false;
+    }
+  }
+
+  if (configuration.reachabilityProbes &&
+      std::none_of(std::begin(mutantHolders), std::end(mutantHolders), [&](auto &holder) {
+        return mull::hasRuntimeFeature(diagnostics, holder, mull::runtime::ReachabilityFeature);
+      })) {
+    diagnostics.warning("The program was built without reachability probes "
+                        "(reachabilityProbes: true), relying on coverage");
+    configuration.reachabilityProbes = false;
+  }
+
+  if (configuration.weakMutation &&
+      std::none_of(std::begin(mutantHolders), std::end(mutantHolders), [&](auto &holder) {
+        return mull::hasRuntimeFeature(diagnostics, holder, mull::runtime::WeakMutationFeature);
+      })) {
+    diagnostics.warning("The program was built without weak mutation probes "
+                        "(weakMutation: true), running every mutant");
+    configuration.weakMutation = false;
+  }
+
   mull::Filters filters(configuration, diagnostics);
   filters.enableGitDiffFilter();
   filters.enableFilePathFilter();
@@ -178,6 +291,20 @@ int main(int argc, char **argv) {
 
     env["LLVM_PROFILE_FILE"] = rawCoverageData;
   }
+  std::string reachabilityData;
+  if (configuration.reachabilityProbes) {
+    llvm::SmallString<PATH_MAX> reachabilityPath;
+    llvm::sys::fs::getPotentiallyUniqueTempFileName("mull", "reachability", reachabilityPath);
+    reachabilityData = reachabilityPath.str().str();
+    env[mull::runtime::ReachabilityEnvironmentVariable] = reachabilityData;
+  }
+  std::string weakMutationData;
+  if (configuration.weakMutation) {
+    llvm::SmallString<PATH_MAX> weakMutationPath;
+    llvm::sys::fs::getPotentiallyUniqueTempFileName("mull", "weak-mutation", weakMutationPath);
+    weakMutationData = weakMutationPath.str().str();
+    env[mull::runtime::WeakMutationEnvironmentVariable] = weakMutationData;
+  }
   mull::Runner runner(diagnostics);
   mull::SingleTaskExecutor singleTask(diagnostics);
   /// On macOS, sometimes newly compiled programs take more time to execute for the first run
@@ -204,9 +331,23 @@ int main(int argc, char **argv) {
     });
   }
 
+  mull::WeakMutationReport weakMutationReport;
+  if (!weakMutationData.empty()) {
+    weakMutationReport = mull::readWeakMutationReport(diagnostics, weakMutationData);
+    llvm::sys::fs::remove(weakMutationData);
+  }
+
   auto coverage = filters.enableCoverageFilter(coverageInfo, mutantHolders);
+  mull::ReachabilityFilter *reachability = nullptr;
+  if (!reachabilityData.empty()) {
+    reachability = filters.enableReachabilityFilter(reachabilityData);
+    llvm::sys::fs::remove(reachabilityData);
+  }
   for (auto &mutant : mutants) {
-    if (coverage->covered(mutant.get())) {
+    /// The probes know about the mutated instruction itself, not only about its source region
+    bool covered = reachability ? reachability->reached(mutant.get())
+                                : coverage->covered(mutant.get());
+    if (covered) {
       mutant->setCovered(true);
     }
   }
@@ -231,9 +372,132 @@ int main(int argc, char **argv) {
     }
   });
 
+  std::unordered_map<std::string, std::vector<std::string>> testFiles;
+  mull::TestFramework testFramework(configuration.testFramework);
+  if (testFramework.supportsTestSelection()) {
+    if (mull::hasCoverage(diagnostics, configuration.executable)) {
+      testFiles = mull::collectPerTestCoverage(diagnostics,
+                                   configuration,
+                                   testFramework,
+                                   testProgram,
+                                   extraArgs,
+                                   mutantHolders,
+                                   filteredMutants);
+    } else {
+      diagnostics.warning("Test selection requires a program built with coverage instrumentation "
+                          "(-fprofile-instr-generate -fcoverage-mapping)");
+    }
+  }
+
   mull::MutantRunner mutantRunner(diagnostics, configuration, runner);
-  std::vector<std::unique_ptr<mull::MutationResult>> mutationResults =
-      mutantRunner.runMutants(testProgram, extraArgs, filteredMutants);
+  std::unordered_map<std::string, long long> durations;
+  mull::MutantPrioritizer prioritizer;
+  for (auto &previousReport : tool::PreviousReport) {
+    if (!llvm::sys::fs::exists(previousReport)) {
+      diagnostics.warning("Previous report does not exist: "s + previousReport);
+      continue;
+    }
+    auto report = mull::SQLiteReporter::loadRawReport(previousReport);
+    for (auto &[identifier, results] : report.executionResults) {
+      for (auto &result : results) {
+        durations[identifier] = std::max(durations[identifier], result.runningTime);
+        prioritizer.addResult(identifier, report.mutators[identifier], result.status);
+      }
+    }
+  }
+  mutantRunner.setPreviousDurations(std::move(durations));
+  if (configuration.prioritizeSurvivors) {
+    if (prioritizer.empty()) {
+      diagnostics.warning("prioritizeSurvivors requires results of previous runs (-previous-report)");
+    } else {
+      mutantRunner.setPrioritizer(&prioritizer);
+    }
+  }
+  if (!tool::WorkerAddress.getValue().empty()) {
+    /// Results are reported by the coordinator
+    unsigned batchSize = configuration.parallelization.executionWorkers * 4;
+    mull::Worker worker(diagnostics, tool::WorkerAddress.getValue(), batchSize);
+    return worker.run(mutantRunner, testProgram, extraArgs, filteredMutants) ? 0 : 1;
+  }
+  /// Reporters persisting results get them as they come, an interrupted run can be resumed
+  mull::MutationResultListener reportResult = [&](const mull::Mutant &mutant,
+                                                  const mull::ExecutionResult &result) {
+    for (auto &reporter : reporters) {
+      reporter->reportResult(mutant, result);
+    }
+  };
+  mutantRunner.setResultListener(reportResult);
+  mull::RunMutants runMutants = [&](std::vector<std::unique_ptr<mull::Mutant>> &mutants) {
+    if (!tool::CoordinatorAddress.getValue().empty()) {
+      mull::Coordinator coordinator(diagnostics, tool::CoordinatorAddress.getValue());
+      coordinator.setResultListener(reportResult);
+      if (configuration.prioritizeSurvivors && !prioritizer.empty()) {
+        coordinator.setPrioritizer(&prioritizer);
+      }
+      return coordinator.run(mutants);
+    }
+    return mutantRunner.runMutants(testProgram, extraArgs, mutants);
+  };
+  mull::Equivalences equivalences = mutantExtractor.extractEquivalences(mutantHolders);
+  if (!equivalences.empty()) {
+    runMutants = [&, runAll = std::move(runMutants)](
+                     std::vector<std::unique_ptr<mull::Mutant>> &mutants) {
+      return mull::runDistinct(mutants, equivalences, runAll);
+    };
+  }
+  if (!weakMutationReport.evaluated.empty()) {
+    runMutants = [&, runAll = std::move(runMutants)](
+                     std::vector<std::unique_ptr<mull::Mutant>> &mutants) {
+      size_t notInfected = std::count_if(mutants.begin(), mutants.end(), [&](auto &mutant) {
+        return weakMutationReport.notInfected(mutant->getIdentifier());
+      });
+      diagnostics.info("Weak mutation: "s + std::to_string(notInfected) + " of " +
+                       std::to_string(mutants.size()) +
+                       " mutants never changed a value, reporting them as survivors");
+      return mull::runInfected(mutants, weakMutationReport, runAll);
+    };
+  }
+  if (!tool::Resume.getValue().empty()) {
+    if (!llvm::sys::fs::exists(tool::Resume.getValue())) {
+      diagnostics.error("Report to resume does not exist: "s + tool::Resume.getValue());
+    }
+    if (std::none_of(std::begin(tool::ReportersOption),
+                     std::end(tool::ReportersOption),
+                     [](mull::ReporterKind kind) { return kind == mull::ReporterKind::SQLite; })) {
+      diagnostics.warning("Results of the resumed run are only saved with -reporters=SQLite");
+    }
+    auto report = mull::SQLiteReporter::loadRawReport(tool::Resume.getValue());
+    diagnostics.info("Resuming "s + tool::Resume.getValue() + ": " +
+                     std::to_string(report.executionResults.size()) + " mutants have results");
+    runMutants = [&, runAll = std::move(runMutants), report = std::move(report)](
+                     std::vector<std::unique_ptr<mull::Mutant>> &mutants) {
+      auto known = [&](const mull::Mutant &mutant) -> std::optional<mull::ExecutionResult> {
+        auto found = report.executionResults.find(mutant.getIdentifier());
+        if (found == report.executionResults.end() || found->second.empty()) {
+          return std::nullopt;
+        }
+        return found->second.back();
+      };
+      return mull::runRemaining(mutants, known, runAll);
+    };
+  }
+  std::vector<std::unique_ptr<mull::MutationResult>> mutationResults;
+  if (!configuration.resultCache.empty()) {
+    mull::ResultCache resultCache(
+        diagnostics, configuration.resultCache, resultCacheSettings(configuration, extraArgs));
+    if (!coverage->getExecutedFiles().empty()) {
+      resultCache.setProgramFiles(coverage->getExecutedFiles());
+    } else {
+      /// Without coverage, any change to the program invalidates every result
+      std::vector<std::string> binaries(mutantHolders);
+      binaries.push_back(testProgram);
+      resultCache.setProgramFiles(std::move(binaries));
+    }
+    resultCache.setTestFiles(std::move(testFiles));
+    mutationResults = resultCache.run(filteredMutants, runMutants);
+  } else {
+    mutationResults = runMutants(filteredMutants);
+  }
 
   // Count surviving mutants, for later
   std::size_t surviving = std::count_if(
@@ -242,21 +506,7 @@ int main(int argc, char **argv) {
       });
 
   // Calculate mutation score for later threshold comparison
-  int killedMutantsCount = 0;
-  int totalMutantsCount = 0;
-
-  for (auto &mutationResult : mutationResults) {
-    auto &executionResult = mutationResult->getExecutionResult();
-
-    totalMutantsCount++;
-    if ((executionResult.status != mull::ExecutionStatus::NotCovered) &&
-        (executionResult.status != mull::ExecutionStatus::Passed)) {
-      killedMutantsCount++;
-    }
-  }
-
-  auto rawScore = double(killedMutantsCount) / double(totalMutantsCount);
-  auto score = int(rawScore * 100);
+  int score = mull::mutationScore(mutationResults);
 
   auto result =
       std::make_unique<mull::Result>(std::move(filteredMutants), std::move(mutationResults));